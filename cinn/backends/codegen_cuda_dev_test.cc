@@ -2972,7 +2972,7 @@ TEST(Cudnn, external_function_cudnn3) {
   dev_bufs[0]->memory = reinterpret_cast<uint8_t*>(A_dev);
   dev_bufs[1]->memory = reinterpret_cast<uint8_t*>(B_dev);
 
-  runtime::cuda::cinn_gpu_cudnn_softmax({2, 1000, -1}, dev_bufs[0], dev_bufs[1]);
+  runtime::cuda::cinn_gpu_cudnn_softmax({2, 1000, -1, 0}, dev_bufs[0], dev_bufs[1]);
 }
 #endif
 }  // namespace backends
@@ -15,6 +15,8 @@
 #include "cinn/backends/compiler.h"
 
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/loop_strength_reduce.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
@@ -110,7 +112,12 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code,
 #endif
 }
 
-void Compiler::CompileX86Module(const Module& module) { engine_->Link<CodeGenX86>(module); }
+void Compiler::CompileX86Module(const Module& module) {
+  // the div/mod of the loop variables are reduced for the JIT only, the C source of the module keeps them
+  auto copied = optim::IRCopy(Expr(module));
+  optim::LoopStrengthReduce(&copied);
+  engine_->Link<CodeGenX86>(copied.as_module_ref());
+}
 
 void Compiler::ExportObject(const std::string& path) { engine_->ExportObject(path); }
 
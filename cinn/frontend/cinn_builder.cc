@@ -223,6 +223,14 @@ std::vector<Variable> CinnBuilder::BnMeanVarianceReduce(const Variable& x) {
   return instr.GetOutputs();
 }
 
+std::vector<Variable> CinnBuilder::BnMeanVarianceWelford(const Variable& x, const std::string& data_layout) {
+  Instruction instr("bn_mean_variance_welford", {x});
+  instr.SetAttr("data_layout", data_layout);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
 std::vector<Variable> CinnBuilder::BnGradBiasScaleReduce(const Variable& x,
                                                          const Variable& x_mean,
                                                          const Variable& y_grad) {
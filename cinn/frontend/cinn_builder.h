@@ -181,6 +181,8 @@ class CinnBuilder : public BaseBuilder {
 
   std::vector<Variable> BnMeanVarianceReduce(const Variable& x);
 
+  std::vector<Variable> BnMeanVarianceWelford(const Variable& x, const std::string& data_layout = "NCHW");
+
   std::vector<Variable> BnGradBiasScaleReduce(const Variable& x, const Variable& x_mean, const Variable& y_grad);
 
  private:
@@ -53,16 +53,34 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
     ProgramPass::Apply(&program, target, {"Decomposer"});
   }
   ctx->graph.reset(new hlir::framework::Graph(program, target));
+  // the passes keep the fetched variables
+  for (auto &out : outputs) {
+    auto *fetch_node = ctx->graph->RetrieveNode(out->id);
+    if (fetch_node) ctx->graph->outputs.push_back(fetch_node->safe_as<hlir::framework::NodeData>());
+  }
 
   if (ctx->compile_options.use_default_passes) {
     hlir::framework::ApplyPass(ctx->graph.get(), "InferShape");
+    hlir::framework::ApplyPass(ctx->graph.get(), "FoldBatchNorm");
 
 #ifndef CINN_WITH_CUDA
     if (target.arch == Target::Arch::X86) {
+      hlir::framework::ApplyPass(ctx->graph.get(), "FoldSoftmaxScale");
       hlir::framework::ApplyPass(ctx->graph.get(), "AlterLayout");
     }
 #endif
+    hlir::framework::ApplyPass(ctx->graph.get(), "LayoutFolding");
     hlir::framework::ApplyPass(ctx->graph.get(), "ConstPropagate");
+#ifdef CINN_WITH_MKL_CBLAS
+    if (target.arch == Target::Arch::X86) {
+      hlir::framework::ApplyPass(ctx->graph.get(), "PackGemmWeights");
+    }
+#endif
+#ifdef CINN_WITH_MKLDNN
+    if (target.arch == Target::Arch::X86) {
+      hlir::framework::ApplyPass(ctx->graph.get(), "ReorderConvWeights");
+    }
+#endif
     hlir::framework::ApplyPass(ctx->graph.get(), "OpFusion");
   }
   for (auto &pass_name : ctx->compile_options.passes) {
@@ -46,6 +46,7 @@ struct BatchNormHelper {
 
     num_instructions = builder->size();
     op_type          = bn_op_type;
+    layout           = data_layout;
   }
 
   ~BatchNormHelper() {
@@ -72,10 +73,11 @@ struct BatchNormHelper {
 
     auto variance = builder->Sub(mean_squre, builder->Mul(mean, builder->Identity(mean)));
 #else
-    // mean = reduce_sum(x) / nhw, shape = [c]
-    auto mean = Mean(x);
-    // variance = reduce_sum(x * x) / nhw - mean * mean, shape = [c], simplified by equation: E(x^2) - [E(x)]^2
-    auto variance    = Variance(x, mean);
+    // The mean and variance are computed by Welford's algorithm in one pass over x on CPU, which is numerically
+    // stable, instead of two reductions of x and x * x. The normalization after it is fused into another pass.
+    auto vars     = builder->BnMeanVarianceWelford(x, layout);
+    auto mean     = vars[0];
+    auto variance = vars[1];
 #endif
     return {mean, variance};
   }
@@ -97,24 +99,6 @@ struct BatchNormHelper {
 #endif
   }
 
-  // mean = reduce_sum(x) / nhw
-  Variable Mean(Variable x) {
-    auto element_count_1d = GetTensorFromScalar<float>(element_count, "element_count", param_shape);
-    auto sum              = Reduce(x);
-    auto mean             = builder->Div(sum, element_count_1d);
-    return mean;
-  }
-
-  // variance = reduce_sum(x * x) / nhw - mean * mean
-  Variable Variance(Variable x, Variable mean) {
-    auto element_count_1d = GetTensorFromScalar<float>(element_count, "element_count", param_shape);
-    auto x_square         = builder->Mul(x, builder->Identity(x));
-    auto x_square_sum     = Reduce(x_square);
-    auto x_square_mean    = builder->Div(x_square_sum, element_count_1d);
-    auto variance         = builder->Sub(x_square_mean, builder->Mul(mean, builder->Identity(mean)));
-    return variance;
-  }
-
   // std_variance_inv = rsqrt(variance + epsilon)
   Variable StdVarianceInv1d(Variable variance, float epsilon) {
     auto epsilon_1d       = GetTensorFromScalar<float>(epsilon, "epsilon", param_shape);
@@ -154,6 +138,7 @@ struct BatchNormHelper {
   float element_count{0};
   int channel_dim{0};
   std::string op_type;
+  std::string layout;
   int num_instructions{0};
 };
 
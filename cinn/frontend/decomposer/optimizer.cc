@@ -0,0 +1,154 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/decomposer_registry.h"
+#include "cinn/frontend/syntax.h"
+
+namespace cinn {
+namespace frontend {
+namespace decomposer {
+
+// The optimizers are decomposed into the elementwise operators on the shape of the parameter, which are fused into
+// one kernel by OpFusion, and the scalar operators on the learning rate and the powers of betas.
+struct OptimizerHelper {
+  OptimizerHelper(CinnBuilder* cinn_builder, const std::vector<int>& arg_param_shape) {
+    builder     = cinn_builder;
+    param_shape = arg_param_shape;
+  }
+
+  Variable Scalar(float value, const std::string& name) {
+    return builder->ConstScalar<float>(value, common::UniqName(name));
+  }
+
+  // broadcast a tensor of shape [1] to the shape of the parameter
+  Variable Broadcast(const Variable& scalar) { return builder->BroadcastTo(scalar, param_shape, {0}); }
+
+  Variable GetTensorFromScalar(float value, const std::string& name) { return Broadcast(Scalar(value, name)); }
+
+  CinnBuilder* builder{nullptr};
+  std::vector<int> param_shape;
+};
+
+void sgd(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 3UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 1UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  auto& param         = instr->inputs[0];
+  auto& grad          = instr->inputs[1];
+  auto& learning_rate = instr->inputs[2];
+
+  CinnBuilder* builder = context.builder();
+  OptimizerHelper helper(builder, param->shape);
+
+  // param_out = param - learning_rate * grad
+  auto param_out = builder->Sub(param, builder->Mul(grad, helper.Broadcast(learning_rate)));
+
+  context.MapOutToOrigin(param_out, instr->outputs[0]);
+}
+
+void momentum(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 4UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 2UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  auto& param         = instr->inputs[0];
+  auto& grad          = instr->inputs[1];
+  auto& velocity      = instr->inputs[2];
+  auto& learning_rate = instr->inputs[3];
+
+  float mu          = instr.GetAttrs<float>("mu");
+  bool use_nesterov = instr.GetAttrs<bool>("use_nesterov");
+
+  CinnBuilder* builder = context.builder();
+  OptimizerHelper helper(builder, param->shape);
+
+  // velocity_out = mu * velocity + grad
+  auto velocity_out = builder->Add(builder->Mul(velocity, helper.GetTensorFromScalar(mu, "mu")), grad);
+  auto lr           = helper.Broadcast(learning_rate);
+  Variable param_out;
+  if (use_nesterov) {
+    // param_out = param - (grad + mu * velocity_out) * learning_rate
+    auto update = builder->Add(grad, builder->Mul(velocity_out, helper.GetTensorFromScalar(mu, "mu")));
+    param_out   = builder->Sub(param, builder->Mul(update, lr));
+  } else {
+    // param_out = param - learning_rate * velocity_out
+    param_out = builder->Sub(param, builder->Mul(velocity_out, lr));
+  }
+
+  context.MapOutToOrigin(param_out, instr->outputs[0]);
+  context.MapOutToOrigin(velocity_out, instr->outputs[1]);
+}
+
+void adam(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 7UL) << "The number of the given inputs is not equal to the required for op "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 5UL) << "The number of the given outputs is not equal to the required for op "
+                                       << instr->op_type;
+  auto& param         = instr->inputs[0];
+  auto& grad          = instr->inputs[1];
+  auto& learning_rate = instr->inputs[2];
+  auto& moment1       = instr->inputs[3];
+  auto& moment2       = instr->inputs[4];
+  auto& beta1_pow     = instr->inputs[5];
+  auto& beta2_pow     = instr->inputs[6];
+
+  float beta1   = instr.GetAttrs<float>("beta1");
+  float beta2   = instr.GetAttrs<float>("beta2");
+  float epsilon = instr.GetAttrs<float>("epsilon");
+
+  CinnBuilder* builder = context.builder();
+  OptimizerHelper helper(builder, param->shape);
+
+  // moment1_out = beta1 * moment1 + (1 - beta1) * grad
+  auto moment1_out = builder->Add(builder->Mul(moment1, helper.GetTensorFromScalar(beta1, "beta1")),
+                                  builder->Mul(grad, helper.GetTensorFromScalar(1.f - beta1, "one_minus_beta1")));
+  // moment2_out = beta2 * moment2 + ((1 - beta2) * grad) * grad, an op can't take the same variable twice, so the
+  // coefficient is applied before squaring instead of squaring by a copy of grad
+  auto scaled_grad = builder->Mul(grad, helper.GetTensorFromScalar(1.f - beta2, "one_minus_beta2"));
+  auto moment2_out = builder->Add(builder->Mul(moment2, helper.GetTensorFromScalar(beta2, "beta2")),
+                                  builder->Mul(scaled_grad, grad));
+
+  // the bias corrections are computed on the scalars, shape = [1]
+  // lr_t = learning_rate * sqrt(1 - beta2_pow) / (1 - beta1_pow), epsilon_t = epsilon * sqrt(1 - beta2_pow)
+  auto sqrt_bias_correction2 = builder->Sqrt(builder->Sub(helper.Scalar(1.f, "one"), beta2_pow));
+  auto bias_correction1      = builder->Sub(helper.Scalar(1.f, "one"), beta1_pow);
+  auto lr_t                  = builder->Div(builder->Mul(learning_rate, sqrt_bias_correction2), bias_correction1);
+  auto epsilon_t             = builder->Mul(helper.Scalar(epsilon, "epsilon"), sqrt_bias_correction2);
+
+  // param_out = param - lr_t * moment1_out / (sqrt(moment2_out) + epsilon_t)
+  auto denominator = builder->Add(builder->Sqrt(moment2_out), helper.Broadcast(epsilon_t));
+  auto param_out   = builder->Sub(param, builder->Mul(helper.Broadcast(lr_t), builder->Div(moment1_out, denominator)));
+
+  auto beta1_pow_out = builder->Mul(beta1_pow, helper.Scalar(beta1, "beta1"));
+  auto beta2_pow_out = builder->Mul(beta2_pow, helper.Scalar(beta2, "beta2"));
+
+  context.MapOutToOrigin(param_out, instr->outputs[0]);
+  context.MapOutToOrigin(moment1_out, instr->outputs[1]);
+  context.MapOutToOrigin(moment2_out, instr->outputs[2]);
+  context.MapOutToOrigin(beta1_pow_out, instr->outputs[3]);
+  context.MapOutToOrigin(beta2_pow_out, instr->outputs[4]);
+}
+
+}  // namespace decomposer
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(optimizer_decomposers) {
+  CINN_DECOMPOSER_REGISTER(sgd, cinn::frontend::decomposer::sgd);
+  CINN_DECOMPOSER_REGISTER(momentum, cinn::frontend::decomposer::momentum);
+  CINN_DECOMPOSER_REGISTER(adam, cinn::frontend::decomposer::adam);
+
+  return true;
+}
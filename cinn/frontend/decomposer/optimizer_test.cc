@@ -0,0 +1,125 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn::frontend {
+
+TEST(Decomposer, sgd) {
+  NetBuilder builder("sgd");
+  auto param     = builder.CreateInput(Float(32), {4096}, "param");
+  auto grad      = builder.CreateInput(Float(32), {4096}, "grad");
+  auto lr        = builder.CreateInput(Float(32), {1}, "lr");
+  auto param_out = builder.sgd(param, grad, lr);
+
+  auto sgd_cpu = [](const std::vector<size_t>& lengths, const std::vector<void*>& ptrs) {
+    size_t n         = lengths[0];
+    float* param     = static_cast<float*>(ptrs[0]);
+    float* grad      = static_cast<float*>(ptrs[1]);
+    float* lr        = static_cast<float*>(ptrs[2]);
+    float* param_out = static_cast<float*>(ptrs[3]);
+    for (size_t i = 0; i < n; ++i) {
+      param_out[i] = param[i] - lr[0] * grad[i];
+    }
+  };
+
+  std::vector<std::string> input_names        = {param.id().data(), grad.id().data(), lr.id().data()};
+  std::vector<std::string> output_names       = {param_out->id};
+  std::vector<std::vector<int>> output_shapes = {{4096}};
+  RunAndCheck<float>(builder, input_names, output_names, output_shapes, sgd_cpu);
+}
+
+TEST(Decomposer, momentum_nesterov) {
+  NetBuilder builder("momentum");
+  auto param    = builder.CreateInput(Float(32), {4096}, "param");
+  auto grad     = builder.CreateInput(Float(32), {4096}, "grad");
+  auto velocity = builder.CreateInput(Float(32), {4096}, "velocity");
+  auto lr       = builder.CreateInput(Float(32), {1}, "lr");
+  auto outs     = builder.momentum(param, grad, velocity, lr, 0.9f, true);
+
+  auto momentum_cpu = [](const std::vector<size_t>& lengths, const std::vector<void*>& ptrs) {
+    size_t n            = lengths[0];
+    float* param        = static_cast<float*>(ptrs[0]);
+    float* grad         = static_cast<float*>(ptrs[1]);
+    float* velocity     = static_cast<float*>(ptrs[2]);
+    float* lr           = static_cast<float*>(ptrs[3]);
+    float* param_out    = static_cast<float*>(ptrs[4]);
+    float* velocity_out = static_cast<float*>(ptrs[5]);
+    for (size_t i = 0; i < n; ++i) {
+      velocity_out[i] = 0.9f * velocity[i] + grad[i];
+      param_out[i]    = param[i] - (grad[i] + 0.9f * velocity_out[i]) * lr[0];
+    }
+  };
+
+  std::vector<std::string> input_names  = {param.id().data(), grad.id().data(), velocity.id().data(), lr.id().data()};
+  std::vector<std::string> output_names = {outs[0]->id, outs[1]->id};
+  std::vector<std::vector<int>> output_shapes = {{4096}, {4096}};
+  RunAndCheck<float>(builder, input_names, output_names, output_shapes, momentum_cpu);
+}
+
+TEST(Decomposer, adam) {
+  NetBuilder builder("adam");
+  auto param     = builder.CreateInput(Float(32), {4096}, "param");
+  auto grad      = builder.CreateInput(Float(32), {4096}, "grad");
+  auto lr        = builder.CreateInput(Float(32), {1}, "lr");
+  auto moment1   = builder.CreateInput(Float(32), {4096}, "moment1");
+  auto moment2   = builder.CreateInput(Float(32), {4096}, "moment2");
+  auto beta1_pow = builder.CreateInput(Float(32), {1}, "beta1_pow");
+  auto beta2_pow = builder.CreateInput(Float(32), {1}, "beta2_pow");
+  auto outs      = builder.adam(param, grad, lr, moment1, moment2, beta1_pow, beta2_pow, 0.9f, 0.999f, 1e-8f);
+
+  auto adam_cpu = [](const std::vector<size_t>& lengths, const std::vector<void*>& ptrs) {
+    size_t n             = lengths[0];
+    float* param         = static_cast<float*>(ptrs[0]);
+    float* grad          = static_cast<float*>(ptrs[1]);
+    float* lr            = static_cast<float*>(ptrs[2]);
+    float* moment1       = static_cast<float*>(ptrs[3]);
+    float* moment2       = static_cast<float*>(ptrs[4]);
+    float* beta1_pow     = static_cast<float*>(ptrs[5]);
+    float* beta2_pow     = static_cast<float*>(ptrs[6]);
+    float* param_out     = static_cast<float*>(ptrs[7]);
+    float* moment1_out   = static_cast<float*>(ptrs[8]);
+    float* moment2_out   = static_cast<float*>(ptrs[9]);
+    float* beta1_pow_out = static_cast<float*>(ptrs[10]);
+    float* beta2_pow_out = static_cast<float*>(ptrs[11]);
+
+    float lr_t      = lr[0] * std::sqrt(1.f - beta2_pow[0]) / (1.f - beta1_pow[0]);
+    float epsilon_t = 1e-8f * std::sqrt(1.f - beta2_pow[0]);
+    for (size_t i = 0; i < n; ++i) {
+      moment1_out[i] = 0.9f * moment1[i] + 0.1f * grad[i];
+      moment2_out[i] = 0.999f * moment2[i] + 0.001f * grad[i] * grad[i];
+      param_out[i]   = param[i] - lr_t * moment1_out[i] / (std::sqrt(moment2_out[i]) + epsilon_t);
+    }
+    beta1_pow_out[0] = beta1_pow[0] * 0.9f;
+    beta2_pow_out[0] = beta2_pow[0] * 0.999f;
+  };
+
+  std::vector<std::string> input_names = {param.id().data(),
+                                          grad.id().data(),
+                                          lr.id().data(),
+                                          moment1.id().data(),
+                                          moment2.id().data(),
+                                          beta1_pow.id().data(),
+                                          beta2_pow.id().data()};
+  std::vector<std::string> output_names;
+  for (auto& out : outs) {
+    output_names.push_back(out->id);
+  }
+  std::vector<std::vector<int>> output_shapes = {{4096}, {4096}, {4096}, {1}, {1}};
+  RunAndCheck<float>(builder, input_names, output_names, output_shapes, adam_cpu, 0.f, 1.f, 1e-6f, 1e-4f);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,41 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/fallback_kernel_registry.h"
+
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace frontend {
+
+hlir::framework::Tensor FallbackContext::GetTensor(const std::string& name) const {
+  return scope_->GetTensor(cinn::utils::TransValidVarName(name));
+}
+
+hlir::framework::Tensor FallbackContext::DeclareTensor(const std::string& name,
+                                                       const std::vector<int>& shape,
+                                                       const common::Type& type) const {
+  for (int dim : shape) {
+    CHECK_GT(dim, 0) << "The shape of the fallback output [" << name << "] should be known, but received ["
+                     << cinn::utils::Join(shape, ", ") << "]";
+  }
+  auto* var    = scope_->Var<hlir::framework::Tensor>(cinn::utils::TransValidVarName(name));
+  auto& tensor = absl::get<hlir::framework::Tensor>(*var);
+  tensor->Resize(hlir::framework::Shape(shape));
+  tensor->set_type(type);
+  return tensor;
+}
+
+}  // namespace frontend
+}  // namespace cinn
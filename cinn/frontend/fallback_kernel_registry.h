@@ -0,0 +1,103 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/common/type.h"
+#include "cinn/frontend/paddle/cpp/op_desc.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/utils/registry.h"
+
+namespace cinn {
+namespace frontend {
+
+// The tensors of the model seen by the fallback kernels. A tensor is found by its name in the Paddle model, it is the
+// same tensor read or written by the CINN programs before and after the fallback op, so it is handed without copy.
+class FallbackContext {
+ public:
+  FallbackContext(hlir::framework::Scope* scope, const common::Target& target) : scope_(scope), target_(target) {
+    CHECK_NOTNULL(scope_);
+  }
+
+  const common::Target& Target() const { return target_; }
+
+  // get the tensor of the variable in the model
+  hlir::framework::Tensor GetTensor(const std::string& name) const;
+
+  // declare the tensor of the output variable with its shape and dtype, the buffer is not allocated
+  hlir::framework::Tensor DeclareTensor(const std::string& name,
+                                        const std::vector<int>& shape,
+                                        const common::Type& type) const;
+
+ private:
+  hlir::framework::Scope* scope_{nullptr};
+  const common::Target& target_;
+};
+
+/**
+ * The host kernel of an op without OpMapper. The model is partitioned around the op, and the kernel is called
+ * between the CINN programs with the OpDesc in the model. The infer shape function declares the outputs, it is
+ * called when the model is converted, so the ops after it are mapped with the shapes of its outputs. Without the
+ * infer shape function the outputs are declared with the shapes in their var descs.
+ */
+class FallbackKernel {
+ public:
+  using KernelFunc = std::function<void(const paddle::cpp::OpDesc&, const FallbackContext&)>;
+
+  FallbackKernel& Set(const KernelFunc& kernel) {
+    kernel_ = kernel;
+    return *this;
+  }
+
+  FallbackKernel& SetInferShape(const KernelFunc& infer_shape) {
+    infer_shape_ = infer_shape;
+    return *this;
+  }
+
+  bool HasInferShape() const { return static_cast<bool>(infer_shape_); }
+
+  void InferShape(const paddle::cpp::OpDesc& op_desc, const FallbackContext& ctx) const { infer_shape_(op_desc, ctx); }
+
+  void Run(const paddle::cpp::OpDesc& op_desc, const FallbackContext& ctx) const { kernel_(op_desc, ctx); }
+
+  std::string name;
+
+ private:
+  KernelFunc kernel_;
+  KernelFunc infer_shape_;
+};
+
+class FallbackKernelRegistry : public Registry<FallbackKernel> {
+ public:
+  FallbackKernelRegistry() = default;
+
+ private:
+  CINN_DISALLOW_COPY_AND_ASSIGN(FallbackKernelRegistry);
+};
+
+#define UNIQUE_FALLBACK_KERNEL_NAME(OpName) \
+  static ::cinn::frontend::FallbackKernel& __fallback_kernel_registrar_##OpName
+
+#define CINN_REGISTER_FALLBACK_KERNEL(OpName, Kernel)                \
+  CINN_STR_CONCAT(UNIQUE_FALLBACK_KERNEL_NAME(OpName), __COUNTER__) = \
+      ::cinn::frontend::FallbackKernelRegistry::Global()->__REGISTER_OR_GET__(#OpName).Set(Kernel)
+
+}  // namespace frontend
+}  // namespace cinn
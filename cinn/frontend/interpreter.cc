@@ -108,23 +108,39 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
   auto graph                 = std::make_shared<hlir::framework::Graph>(*program_, target);
   graph->attrs["model_name"] = std::make_shared<absl::any>(model_name);
 
+  std::unordered_set<std::string> fetch_var_ids;
+  for (auto& name : fetch_names_) {
+    CHECK(var_map_.count(name)) << "var_map finds no fetch var " << name;
+    fetch_var_ids.insert(var_map_.at(name)->id);
+    // the passes keep the fetched variables
+    auto* fetch_node = graph->RetrieveNode(var_map_.at(name)->id);
+    if (fetch_node) graph->outputs.push_back(fetch_node->safe_as<hlir::framework::NodeData>());
+  }
+
   hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "FoldBatchNorm");
 #ifndef CINN_WITH_CUDA
   if (target.arch == Target::Arch::X86) {
+    hlir::framework::ApplyPass(graph.get(), "FoldSoftmaxScale");
     hlir::framework::ApplyPass(graph.get(), "AlterLayout");
   }
 #endif
+  hlir::framework::ApplyPass(graph.get(), "LayoutFolding");
   hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+#ifdef CINN_WITH_MKL_CBLAS
+  if (target.arch == Target::Arch::X86) {
+    hlir::framework::ApplyPass(graph.get(), "PackGemmWeights");
+  }
+#endif
+#ifdef CINN_WITH_MKLDNN
+  if (target.arch == Target::Arch::X86) {
+    hlir::framework::ApplyPass(graph.get(), "ReorderConvWeights");
+  }
+#endif
   hlir::framework::ApplyPass(graph.get(), "OpFusion");
   // Target target = common::DefaultHostTarget();
   scope_ = hlir::framework::BuildScope(target, graph, scope_);
 
-  std::unordered_set<std::string> fetch_var_ids;
-  for (auto& name : fetch_names_) {
-    CHECK(var_map_.count(name)) << "var_map finds no fetch var " << name;
-    fetch_var_ids.insert(var_map_.at(name)->id);
-  }
-
   graph_compiler_.reset(new hlir::framework::GraphCompiler(target, scope_, graph));
   hlir::framework::GraphCompiler::CompileOptions options;
   options.with_instantiate_variables = true;
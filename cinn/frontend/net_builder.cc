@@ -63,6 +63,16 @@ Variable NetBuilder::mul(const Variable& a, const Variable& b, int x_num_col_dim
   return instr.GetOutput(0);
 }
 
+Variable NetBuilder::matmul(const Variable& a, const Variable& b, bool trans_a, bool trans_b, float alpha) {
+  Instruction instr("matmul", {a, b});
+  instr.SetAttr("trans_a", trans_a);
+  instr.SetAttr("trans_b", trans_b);
+  instr.SetAttr("alpha", alpha);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::mulbias(
     const Variable& a, const Variable& b, const Variable& c, int x_num_col_dims, int y_num_col_dims) {
   Instruction instr("mulbias", {a, b, c});
@@ -269,6 +279,16 @@ Variable NetBuilder::softmax(const Variable& a, int axis, const std::string& dat
   return instr.GetOutput(0);
 }
 
+Variable NetBuilder::log_softmax(const Variable& a, int axis, const std::string& data_format) {
+  Instruction instr("softmax", {a});
+  instr.SetAttr("axis", axis);
+  instr.SetAttr("data_format", data_format);
+  instr.SetAttr("use_log", true);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::sigmoid(const Variable& a) {
   Instruction instr("sigmoid", {a});
   InferShape(instr);
@@ -276,6 +296,48 @@ Variable NetBuilder::sigmoid(const Variable& a) {
   return instr.GetOutput(0);
 }
 
+Variable NetBuilder::gelu(const Variable& a, bool approximate) {
+  Instruction instr("gelu", {a});
+  instr.SetAttr("approximate", approximate);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+std::vector<Variable> NetBuilder::layer_norm(
+    const Variable& a, const Variable& scale, const Variable& bias, int begin_norm_axis, float epsilon) {
+  Instruction instr("layer_norm", {a, scale, bias});
+  instr.SetAttr("begin_norm_axis", begin_norm_axis);
+  instr.SetAttr("epsilon", epsilon);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return {instr.GetOutput(0), instr.GetOutput(1), instr.GetOutput(2)};
+}
+
+Variable NetBuilder::gather(const Variable& a, const Variable& index, int axis) {
+  Instruction instr("gather", {a, index});
+  instr.SetAttr("axis", axis);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::lookup_table(const Variable& table, const Variable& ids, int padding_idx) {
+  Instruction instr("gather", {table, ids});
+  instr.SetAttr("axis", 0);
+  instr.SetAttr("padding_idx", padding_idx);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::select(const Variable& condition, const Variable& true_value, const Variable& false_value) {
+  Instruction instr("select", {condition, true_value, false_value});
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::slice(const Variable& a,
                            const std::vector<int>& axes,
                            const std::vector<int>& starts,
@@ -309,6 +371,14 @@ Variable NetBuilder::sum(const std::vector<Variable>& inputs) {
   return instr.GetOutput(0);
 }
 
+Variable NetBuilder::concat(const std::vector<Variable>& inputs, int axis) {
+  Instruction instr("concat", inputs);
+  instr.SetAttr("axis", axis);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 // conv2d grad, output(grad_x, grad_w)
 std::vector<Variable> NetBuilder::conv2d_grad(const Variable& dy,
                                               const Variable& x,
@@ -332,5 +402,45 @@ std::vector<Variable> NetBuilder::conv2d_grad(const Variable& dy,
   return instr.GetOutputs();
 }
 
+Variable NetBuilder::sgd(const Variable& param, const Variable& grad, const Variable& learning_rate) {
+  Instruction instr("sgd", {param, grad, learning_rate});
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+std::vector<Variable> NetBuilder::momentum(const Variable& param,
+                                           const Variable& grad,
+                                           const Variable& velocity,
+                                           const Variable& learning_rate,
+                                           float mu,
+                                           bool use_nesterov) {
+  Instruction instr("momentum", {param, grad, velocity, learning_rate});
+  instr.SetAttr("mu", mu);
+  instr.SetAttr("use_nesterov", use_nesterov);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
+std::vector<Variable> NetBuilder::adam(const Variable& param,
+                                       const Variable& grad,
+                                       const Variable& learning_rate,
+                                       const Variable& moment1,
+                                       const Variable& moment2,
+                                       const Variable& beta1_pow,
+                                       const Variable& beta2_pow,
+                                       float beta1,
+                                       float beta2,
+                                       float epsilon) {
+  Instruction instr("adam", {param, grad, learning_rate, moment1, moment2, beta1_pow, beta2_pow});
+  instr.SetAttr("beta1", beta1);
+  instr.SetAttr("beta2", beta2);
+  instr.SetAttr("epsilon", epsilon);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
 }  // namespace frontend
 }  // namespace cinn
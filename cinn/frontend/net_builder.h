@@ -49,6 +49,11 @@ class NetBuilder : public BaseBuilder {
    */
   Variable mul(const Variable& a, const Variable& b, int x_num_col_dims = 1, int y_num_col_dims = 1);
 
+  /**
+   * Multiply two matrix or two batches of matrix, the product is scaled by alpha.
+   */
+  Variable matmul(const Variable& a, const Variable& b, bool trans_a = false, bool trans_b = false, float alpha = 1.0f);
+
   /**
    * Multiply two matrix and add a bias.
    */
@@ -164,8 +169,36 @@ class NetBuilder : public BaseBuilder {
 
   Variable softmax(const Variable& a, int axis = -1, const std::string& data_format = "AnyLayout");
 
+  Variable log_softmax(const Variable& a, int axis = -1, const std::string& data_format = "AnyLayout");
+
   Variable sigmoid(const Variable& a);
 
+  /**
+   * Gaussian Error Linear Unit, approximate(true) uses the tanh form instead of erf.
+   */
+  Variable gelu(const Variable& a, bool approximate = false);
+
+  /**
+   * Normalize the axes from begin_norm_axis on, output={y, mean, variance}.
+   */
+  std::vector<Variable> layer_norm(const Variable& a,
+                                   const Variable& scale,
+                                   const Variable& bias,
+                                   int begin_norm_axis = 1,
+                                   float epsilon       = 1e-5f);
+
+  /**
+   * Pick the slices of a along axis by the int32 or int64 index.
+   */
+  Variable gather(const Variable& a, const Variable& index, int axis = 0);
+
+  /**
+   * Embedding lookup: pick the rows of table by the int32 or int64 ids, the rows picked by padding_idx are zero.
+   */
+  Variable lookup_table(const Variable& table, const Variable& ids, int padding_idx = -1);
+
+  Variable select(const Variable& condition, const Variable& true_value, const Variable& false_value);
+
   Variable slice(const Variable& a,
                  const std::vector<int>& axes,
                  const std::vector<int>& starts        = {},
@@ -179,6 +212,11 @@ class NetBuilder : public BaseBuilder {
 
   Variable sum(const std::vector<Variable>& inputs);
 
+  /**
+   * Concatenate the variables along the axis.
+   */
+  Variable concat(const std::vector<Variable>& inputs, int axis = 0);
+
   // conv2d grad, output(grad_x, grad_w)
   std::vector<Variable> conv2d_grad(const Variable& dy,
                                     const Variable& x,
@@ -189,6 +227,35 @@ class NetBuilder : public BaseBuilder {
                                     const int groups                     = 1,
                                     const std::string& data_format       = "NCHW",
                                     const std::string& padding_algorithm = "EXPLICIT");
+
+  /**
+   * The optimizer ops update the parameters element-wisely, they are decomposed into elementwise ops fused into one
+   * kernel. The parameters may have any shape, so the ones already coalesced into a flat buffer by the caller are
+   * updated in one launch, otherwise each parameter takes a launch of its own. The learning rate is a tensor of
+   * shape [1].
+   */
+  // param_out = param - learning_rate * grad
+  Variable sgd(const Variable& param, const Variable& grad, const Variable& learning_rate);
+
+  // velocity_out = mu * velocity + grad, output(param_out, velocity_out)
+  std::vector<Variable> momentum(const Variable& param,
+                                 const Variable& grad,
+                                 const Variable& velocity,
+                                 const Variable& learning_rate,
+                                 float mu          = 0.9f,
+                                 bool use_nesterov = false);
+
+  // output(param_out, moment1_out, moment2_out, beta1_pow_out, beta2_pow_out)
+  std::vector<Variable> adam(const Variable& param,
+                             const Variable& grad,
+                             const Variable& learning_rate,
+                             const Variable& moment1,
+                             const Variable& moment2,
+                             const Variable& beta1_pow,
+                             const Variable& beta2_pow,
+                             float beta1   = 0.9f,
+                             float beta2   = 0.999f,
+                             float epsilon = 1e-8f);
 };
 
 }  // namespace frontend
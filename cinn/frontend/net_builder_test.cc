@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <random>
 #include <vector>
@@ -189,5 +190,186 @@ TEST(net_build, program_execute_reverse) {
   runtime_program->Execute();
 }
 
+TEST(net_build, program_execute_layer_norm_gelu) {
+  const int M = 8;
+  const int N = 64;
+
+  NetBuilder builder("net_builder");
+  Placeholder input = builder.CreateInput(Float(32), {M, N}, "X");
+  Placeholder scale = builder.CreateInput(Float(32), {N}, "Scale");
+  Placeholder bias  = builder.CreateInput(Float(32), {N}, "Bias");
+  auto norm_outs    = builder.layer_norm(input, scale, bias, 1, 1e-5f);
+  Variable out      = builder.gelu(norm_outs[0]);
+  auto program      = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  for (auto& name : {std::string(input.id()), std::string(scale.id()), std::string(bias.id())}) {
+    SetRandData(scope->GetTensor(name), target);
+  }
+  runtime_program->Execute();
+
+  auto get_data = [&](const std::string& name) {
+    auto tensor = scope->GetTensor(name);
+    std::vector<float> data(tensor->shape().numel());
+#ifdef CINN_WITH_CUDA
+    cudaMemcpy(data.data(), tensor->data<float>(), data.size() * sizeof(float), cudaMemcpyDeviceToHost);
+#else
+    std::copy(tensor->data<float>(), tensor->data<float>() + data.size(), data.begin());
+#endif
+    return data;
+  };
+  auto x       = get_data(input.id());
+  auto gamma   = get_data(scale.id());
+  auto beta    = get_data(bias.id());
+  auto result  = get_data(out->id);
+  auto var_out = get_data(norm_outs[2]->id);
+  for (int i = 0; i < M; i++) {
+    float mean = 0.f, var = 0.f;
+    for (int j = 0; j < N; j++) mean += x[i * N + j] / N;
+    for (int j = 0; j < N; j++) var += (x[i * N + j] - mean) * (x[i * N + j] - mean) / N;
+    ASSERT_NEAR(var_out[i], var, 1e-4);
+    for (int j = 0; j < N; j++) {
+      float y = (x[i * N + j] - mean) / std::sqrt(var + 1e-5f) * gamma[j] + beta[j];
+      ASSERT_NEAR(result[i * N + j], 0.5f * y * (1.f + std::erf(y / std::sqrt(2.f))), 1e-4);
+    }
+  }
+}
+
+TEST(net_build, program_execute_layer_norm_large_mean) {
+  // begin_norm_axis > 1 fuses the leading axes in the schedule, and the large offset checks the variance is centered
+  const int B = 2;
+  const int M = 4;
+  const int N = 16;
+
+  NetBuilder builder("net_builder");
+  Placeholder input = builder.CreateInput(Float(32), {B, M, N}, "X");
+  Placeholder scale = builder.CreateInput(Float(32), {N}, "Scale");
+  Placeholder bias  = builder.CreateInput(Float(32), {N}, "Bias");
+  auto norm_outs    = builder.layer_norm(input, scale, bias, 2, 1e-5f);
+  auto program      = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  std::vector<float> x(B * M * N), gamma(N, 1.f), beta(N, 0.f);
+  for (int i = 0; i < x.size(); i++) {
+    x[i] = 1000.f + 0.01f * ((i * 13) % 17);
+  }
+  auto set_data = [&](const std::string& name, const std::vector<float>& data) {
+    auto tensor = scope->GetTensor(name);
+#ifdef CINN_WITH_CUDA
+    cudaMemcpy(
+        tensor->mutable_data<float>(target), data.data(), data.size() * sizeof(float), cudaMemcpyHostToDevice);
+#else
+    std::copy(data.begin(), data.end(), tensor->mutable_data<float>(target));
+#endif
+  };
+  set_data(input.id(), x);
+  set_data(scale.id(), gamma);
+  set_data(bias.id(), beta);
+  runtime_program->Execute();
+
+  auto get_data = [&](const std::string& name) {
+    auto tensor = scope->GetTensor(name);
+    std::vector<float> data(tensor->shape().numel());
+#ifdef CINN_WITH_CUDA
+    cudaMemcpy(data.data(), tensor->data<float>(), data.size() * sizeof(float), cudaMemcpyDeviceToHost);
+#else
+    std::copy(tensor->data<float>(), tensor->data<float>() + data.size(), data.begin());
+#endif
+    return data;
+  };
+  auto result   = get_data(norm_outs[0]->id);
+  auto mean_out = get_data(norm_outs[1]->id);
+  auto var_out  = get_data(norm_outs[2]->id);
+  ASSERT_EQ(mean_out.size(), B * M);
+  for (int i = 0; i < B * M; i++) {
+    double mean = 0., var = 0.;
+    for (int j = 0; j < N; j++) mean += x[i * N + j] / static_cast<double>(N);
+    for (int j = 0; j < N; j++) var += (x[i * N + j] - mean) * (x[i * N + j] - mean) / N;
+    ASSERT_NEAR(mean_out[i], mean, 1e-3);
+    ASSERT_NEAR(var_out[i], var, 1e-4);
+    for (int j = 0; j < N; j++) {
+      ASSERT_NEAR(result[i * N + j], (x[i * N + j] - mean) / std::sqrt(var + 1e-5), 5e-2);
+    }
+  }
+}
+
+TEST(net_build, program_execute_lookup_table) {
+  const int V = 100;
+  const int D = 32;
+  const int L = 16;
+
+  NetBuilder builder("net_builder");
+  Placeholder table = builder.CreateInput(Float(32), {V, D}, "Table");
+  Placeholder ids   = builder.CreateInput(Int(32), {2, L}, "Ids");
+  Variable out      = builder.lookup_table(table, ids, 0);
+  auto program      = builder.Build();
+
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  SetRandData(scope->GetTensor(std::string(table.id())), target);
+  std::vector<int> host_ids(2 * L);
+  for (int i = 0; i < host_ids.size(); i++) {
+    host_ids[i] = (i * 7) % V;
+  }
+  auto ids_tensor = scope->GetTensor(std::string(ids.id()));
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(ids_tensor->mutable_data<int>(target),
+             host_ids.data(),
+             host_ids.size() * sizeof(int),
+             cudaMemcpyHostToDevice);
+#else
+  std::copy(host_ids.begin(), host_ids.end(), ids_tensor->mutable_data<int>(target));
+#endif
+  runtime_program->Execute();
+
+  auto table_tensor = scope->GetTensor(std::string(table.id()));
+  auto out_tensor   = scope->GetTensor(std::string(out->id));
+  ASSERT_EQ(out_tensor->shape().data(), std::vector<int>({2, L, D}));
+  std::vector<float> table_data(V * D), out_data(2 * L * D);
+#ifdef CINN_WITH_CUDA
+  cudaMemcpy(table_data.data(), table_tensor->data<float>(), V * D * sizeof(float), cudaMemcpyDeviceToHost);
+  cudaMemcpy(out_data.data(), out_tensor->data<float>(), 2 * L * D * sizeof(float), cudaMemcpyDeviceToHost);
+#else
+  std::copy(table_tensor->data<float>(), table_tensor->data<float>() + V * D, table_data.begin());
+  std::copy(out_tensor->data<float>(), out_tensor->data<float>() + 2 * L * D, out_data.begin());
+#endif
+  for (int i = 0; i < host_ids.size(); i++) {
+    for (int j = 0; j < D; j++) {
+      // the rows picked by padding_idx(0) are zero
+      float expect = host_ids[i] == 0 ? 0.f : table_data[host_ids[i] * D + j];
+      ASSERT_EQ(out_data[i * D + j], expect);
+    }
+  }
+}
+
 }  // namespace frontend
 }  // namespace cinn
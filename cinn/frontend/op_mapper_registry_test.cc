@@ -16,9 +16,17 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <memory>
+#include <string>
 #include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "cinn/frontend/op_mappers/use_op_mappers.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/utils/registry.h"
 
 namespace cinn {
@@ -31,5 +39,162 @@ TEST(OpMapperRegistryTest, basic) {
   ASSERT_EQ(kernel->name, "sigmoid");
 }
 
+// Maps a single paddle op into a program built on the given inputs, then runs it on the host.
+class OpMapperRunner {
+ public:
+  OpMapperRunner()
+      : target_(common::DefaultHostTarget()),
+        builder_("op_mapper_test"),
+        ctx_(scope_, target_, &builder_, &var_map_, &var_model_to_program_map_, &fetch_var_names_) {}
+
+  Variable AddInput(const std::string& name, const Type& type, const std::vector<int>& shape) {
+    Variable var = builder_.CreateInput(type, shape, name);
+    ctx_.AddVar(name, var);
+    return var;
+  }
+
+  void Map(const paddle::cpp::OpDesc& op_desc) {
+    auto* kernel = OpMapperRegistry::Global()->Find(op_desc.Type());
+    ASSERT_NE(kernel, nullptr);
+    kernel->Run(op_desc, ctx_);
+  }
+
+  Variable GetVar(const std::string& name) { return ctx_.GetVar(name); }
+
+  void Compile() {
+    program_ = builder_.Build();
+    auto graph = std::make_shared<hlir::framework::Graph>(program_, target_);
+    run_scope_ = hlir::framework::BuildScope(target_, graph);
+    hlir::framework::GraphCompiler gc(target_, run_scope_, graph);
+    runtime_program_ = gc.Build();
+  }
+
+  template <typename T>
+  void SetData(const Variable& var, const std::vector<T>& data) {
+    auto tensor = run_scope_->GetTensor(var->id);
+    ASSERT_EQ(tensor->shape().numel(), data.size());
+    std::copy(data.begin(), data.end(), tensor->mutable_data<T>(target_));
+  }
+
+  std::vector<float> GetData(const Variable& var) {
+    auto tensor = run_scope_->GetTensor(var->id);
+    return std::vector<float>(tensor->data<float>(), tensor->data<float>() + tensor->shape().numel());
+  }
+
+  void Execute() { runtime_program_->Execute(); }
+
+  const Program& program() const { return program_; }
+
+ private:
+  Target target_;
+  hlir::framework::Scope scope_;
+  NetBuilder builder_;
+  std::unordered_map<std::string, Variable> var_map_;
+  std::unordered_map<std::string, std::string> var_model_to_program_map_;
+  std::unordered_set<std::string> fetch_var_names_;
+  OpMapperContext ctx_;
+  Program program_;
+  std::shared_ptr<hlir::framework::Scope> run_scope_;
+  std::unique_ptr<hlir::framework::Program> runtime_program_;
+};
+
+TEST(OpMapperTest, gelu_approximate) {
+  OpMapperRunner runner;
+  auto x = runner.AddInput("x", Float(32), {4, 16});
+
+  paddle::cpp::OpDesc op_desc;
+  op_desc.SetType("gelu");
+  op_desc.SetInput("X", {"x"});
+  op_desc.SetOutput("Out", {"out"});
+  op_desc.SetAttr<bool>("approximate", true);
+  runner.Map(op_desc);
+  auto out = runner.GetVar("out");
+
+  runner.Compile();
+  ASSERT_EQ(runner.program().size(), 1UL);
+  ASSERT_EQ(runner.program()[0]->op_type, "gelu");
+  ASSERT_TRUE(runner.program()[0].GetAttrs<bool>("approximate"));
+
+  std::vector<float> x_data(4 * 16);
+  for (int i = 0; i < x_data.size(); i++) {
+    x_data[i] = -4.f + 0.125f * i;
+  }
+  runner.SetData(x, x_data);
+  runner.Execute();
+  auto result = runner.GetData(out);
+  for (int i = 0; i < x_data.size(); i++) {
+    float v = x_data[i];
+    float y = 0.5f * v * (1.f + std::tanh(std::sqrt(2.f / M_PI) * (v + 0.044715f * v * v * v)));
+    ASSERT_NEAR(result[i], y, 1e-5);
+  }
+}
+
+TEST(OpMapperTest, where) {
+  OpMapperRunner runner;
+  auto cond = runner.AddInput("cond", Bool(), {32});
+  auto x    = runner.AddInput("x", Float(32), {32});
+  auto y    = runner.AddInput("y", Float(32), {32});
+
+  paddle::cpp::OpDesc op_desc;
+  op_desc.SetType("where");
+  op_desc.SetInput("Condition", {"cond"});
+  op_desc.SetInput("X", {"x"});
+  op_desc.SetInput("Y", {"y"});
+  op_desc.SetOutput("Out", {"out"});
+  runner.Map(op_desc);
+  auto out = runner.GetVar("out");
+
+  runner.Compile();
+  std::vector<bool> cond_data(32);
+  std::vector<float> x_data(32), y_data(32);
+  for (int i = 0; i < 32; i++) {
+    cond_data[i] = i % 3 == 0;
+    x_data[i]    = i;
+    y_data[i]    = -i;
+  }
+  runner.SetData(cond, cond_data);
+  runner.SetData(x, x_data);
+  runner.SetData(y, y_data);
+  runner.Execute();
+  auto result = runner.GetData(out);
+  for (int i = 0; i < 32; i++) {
+    ASSERT_EQ(result[i], cond_data[i] ? x_data[i] : y_data[i]);
+  }
+}
+
+TEST(OpMapperTest, lookup_table_int64_ids) {
+  const int V = 10;
+  const int D = 8;
+  OpMapperRunner runner;
+  auto w   = runner.AddInput("w", Float(32), {V, D});
+  auto ids = runner.AddInput("ids", Int(64), {3, 1});
+
+  paddle::cpp::OpDesc op_desc;
+  op_desc.SetType("lookup_table");
+  op_desc.SetInput("W", {"w"});
+  op_desc.SetInput("Ids", {"ids"});
+  op_desc.SetOutput("Out", {"out"});
+  op_desc.SetAttr<int64_t>("padding_idx", 2);
+  runner.Map(op_desc);
+  auto out = runner.GetVar("out");
+
+  runner.Compile();
+  std::vector<float> w_data(V * D);
+  for (int i = 0; i < w_data.size(); i++) {
+    w_data[i] = i;
+  }
+  std::vector<int64_t> ids_data{7, 2, 0};
+  runner.SetData(w, w_data);
+  runner.SetData(ids, ids_data);
+  runner.Execute();
+  auto result = runner.GetData(out);
+  ASSERT_EQ(result.size(), 3 * D);
+  for (int i = 0; i < ids_data.size(); i++) {
+    for (int j = 0; j < D; j++) {
+      ASSERT_EQ(result[i * D + j], ids_data[i] == 2 ? 0.f : w_data[ids_data[i] * D + j]);
+    }
+  }
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,98 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace op_mappers {
+
+void GatherOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  CHECK_EQ(op_desc.Input("Index").size(), 1UL);
+  auto index_name = op_desc.Input("Index").front();
+  CHECK_EQ(op_desc.Output("Out").size(), 1UL);
+  auto out_name = op_desc.Output("Out").front();
+  CHECK(op_desc.Input("Axis").empty()) << "The axis of gather should be an attribute, not a tensor.";
+
+  auto axis = utils::GetAttrOrDefault<int>(op_desc, "axis", 0);
+
+  auto x     = ctx.GetVar(x_name);
+  auto index = ctx.GetVar(index_name);
+  auto out   = ctx.Builder()->gather(x, index, axis);
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+void LookupTableOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("W").size(), 1UL);
+  auto w_name = op_desc.Input("W").front();
+  CHECK_EQ(op_desc.Input("Ids").size(), 1UL);
+  auto ids_name = op_desc.Input("Ids").front();
+  CHECK_EQ(op_desc.Output("Out").size(), 1UL);
+  auto out_name = op_desc.Output("Out").front();
+
+  auto padding_idx = utils::GetAttrOrDefault<int64_t>(op_desc, "padding_idx", -1);
+
+  auto w   = ctx.GetVar(w_name);
+  auto ids = ctx.GetVar(ids_name);
+  if (op_desc.Type() == "lookup_table") {
+    // the ids of lookup_table(v1) have a trailing dimension of 1
+    CHECK(!ids->shape.empty() && ids->shape.back() == 1) << "The last dim of lookup_table's ids should be 1.";
+    if (ids->shape.size() > 1) {
+      auto shape = ids->shape;
+      shape.pop_back();
+      ids = ctx.Builder()->reshape(ids, shape);
+    }
+  }
+  auto out = ctx.Builder()->lookup_table(w, ids, static_cast<int>(padding_idx));
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+void WhereOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("Condition").size(), 1UL);
+  auto cond_name = op_desc.Input("Condition").front();
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  CHECK_EQ(op_desc.Input("Y").size(), 1UL);
+  auto y_name = op_desc.Input("Y").front();
+  CHECK_EQ(op_desc.Output("Out").size(), 1UL);
+  auto out_name = op_desc.Output("Out").front();
+
+  auto cond = ctx.GetVar(cond_name);
+  auto x    = ctx.GetVar(x_name);
+  auto y    = ctx.GetVar(y_name);
+  auto out  = ctx.Builder()->select(cond, x, y);
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+}  // namespace op_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(gather) {
+  CINN_REGISTER_OP_MAPPER(gather, cinn::frontend::op_mappers::GatherOpMapper)
+  CINN_REGISTER_OP_MAPPER(lookup_table, cinn::frontend::op_mappers::LookupTableOpMapper)
+  CINN_REGISTER_OP_MAPPER(lookup_table_v2, cinn::frontend::op_mappers::LookupTableOpMapper)
+  CINN_REGISTER_OP_MAPPER(where, cinn::frontend::op_mappers::WhereOpMapper)
+  return true;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace op_mappers {
+
+void LayerNormOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto get_input_var = [&op_desc, &ctx](const std::string& op_name) {
+    CHECK_EQ(op_desc.Input(op_name).size(), 1UL);
+    auto var_name = op_desc.Input(op_name).front();
+    return ctx.GetVar(var_name);
+  };
+
+  auto x     = get_input_var("X");
+  auto scale = get_input_var("Scale");
+  auto bias  = get_input_var("Bias");
+
+  auto begin_norm_axis = utils::GetAttrOrDefault<int>(op_desc, "begin_norm_axis", 1);
+  auto epsilon         = utils::GetAttrOrDefault<float>(op_desc, "epsilon", 1e-5f);
+
+  auto outs = ctx.Builder()->layer_norm(x, scale, bias, begin_norm_axis, epsilon);
+  CHECK_EQ(outs.size(), 3ul) << "layer_norm API's should return 3 Variable!";
+
+  std::vector<std::string> output_names = {"Y", "Mean", "Variance"};
+  for (int i = 0; i < outs.size(); i++) {
+    if (op_desc.Output(output_names[i]).empty()) {
+      // The Mean and Variance are only used by the backward, and can be empty in inference models
+      continue;
+    }
+    CHECK_EQ(op_desc.Output(output_names[i]).size(), 1UL);
+    auto out_name = op_desc.Output(output_names[i]).front();
+    ctx.AddVar(out_name, outs[i]);
+    ctx.AddVarModelToProgram(out_name, outs[i]->id);
+  }
+}
+
+}  // namespace op_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(layer_norm) {
+  CINN_REGISTER_OP_MAPPER(layer_norm, cinn::frontend::op_mappers::LayerNormOpMapper)
+  return true;
+}
@@ -0,0 +1,219 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace op_mappers {
+
+namespace {
+
+// grad = rescale_grad * grad + coeff * param if the L2 decay is used, the same as paddle's momentum
+Variable ApplyRegularization(NetBuilder* builder,
+                             const Variable& param,
+                             const Variable& grad,
+                             const std::string& method,
+                             float coeff,
+                             float rescale_grad) {
+  auto scaled_grad = rescale_grad == 1.f ? grad : builder->scale(grad, rescale_grad);
+  if (method.empty()) {
+    return scaled_grad;
+  }
+  CHECK_EQ(method, "l2_decay") << "The regularization method " << method << " is not supported now.";
+  return builder->add(scaled_grad, builder->scale(param, coeff));
+}
+
+void AddOutputVar(const paddle::cpp::OpDesc& op_desc,
+                  const OpMapperContext& ctx,
+                  const std::string& output_name,
+                  const std::vector<Variable>& outs) {
+  auto out_names = op_desc.Output(output_name);
+  CHECK_EQ(out_names.size(), outs.size()) << "The number of the outputs " << output_name << " is not matched";
+  for (int i = 0; i < outs.size(); ++i) {
+    // the optimizers update the parameters and the moments in place, so the outputs replace the inputs
+    ctx.AddVar(out_names[i], outs[i], true);
+    ctx.AddVarModelToProgram(out_names[i], outs[i]->id);
+  }
+}
+
+}  // namespace
+
+void SgdOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto get_input_var = [&op_desc, &ctx](const std::string& op_name) {
+    CHECK_EQ(op_desc.Input(op_name).size(), 1UL);
+    auto var_name = op_desc.Input(op_name).front();
+    return ctx.GetVar(var_name);
+  };
+
+  auto param = get_input_var("Param");
+  auto grad  = get_input_var("Grad");
+  auto lr    = get_input_var("LearningRate");
+
+  VLOG(4) << "sgd param: " << param->id << ", grad: " << grad->id << ", learning_rate: " << lr->id;
+  auto param_out = ctx.Builder()->sgd(param, grad, lr);
+  AddOutputVar(op_desc, ctx, "ParamOut", {param_out});
+}
+
+void MomentumOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto get_input_var = [&op_desc, &ctx](const std::string& op_name) {
+    CHECK_EQ(op_desc.Input(op_name).size(), 1UL);
+    auto var_name = op_desc.Input(op_name).front();
+    return ctx.GetVar(var_name);
+  };
+
+  auto param    = get_input_var("Param");
+  auto grad     = get_input_var("Grad");
+  auto velocity = get_input_var("Velocity");
+  auto lr       = get_input_var("LearningRate");
+
+  auto mu           = utils::GetAttrOrDefault<float>(op_desc, "mu", 0.9f);
+  auto use_nesterov = utils::GetAttrOrDefault<bool>(op_desc, "use_nesterov", false);
+  auto reg_method   = utils::GetAttrOrDefault<std::string>(op_desc, "regularization_method", "");
+  auto reg_coeff    = utils::GetAttrOrDefault<float>(op_desc, "regularization_coeff", 0.f);
+  auto rescale_grad = utils::GetAttrOrDefault<float>(op_desc, "rescale_grad", 1.f);
+
+  grad      = ApplyRegularization(ctx.Builder(), param, grad, reg_method, reg_coeff, rescale_grad);
+  auto outs = ctx.Builder()->momentum(param, grad, velocity, lr, mu, use_nesterov);
+  CHECK_EQ(outs.size(), 2UL) << "momentum API's should return 2 Variable!";
+
+  AddOutputVar(op_desc, ctx, "ParamOut", {outs[0]});
+  AddOutputVar(op_desc, ctx, "VelocityOut", {outs[1]});
+}
+
+void AdamOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto get_input_var = [&op_desc, &ctx](const std::string& op_name) {
+    CHECK_EQ(op_desc.Input(op_name).size(), 1UL);
+    auto var_name = op_desc.Input(op_name).front();
+    return ctx.GetVar(var_name);
+  };
+  CHECK(!op_desc.HasInput("Beta1Tensor") || op_desc.Input("Beta1Tensor").empty())
+      << "The betas given by tensors are not supported now.";
+
+  auto param     = get_input_var("Param");
+  auto grad      = get_input_var("Grad");
+  auto lr        = get_input_var("LearningRate");
+  auto moment1   = get_input_var("Moment1");
+  auto moment2   = get_input_var("Moment2");
+  auto beta1_pow = get_input_var("Beta1Pow");
+  auto beta2_pow = get_input_var("Beta2Pow");
+
+  auto beta1   = utils::GetAttrOrDefault<float>(op_desc, "beta1", 0.9f);
+  auto beta2   = utils::GetAttrOrDefault<float>(op_desc, "beta2", 0.999f);
+  auto epsilon = utils::GetAttrOrDefault<float>(op_desc, "epsilon", 1e-8f);
+
+  auto outs = ctx.Builder()->adam(param, grad, lr, moment1, moment2, beta1_pow, beta2_pow, beta1, beta2, epsilon);
+  CHECK_EQ(outs.size(), 5UL) << "adam API's should return 5 Variable!";
+
+  std::vector<std::string> output_names = {"ParamOut", "Moment1Out", "Moment2Out", "Beta1PowOut", "Beta2PowOut"};
+  for (int i = 0; i < outs.size(); i++) {
+    if (op_desc.Output(output_names[i]).empty()) {
+      // The powers of betas are not updated by the op if they are updated globally
+      continue;
+    }
+    AddOutputVar(op_desc, ctx, output_names[i], {outs[i]});
+  }
+}
+
+// merged_momentum is mapped to one momentum op per parameter, which is fused into one kernel of its own, so N
+// parameters still take N launches. Updating them in one launch needs them to live in one flat buffer. Packing them
+// here with concat and unpacking with slice copies every parameter, gradient and velocity on each step, because the
+// buffers are owned by the caller and passed in by name, so that is not done. When the caller coalesces the
+// parameters into contiguous memory, e.g. paddle's fuse_all_optimizer_ops, it passes one flat tensor to momentum,
+// which MomentumOpMapper updates in one kernel.
+void MergedMomentumOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto mu           = utils::GetAttrOrDefault<float>(op_desc, "mu", 0.9f);
+  auto use_nesterov = utils::GetAttrOrDefault<bool>(op_desc, "use_nesterov", false);
+  auto reg_methods  = utils::GetAttrOrDefault<std::vector<std::string>>(op_desc, "regularization_method");
+  auto reg_coeffs   = utils::GetAttrOrDefault<std::vector<float>>(op_desc, "regularization_coeff");
+  auto rescale_grad = utils::GetAttrOrDefault<float>(op_desc, "rescale_grad", 1.f);
+
+  auto param_names     = op_desc.Input("Param");
+  auto lr_names        = op_desc.Input("LearningRate");
+  auto param_out_names = op_desc.Output("ParamOut");
+  auto velo_out_names  = op_desc.Output("VelocityOut");
+  CHECK(lr_names.size() == 1UL || lr_names.size() == param_names.size())
+      << "The number of the learning rates should be 1 or the same as the parameters";
+  CHECK_EQ(param_out_names.size(), param_names.size());
+  CHECK_EQ(velo_out_names.size(), param_names.size());
+  for (int i = 0; i < param_names.size(); ++i) {
+    auto param    = ctx.GetVar(param_names[i]);
+    auto grad     = ctx.GetVar(op_desc.Input("Grad").at(i));
+    auto velocity = ctx.GetVar(op_desc.Input("Velocity").at(i));
+    auto lr       = ctx.GetVar(lr_names.size() == 1UL ? lr_names.front() : lr_names[i]);
+
+    std::string method = reg_methods.empty() ? "" : reg_methods.at(i);
+    float coeff        = reg_coeffs.empty() ? 0.f : reg_coeffs.at(i);
+    grad               = ApplyRegularization(ctx.Builder(), param, grad, method, coeff, rescale_grad);
+    auto outs          = ctx.Builder()->momentum(param, grad, velocity, lr, mu, use_nesterov);
+    CHECK_EQ(outs.size(), 2UL) << "momentum API's should return 2 Variable!";
+
+    ctx.AddVar(param_out_names[i], outs[0], true);
+    ctx.AddVarModelToProgram(param_out_names[i], outs[0]->id);
+    ctx.AddVar(velo_out_names[i], outs[1], true);
+    ctx.AddVarModelToProgram(velo_out_names[i], outs[1]->id);
+  }
+}
+
+// merged_adam is mapped to one adam op per parameter with its own powers of betas, for the same reason as
+// merged_momentum, see MergedMomentumOpMapper.
+void MergedAdamOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto beta1   = utils::GetAttrOrDefault<float>(op_desc, "beta1", 0.9f);
+  auto beta2   = utils::GetAttrOrDefault<float>(op_desc, "beta2", 0.999f);
+  auto epsilon = utils::GetAttrOrDefault<float>(op_desc, "epsilon", 1e-8f);
+
+  auto param_names = op_desc.Input("Param");
+  auto lr_names    = op_desc.Input("LearningRate");
+  CHECK(lr_names.size() == 1UL || lr_names.size() == param_names.size())
+      << "The number of the learning rates should be 1 or the same as the parameters";
+  std::vector<std::string> output_names = {"ParamOut", "Moment1Out", "Moment2Out", "Beta1PowOut", "Beta2PowOut"};
+  for (int i = 0; i < param_names.size(); ++i) {
+    auto param     = ctx.GetVar(param_names[i]);
+    auto grad      = ctx.GetVar(op_desc.Input("Grad").at(i));
+    auto lr        = ctx.GetVar(lr_names.size() == 1UL ? lr_names.front() : lr_names[i]);
+    auto moment1   = ctx.GetVar(op_desc.Input("Moment1").at(i));
+    auto moment2   = ctx.GetVar(op_desc.Input("Moment2").at(i));
+    auto beta1_pow = ctx.GetVar(op_desc.Input("Beta1Pow").at(i));
+    auto beta2_pow = ctx.GetVar(op_desc.Input("Beta2Pow").at(i));
+
+    auto outs = ctx.Builder()->adam(param, grad, lr, moment1, moment2, beta1_pow, beta2_pow, beta1, beta2, epsilon);
+    CHECK_EQ(outs.size(), 5UL) << "adam API's should return 5 Variable!";
+    for (int k = 0; k < output_names.size(); ++k) {
+      auto out_names = op_desc.Output(output_names[k]);
+      if (out_names.empty()) {
+        // The powers of betas are not updated by the op if they are updated globally
+        continue;
+      }
+      ctx.AddVar(out_names.at(i), outs[k], true);
+      ctx.AddVarModelToProgram(out_names.at(i), outs[k]->id);
+    }
+  }
+}
+
+}  // namespace op_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(optimizer) {
+  CINN_REGISTER_OP_MAPPER(sgd, cinn::frontend::op_mappers::SgdOpMapper)
+  CINN_REGISTER_OP_MAPPER(momentum, cinn::frontend::op_mappers::MomentumOpMapper)
+  CINN_REGISTER_OP_MAPPER(adam, cinn::frontend::op_mappers::AdamOpMapper)
+  CINN_REGISTER_OP_MAPPER(merged_momentum, cinn::frontend::op_mappers::MergedMomentumOpMapper)
+  CINN_REGISTER_OP_MAPPER(merged_adam, cinn::frontend::op_mappers::MergedAdamOpMapper)
+  return true;
+}
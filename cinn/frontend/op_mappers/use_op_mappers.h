@@ -30,3 +30,7 @@ CINN_USE_REGISTER(pool2d)
 CINN_USE_REGISTER(conv2d)
 CINN_USE_REGISTER(transpose)
 CINN_USE_REGISTER(reshape)
+CINN_USE_REGISTER(layer_norm)
+CINN_USE_REGISTER(gelu)
+CINN_USE_REGISTER(gather)
+CINN_USE_REGISTER(optimizer)
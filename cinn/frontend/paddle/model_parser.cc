@@ -15,6 +15,7 @@
 #include "cinn/frontend/paddle/model_parser.h"
 
 #include <fstream>
+#include <streambuf>
 #include <vector>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -23,6 +24,7 @@
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/common.h"
 #include "cinn/frontend/paddle/compatible_pb.h"
+#include "cinn/utils/string.h"
 
 namespace cinn::frontend::paddle {
 
@@ -153,6 +155,15 @@ std::unique_ptr<framework_proto::ProgramDesc> LoadProgram(const std::string &pat
   return main_program;
 }
 
+void LoadProgramDesc(const std::string &model_dir, cpp::ProgramDesc *cpp_prog, bool model_from_memory) {
+  CHECK(cpp_prog);
+  cpp_prog->ClearBlocks();
+  framework_proto::ProgramDesc pb_proto_prog = *LoadProgram(model_dir + "/__model__", model_from_memory);
+  pb::ProgramDesc pb_prog(&pb_proto_prog);
+  // Transform to cpp::ProgramDesc
+  TransformProgramDescAnyToCpp(pb_prog, cpp_prog);
+}
+
 void LoadParams(const std::string &path) {}
 
 // Load directly to CPU, and latter transfer to other devices.
@@ -170,45 +181,180 @@ bool IsPersistable(const cpp::VarDesc &var) {
   return false;
 }
 
-void LoadCombinedParamsPb(const std::string &path,
-                          hlir::framework::Scope *scope,
-                          const cpp::ProgramDesc &cpp_prog,
-                          bool params_from_memory,
-                          const common::Target &target) {
-  CHECK(scope);
-  auto prog             = cpp_prog;
-  auto &main_block_desc = *prog.GetBlock<cpp::BlockDesc>(0);
+namespace {
+
+template <typename T>
+T ReadValue(std::istream &is, std::string *bytes) {
+  T value;
+  is.read(reinterpret_cast<char *>(&value), sizeof(T));
+  bytes->append(reinterpret_cast<const char *>(&value), sizeof(T));
+  return value;
+}
+
+void ReadBytes(std::istream &is, size_t size, std::string *bytes) {
+  size_t offset = bytes->size();
+  bytes->resize(offset + size);
+  is.read(&(*bytes)[offset], size);
+}
+
+// Read the bytes of a LoDTensor in the layout of LoadLoDTensor, only its desc is parsed to know the data size.
+void ReadLoDTensorBytes(std::istream &is, std::string *bytes) {
+  bytes->clear();
+  ReadValue<uint32_t>(is, bytes);  // version
+  auto lod_level = ReadValue<uint64_t>(is, bytes);
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    auto size = ReadValue<uint64_t>(is, bytes);
+    ReadBytes(is, size, bytes);
+  }
+  ReadValue<uint32_t>(is, bytes);  // tensor version
+  auto desc_size   = ReadValue<int32_t>(is, bytes);
+  auto desc_offset = bytes->size();
+  ReadBytes(is, desc_size, bytes);
+  CHECK(static_cast<bool>(is)) << "There is a problem with loading model parameters";
+  framework_proto::VarType::TensorDesc desc;
+  CHECK(desc.ParseFromArray(bytes->data() + desc_offset, desc_size)) << "Cannot parse tensor desc";
+  int64_t numel = 1;
+  for (auto dim : desc.dims()) {
+    numel *= dim;
+  }
+  ReadBytes(is, numel * SizeOfType(desc.data_type()), bytes);
+  CHECK(static_cast<bool>(is)) << "There is a problem with loading model parameters";
+}
+
+// An input stream buffer over the bytes of a parameter, so they are deserialized without a copy.
+struct BytesBuf : public std::streambuf {
+  explicit BytesBuf(std::string *bytes) { setg(&(*bytes)[0], &(*bytes)[0], &(*bytes)[0] + bytes->size()); }
+};
 
-  // Get vars
-  std::vector<std::string> paramlist;
+}  // namespace
+
+ParamsLoader::ParamsLoader(const cpp::ProgramDesc &cpp_prog,
+                           const std::string &path,
+                           hlir::framework::Scope *scope,
+                           bool combined,
+                           bool params_from_memory,
+                           const common::Target &target,
+                           int num_threads)
+    : path_(path), scope_(scope), combined_(combined), params_from_memory_(params_from_memory), target_(target) {
+  CHECK(scope_);
+  CHECK(combined_ || !params_from_memory_) << "Only the parameters of a combined model can be loaded from memory";
+  auto &main_block_desc = cpp_prog.GetConstBlock<cpp::BlockDesc>(0);
   for (size_t i = 0; i < main_block_desc.VarsSize(); ++i) {
-    auto &var = *main_block_desc.GetVar<cpp::VarDesc>(i);
+    auto &var = main_block_desc.GetConstVar<cpp::VarDesc>(i);
     if (!IsPersistable(var)) continue;
-    paramlist.push_back(var.Name());
+    CHECK(combined_ || var.GetType() == cpp::VarDescAPI::Type::LOD_TENSOR) << "unknown weight type of " << var.Name();
+    param_names_.push_back(var.Name());
+  }
+  // the parameters in a combined file are sorted by name
+  if (combined_) {
+    std::sort(param_names_.begin(), param_names_.end());
+  }
+
+  raw_params_.resize(param_names_.size());
+  for (size_t i = 0; i < param_names_.size(); ++i) {
+    params_.emplace_back(hlir::framework::Tensor());
   }
-  std::sort(paramlist.begin(), paramlist.end());
-
-  // Load vars
-  auto load_var_func = [&](std::istream &is) {
-    for (size_t i = 0; i < paramlist.size(); ++i) {
-      auto *var = scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(paramlist[i]));
-      // Error checking
-      CHECK(static_cast<bool>(is)) << "There is a problem with loading model parameters";
-      LoadLoDTensor(is, var, target);
+  if (num_threads <= 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  num_threads = std::max(1, std::min(num_threads, static_cast<int>(param_names_.size())));
+  VLOG(4) << "Start load " << param_names_.size() << " model params with " << num_threads << " threads...";
+
+  reader_ = std::thread(&ParamsLoader::ReadParams, this);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&ParamsLoader::DeserializeParams, this);
+  }
+}
+
+ParamsLoader::~ParamsLoader() { Wait(); }
+
+void ParamsLoader::ReadParams() {
+  auto push = [this](int i) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_.push_back(i);
     }
-    is.peek();
-    CHECK(is.eof()) << "You are not allowed to load partial data via"
-                    << " LoadCombinedParamsPb, use LoadParam instead.";
+    cv_.notify_one();
   };
 
-  if (params_from_memory) {
-    std::stringstream fin(path, std::ios::in | std::ios::binary);
-    load_var_func(fin);
+  if (combined_) {
+    auto read_combined = [&](std::istream &is) {
+      for (int i = 0; i < param_names_.size(); ++i) {
+        ReadLoDTensorBytes(is, &raw_params_[i]);
+        push(i);
+      }
+      is.peek();
+      CHECK(is.eof()) << "You are not allowed to load partial data via"
+                      << " LoadCombinedParamsPb, use LoadParam instead.";
+    };
+    if (params_from_memory_) {
+      std::stringstream fin(path_, std::ios::in | std::ios::binary);
+      read_combined(fin);
+    } else {
+      std::ifstream fin(path_, std::ios::binary);
+      CHECK(fin.is_open()) << "failed to open file " << path_;
+      read_combined(fin);
+    }
   } else {
-    std::ifstream fin(path, std::ios::binary);
-    CHECK(fin.is_open());
-    load_var_func(fin);
+    for (int i = 0; i < param_names_.size(); ++i) {
+      VLOG(4) << "reading weight " << param_names_[i];
+      ReadBinaryFile(path_ + "/" + param_names_[i], &raw_params_[i]);
+      push(i);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    read_finished_ = true;
+  }
+  cv_.notify_all();
+}
+
+void ParamsLoader::DeserializeParams() {
+  while (true) {
+    int i = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !ready_.empty() || read_finished_; });
+      if (ready_.empty()) return;
+      i = ready_.front();
+      ready_.pop_front();
+    }
+    BytesBuf buf(&raw_params_[i]);
+    std::istream is(&buf);
+    LoadLoDTensor(is, &params_[i], target_);
+    // release the raw bytes once the tensor is on the target
+    std::string().swap(raw_params_[i]);
+  }
+}
+
+void ParamsLoader::Wait() {
+  if (waited_) return;
+  waited_ = true;
+  reader_.join();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  for (size_t i = 0; i < param_names_.size(); ++i) {
+    auto *var          = scope_->Var<hlir::framework::Tensor>(utils::TransValidVarName(param_names_[i]));
+    auto &param        = absl::get<hlir::framework::Tensor>(params_[i]);
+    auto &declared     = absl::get<hlir::framework::Tensor>(*var);
+    auto declared_dims = declared->shape().data();
+    CHECK(declared_dims.empty() || declared_dims == param->shape().data())
+        << "The shape of parameter [" << param_names_[i] << "] is [" << cinn::utils::Join(param->shape().data(), ",")
+        << "], but it is declared as [" << cinn::utils::Join(declared_dims, ",") << "]";
+    *var = params_[i];
   }
+  VLOG(4) << "Load " << param_names_.size() << " model params successfully";
+}
+
+void LoadCombinedParamsPb(const std::string &path,
+                          hlir::framework::Scope *scope,
+                          const cpp::ProgramDesc &cpp_prog,
+                          bool params_from_memory,
+                          const common::Target &target) {
+  ParamsLoader loader(cpp_prog, path, scope, true, params_from_memory, target);
+  loader.Wait();
 }
 
 void LoadModelPb(const std::string &model_dir,
@@ -227,43 +373,19 @@ void LoadModelPb(const std::string &model_dir,
   LOG(INFO) << "param_file is: " << param_file;
   // Load model
   VLOG(4) << "Start load model program...";
-  std::string prog_path       = model_dir + "/__model__";
   std::string param_file_temp = param_file;
   if (combined) {
-    // prog_path = model_file;
     param_file_temp = model_dir + "/params";
   }
-  framework_proto::ProgramDesc pb_proto_prog = *LoadProgram(prog_path, model_from_memory);
-  pb::ProgramDesc pb_prog(&pb_proto_prog);
-  // Transform to cpp::ProgramDesc
-  TransformProgramDescAnyToCpp(pb_prog, cpp_prog);
+  LoadProgramDesc(model_dir, cpp_prog, model_from_memory);
 
   // Load Params
   // NOTE: Only main block be used now.
-  VLOG(4) << "Start load model params...";
   CHECK(!(!combined && model_from_memory)) << "If you want use the model_from_memory,"
                                            << " you should load the combined model using cfg.set_model_buffer "
                                               "interface.";
-  if (combined) {
-    LoadCombinedParamsPb(param_file_temp, scope, *cpp_prog, model_from_memory, target);
-  } else {
-    auto main_block = pb_proto_prog.blocks(0);
-    for (auto &var : main_block.vars()) {
-      if (var.name() == "feed" || var.name() == "fetch" || !var.persistable()) continue;
-
-      std::string file_path = model_dir + "/" + var.name();
-      VLOG(4) << "reading weight " << var.name();
-
-      std::ifstream file(file_path, std::ios::binary);
-      switch (var.type().type()) {
-        case framework_proto::VarType_Type_LOD_TENSOR:
-          LoadLoDTensor(file, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())), target);
-          break;
-        default:
-          LOG(FATAL) << "unknown weight type";
-      }
-    }
-  }
+  ParamsLoader loader(*cpp_prog, combined ? param_file_temp : model_dir, scope, combined, model_from_memory, target);
+  loader.Wait();
 
   VLOG(4) << "Load protobuf model in [" << model_dir << "] successfully";
 }
@@ -14,8 +14,12 @@
 
 #pragma once
 #include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "cinn/frontend/paddle/cpp/program_desc.h"
@@ -42,6 +46,56 @@ void LoadModelPb(const std::string& model_dir,
 // Read a __model__ file.
 std::unique_ptr<framework_proto::ProgramDesc> LoadProgram(const std::string& path, bool program_from_memory = false);
 
+// Read the __model__ file in model_dir to a cpp::ProgramDesc, without the parameters.
+void LoadProgramDesc(const std::string& model_dir, cpp::ProgramDesc* cpp_prog, bool model_from_memory = false);
+
+// Loads the parameters of the main block in the background. One thread reads the raw bytes of the parameters in order,
+// from the combined params file (or buffer) at path, or from the file of each parameter in the directory path. The
+// tensors are deserialized and copied to the target by num_threads workers as soon as their bytes are read. The loader
+// threads never touch the scope, the loaded tensors are put into it by Wait(), so the caller can map the ops meanwhile.
+class ParamsLoader {
+ public:
+  ParamsLoader(const cpp::ProgramDesc& cpp_prog,
+               const std::string& path,
+               hlir::framework::Scope* scope,
+               bool combined                = true,
+               bool params_from_memory      = false,
+               const common::Target& target = common::DefaultHostTarget(),
+               int num_threads              = 0);
+
+  ~ParamsLoader();
+
+  // the names of the parameters in the model, in the order they are loaded
+  const std::vector<std::string>& param_names() const { return param_names_; }
+
+  // Blocks until all the parameters are loaded, then puts them into the scope. The variable of a parameter already
+  // declared in the scope should have the same shape.
+  void Wait();
+
+ private:
+  void ReadParams();
+
+  void DeserializeParams();
+
+  std::vector<std::string> param_names_;
+  std::vector<std::string> raw_params_;
+  std::vector<hlir::framework::Variable> params_;
+  std::string path_;
+  hlir::framework::Scope* scope_{};
+  bool combined_{true};
+  bool params_from_memory_{false};
+  common::Target target_;
+
+  // the indices of the parameters whose bytes are read but not deserialized yet
+  std::deque<int> ready_;
+  bool read_finished_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread reader_;
+  std::vector<std::thread> workers_;
+  bool waited_{false};
+};
+
 void LoadLoDTensor(std::istream& is, hlir::framework::Variable* var, const common::Target& target);
 
 // Read a single file containing all the parameters.
@@ -17,6 +17,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <sstream>
 #include <unordered_set>
 #include <utility>
 
@@ -43,12 +44,30 @@ void PaddleModelConvertor::PrepareRun(const paddle::cpp::BlockDesc& block_desc,
     if (op_desc.Type() == "feed") {
       for (const auto& var_name : op_desc.output_vars()) {
         CHECK(var_desc_map.count(var_name)) << "Feed var [" << var_name << "] Not found in block";
-        ctx->AddFeedInfo(var_name, utils::GetFeedInfoFromDesc(*var_desc_map[var_name]));
+        auto feed_info = utils::GetFeedInfoFromDesc(*var_desc_map[var_name]);
+        if (feed_shapes_.count(var_name)) {
+          feed_info.shape = feed_shapes_.at(var_name);
+        }
+        ctx->AddFeedInfo(var_name, feed_info);
       }
     }
   }
 }
 
+void PaddleModelConvertor::DeclareParams(const paddle::cpp::BlockDesc& block_desc,
+                                         const std::vector<std::string>& param_names) {
+  std::unordered_set<std::string> param_set(param_names.begin(), param_names.end());
+  for (int i = 0; i < block_desc.VarsSize(); i++) {
+    const auto& var_desc = block_desc.GetConstVar<paddle::cpp::VarDesc>(i);
+    if (!param_set.count(var_desc.Name())) continue;
+    auto info    = utils::GetFeedInfoFromDesc(var_desc);
+    auto* var    = scope_->Var<hlir::framework::Tensor>(cinn::utils::TransValidVarName(var_desc.Name()));
+    auto& tensor = absl::get<hlir::framework::Tensor>(*var);
+    tensor->Resize(hlir::framework::Shape(info.shape));
+    tensor->set_type(info.type);
+  }
+}
+
 void PaddleModelConvertor::RunOp(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
   const auto& op_type = op_desc.Type();
   auto kernel         = OpMapperRegistry::Global()->Find(op_type);
@@ -67,12 +86,82 @@ std::unordered_set<std::string> PaddleModelConvertor::GetFetchIds() const {
   return fetch_names;
 }
 
+std::string PartitionReport::DebugString() const {
+  std::stringstream ss;
+  ss << "Compiled " << num_compiled_ops << " of " << num_ops << " ops (" << coverage() * 100 << "%) into "
+     << num_programs << " programs, with " << num_fallback_segments << " fallback segments";
+  for (const auto& item : fallback_ops) {
+    ss << "\n  fallback op [" << item.first << "] x " << item.second;
+  }
+  return ss.str();
+}
+
+void PaddleModelConvertor::PrepareFallbackOp(
+    const paddle::cpp::OpDesc& op_desc,
+    const FallbackKernel& kernel,
+    const std::unordered_map<std::string, const paddle::cpp::VarDesc*>& var_desc_map,
+    std::unordered_set<std::string>* boundary_ids) {
+  // the inputs produced by the programs are found by their names in the model, and share the tensors of the programs
+  for (const auto& name : op_desc.input_vars()) {
+    auto valid_name = cinn::utils::TransValidVarName(name);
+    auto it         = var_map_.find(valid_name);
+    if (it == var_map_.end() || it->second->id == valid_name) continue;
+    const auto& var   = it->second;
+    auto* program_var = scope_->Var<hlir::framework::Tensor>(var->id);
+    auto& tensor      = absl::get<hlir::framework::Tensor>(*program_var);
+    tensor->Resize(hlir::framework::Shape(var->shape));
+    tensor->set_type(var->type);
+    absl::get<hlir::framework::Tensor>(*scope_->Var<hlir::framework::Tensor>(valid_name)) = tensor;
+    boundary_ids->insert(var->id);
+  }
+
+  FallbackContext ctx(scope_, target_);
+  if (kernel.HasInferShape()) {
+    kernel.InferShape(op_desc, ctx);
+  } else {
+    for (const auto& name : op_desc.output_vars()) {
+      CHECK(var_desc_map.count(name)) << "The output [" << name << "] of fallback op " << op_desc.Type()
+                                      << " Not found in block";
+      auto info = utils::GetFeedInfoFromDesc(*var_desc_map.at(name));
+      ctx.DeclareTensor(name, info.shape, info.type);
+    }
+  }
+
+  // the ops after the fallback op get its outputs from the scope
+  for (const auto& name : op_desc.output_vars()) {
+    auto valid_name = cinn::utils::TransValidVarName(name);
+    var_map_.erase(valid_name);
+    var_model_to_program_map_[name] = valid_name;
+  }
+}
+
 Program PaddleModelConvertor::operator()(const std::string& model_dir, bool is_combined) {
+  auto segments = Partition(model_dir, is_combined);
+  CHECK(segments.size() == 1UL && !segments[0].is_fallback)
+      << "The model cannot be converted into one program, please use Partition instead:\n"
+      << partition_report_.DebugString();
+  return std::move(segments[0].program);
+}
+
+std::vector<ModelSegment> PaddleModelConvertor::Partition(const std::string& model_dir,
+                                                          bool is_combined,
+                                                          const std::unordered_set<std::string>& force_fallback_ops) {
   paddle::cpp::ProgramDesc program_desc;
-  paddle::LoadModelPb(model_dir, "__model__", "", scope_, &program_desc, is_combined, false, target_);
+  paddle::LoadProgramDesc(model_dir, &program_desc);
   CHECK_EQ(program_desc.BlocksSize(), 1) << "CINN can only support the model with a single block";
   auto* block_desc = program_desc.GetBlock<paddle::cpp::BlockDesc>(0);
 
+  // the parameters are read and deserialized in the background, overlapped with the op mapping below
+  std::string params_path = is_combined ? model_dir + "/params" : model_dir;
+  paddle::ParamsLoader params_loader(program_desc, params_path, scope_, is_combined, false, target_, num_load_threads_);
+  DeclareParams(*block_desc, params_loader.param_names());
+
+  std::unordered_map<std::string, const paddle::cpp::VarDesc*> var_desc_map;
+  for (int i = 0; i < block_desc->VarsSize(); i++) {
+    const auto& var_desc          = block_desc->GetConstVar<paddle::cpp::VarDesc>(i);
+    var_desc_map[var_desc.Name()] = &var_desc;
+  }
+
   // unique builder name like program_1_of_12
   std::string builder_name = "program_";
   if (program_desc.HasVersion()) {
@@ -83,15 +172,97 @@ Program PaddleModelConvertor::operator()(const std::string& model_dir, bool is_c
   builder_name.append(std::to_string(unique_invoke_number++));
   VLOG(4) << "NetBuilder Name " << builder_name;
 
-  NetBuilder builder(builder_name);
-  OpMapperContext ctx(*scope_, target_, &builder, &var_map_, &var_model_to_program_map_, &fetch_var_names_);
+  partition_report_ = PartitionReport();
+  std::vector<ModelSegment> segments;
+  // the ids of the variables used across the segments
+  std::unordered_set<std::string> boundary_ids;
+
+  std::unique_ptr<NetBuilder> builder;
+  std::unique_ptr<OpMapperContext> ctx;
+  // the variables defined in the program being built
+  std::unordered_set<std::string> program_vars;
+  auto build_program = [&]() {
+    if (builder && builder->size() > 0) {
+      segments.emplace_back();
+      segments.back().program = builder->Build();
+      partition_report_.num_programs++;
+    }
+    ctx.reset();
+    builder.reset();
+  };
 
-  PrepareRun(*block_desc, &ctx);
   for (int i = 0; i < block_desc->OpsSize(); i++) {
-    auto* op_desc = block_desc->GetOp<paddle::cpp::OpDesc>(i);
-    RunOp(*op_desc, ctx);
+    auto* op_desc         = block_desc->GetOp<paddle::cpp::OpDesc>(i);
+    const auto& op_type   = op_desc->Type();
+    bool is_feed_or_fetch = op_type == "feed" || op_type == "fetch";
+    if (!is_feed_or_fetch) {
+      partition_report_.num_ops++;
+    }
+
+    if (!is_feed_or_fetch && (force_fallback_ops.count(op_type) || !OpMapperRegistry::Global()->Find(op_type))) {
+      auto* kernel = FallbackKernelRegistry::Global()->Find(op_type);
+      CHECK(kernel) << "Op [" << op_type << "] Not supported in OpMapper, and has no fallback kernel";
+      build_program();
+      if (segments.empty() || !segments.back().is_fallback) {
+        segments.emplace_back();
+        segments.back().is_fallback = true;
+        partition_report_.num_fallback_segments++;
+      }
+      PrepareFallbackOp(*op_desc, *kernel, var_desc_map, &boundary_ids);
+      segments.back().fallback_ops.push_back(*op_desc);
+      partition_report_.fallback_ops[op_type]++;
+      continue;
+    }
+
+    if (!builder) {
+      auto name = segments.empty() ? builder_name : builder_name + "_" + std::to_string(segments.size());
+      builder   = std::make_unique<NetBuilder>(name);
+      ctx       = std::make_unique<OpMapperContext>(
+          *scope_, target_, builder.get(), &var_map_, &var_model_to_program_map_, &fetch_var_names_);
+      PrepareRun(*block_desc, ctx.get());
+      program_vars.clear();
+    }
+    // the variables from the previous segments are the inputs of the later programs
+    if (!segments.empty()) {
+      for (const auto& name : op_desc->input_vars()) {
+        auto valid_name = cinn::utils::TransValidVarName(name);
+        if (program_vars.count(valid_name) || (!var_map_.count(valid_name) && !scope_->FindVar(valid_name))) continue;
+        builder->CreateInput(ctx->GetVar(name));
+        program_vars.insert(valid_name);
+      }
+    }
+    RunOp(*op_desc, *ctx);
+    if (!is_feed_or_fetch) {
+      partition_report_.num_compiled_ops++;
+    }
+    for (const auto& name : op_desc->output_vars()) {
+      program_vars.insert(cinn::utils::TransValidVarName(name));
+    }
+  }
+  build_program();
+  params_loader.Wait();
+
+  // the variables used by the later segments or fetched are kept by the programs producing them
+  auto fetch_ids = GetFetchIds();
+  boundary_ids.insert(fetch_ids.begin(), fetch_ids.end());
+  for (auto& segment : segments) {
+    if (segment.is_fallback) continue;
+    for (auto& var : segment.program.GetInputs()) {
+      boundary_ids.insert(var->id);
+    }
+  }
+  for (auto& segment : segments) {
+    if (segment.is_fallback) continue;
+    for (size_t i = 0; i < segment.program.size(); i++) {
+      for (auto& out : segment.program[i]->outputs) {
+        if (boundary_ids.count(out->id)) {
+          segment.fetch_ids.insert(out->id);
+        }
+      }
+    }
   }
-  return builder.Build();
+  VLOG(3) << partition_report_.DebugString();
+  return segments;
 }
 
 }  // namespace frontend
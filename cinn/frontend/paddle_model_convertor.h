@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "cinn/common/target.h"
+#include "cinn/frontend/fallback_kernel_registry.h"
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/op_mapper_registry.h"
 #include "cinn/frontend/paddle/cpp/block_desc.h"
@@ -29,28 +32,71 @@
 namespace cinn {
 namespace frontend {
 
+// A part of the partitioned model in the order of the ops. It is a CINN program with the ids of its variables used by
+// the later segments or fetched, or the consecutive ops run by their fallback kernels.
+struct ModelSegment {
+  bool is_fallback{false};
+  Program program;
+  std::unordered_set<std::string> fetch_ids;
+  std::vector<paddle::cpp::OpDesc> fallback_ops;
+};
+
+// The coverage of the ops compiled by CINN in the partitioned model, the feed and fetch ops are not counted.
+struct PartitionReport {
+  int num_ops{0};
+  int num_compiled_ops{0};
+  int num_programs{0};
+  int num_fallback_segments{0};
+  // the number of the ops run by the fallback kernels for each op type
+  std::map<std::string, int> fallback_ops;
+
+  float coverage() const { return num_ops > 0 ? static_cast<float>(num_compiled_ops) / num_ops : 1.0f; }
+
+  std::string DebugString() const;
+};
+
 // Transform paddle model to CINN fronted::Program object.
 // The paddle model is readed from __model__ file in model_dir, the PaddleModelConvertor
 // will run each op's kernel registered in OpMapper, each kernel will add instruction in
 // NetBuilder, after running all op of model, it will invoke its Build function and
 // finally return the complete fronted::Program object.
-// Note that if anyone op not registered, the program will failed and aborted.
+// Note that if anyone op not registered, the program will failed and aborted. Partition converts such a model into the
+// CINN programs and the fallback segments of the ops without OpMapper, which are run by the registered FallbackKernels.
+// The parameters are loaded by num_load_threads threads in the background while the ops are mapped, the OpMappers
+// only see their shapes and dtypes declared from the model, and they are all in the scope when operator() returns.
 class PaddleModelConvertor {
  public:
-  explicit PaddleModelConvertor(hlir::framework::Scope* scope, const common::Target& target)
-      : scope_(scope), target_(target) {
+  explicit PaddleModelConvertor(hlir::framework::Scope* scope, const common::Target& target, int num_load_threads = 0)
+      : scope_(scope), target_(target), num_load_threads_(num_load_threads) {
     CHECK(scope_);
   }
 
+  // set the shapes of the feed variables instead of the shapes in their var descs, such as the batch size
+  void SetFeedShapes(const std::unordered_map<std::string, std::vector<int>>& feed_shapes) {
+    feed_shapes_ = feed_shapes;
+  }
+
   // prepare feed variable before run CINN op
   void PrepareRun(const paddle::cpp::BlockDesc& block_desc, OpMapperContext* ctx);
 
+  // declare the parameters still being loaded in the scope, with the shape and dtype in their var desc
+  void DeclareParams(const paddle::cpp::BlockDesc& block_desc, const std::vector<std::string>& param_names);
+
   // RunOp accept OpDesc and global run context then run it's kernel registered in OpMapper.
   static void RunOp(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx);
 
   // operator() accept the modle's directory, and return the fronted::Program object.
   Program operator()(const std::string& model_dir, bool is_combined = false);
 
+  // Partition accept the model's directory, and return the segments of the model in order. The ops without OpMapper
+  // and the ops in force_fallback_ops are run by their fallback kernels.
+  std::vector<ModelSegment> Partition(const std::string& model_dir,
+                                      bool is_combined                                          = false,
+                                      const std::unordered_set<std::string>& force_fallback_ops = {});
+
+  // return the coverage report of the last partitioned model
+  const PartitionReport& partition_report() const { return partition_report_; }
+
   // return the internal variable map
   const auto& var_map() const { return var_map_; }
 
@@ -61,6 +107,12 @@ class PaddleModelConvertor {
   std::unordered_set<std::string> GetFetchIds() const;
 
  private:
+  // declare the outputs of the fallback op in the scope, and share the tensors of its inputs mapped in the programs
+  void PrepareFallbackOp(const paddle::cpp::OpDesc& op_desc,
+                         const FallbackKernel& kernel,
+                         const std::unordered_map<std::string, const paddle::cpp::VarDesc*>& var_desc_map,
+                         std::unordered_set<std::string>* boundary_ids);
+
   std::unordered_map<std::string, Variable> var_map_;
   // map from var in Paddle model to var name in program.
   std::unordered_map<std::string, std::string> var_model_to_program_map_;
@@ -68,6 +120,9 @@ class PaddleModelConvertor {
   std::unordered_set<std::string> fetch_var_names_;
   hlir::framework::Scope* scope_{};
   const common::Target& target_;
+  int num_load_threads_{0};
+  std::unordered_map<std::string, std::vector<int>> feed_shapes_;
+  PartitionReport partition_report_;
 };
 
 }  // namespace frontend
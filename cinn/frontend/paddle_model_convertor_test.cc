@@ -17,6 +17,9 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
+#include "cinn/frontend/segment_executor.h"
 #include "cinn/runtime/use_extern_funcs.h"
 
 DEFINE_string(model_dir, "", "");
@@ -40,5 +43,68 @@ TEST(PaddleModelConvertor, basic) {
   ASSERT_GT(program.size(), 0);
 }
 
+void ReluFallbackKernel(const paddle::cpp::OpDesc& op_desc, const FallbackContext& ctx) {
+  auto x              = ctx.GetTensor(op_desc.Input("X").front());
+  auto out            = ctx.GetTensor(op_desc.Output("Out").front());
+  const float* x_data = x->data<float>();
+  float* out_data     = out->mutable_data<float>(ctx.Target());
+  for (int i = 0; i < x->shape().numel(); ++i) {
+    out_data[i] = std::max(x_data[i], 0.0f);
+  }
+}
+
+void ReluFallbackInferShape(const paddle::cpp::OpDesc& op_desc, const FallbackContext& ctx) {
+  auto x = ctx.GetTensor(op_desc.Input("X").front());
+  ctx.DeclareTensor(op_desc.Output("Out").front(), x->shape().data(), x->type());
+}
+
+CINN_REGISTER_FALLBACK_KERNEL(relu, ReluFallbackKernel).SetInferShape(ReluFallbackInferShape);
+
+// run the model partitioned with the fallback ops on the input A of shape [4, 30], and return the output
+std::vector<float> RunPartitionedModel(const std::unordered_set<std::string>& force_fallback_ops,
+                                       PartitionReport* report) {
+  auto scope  = hlir::framework::Scope::Create();
+  auto target = common::DefaultHostTarget();
+
+  PaddleModelConvertor model_transform(scope.get(), target);
+  model_transform.SetFeedShapes({{"A", {4, 30}}});
+  auto segments = model_transform.Partition(FLAGS_model_dir, false, force_fallback_ops);
+  *report       = model_transform.partition_report();
+  auto fetch_id = *model_transform.GetFetchIds().begin();
+
+  SegmentExecutor executor(target, scope);
+  executor.Build(std::move(segments));
+  auto input = scope->GetTensor("A");
+  auto* data = input->mutable_data<float>(target);
+  for (int i = 0; i < input->shape().numel(); ++i) {
+    data[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  executor.Run();
+
+  auto output = scope->GetTensor(fetch_id);
+  return std::vector<float>(output->data<float>(), output->data<float>() + output->shape().numel());
+}
+
+TEST(PaddleModelConvertor, partition_with_fallback) {
+  PartitionReport compiled_report;
+  auto expect = RunPartitionedModel({}, &compiled_report);
+  ASSERT_EQ(compiled_report.num_programs, 1);
+  ASSERT_EQ(compiled_report.num_fallback_segments, 0);
+  ASSERT_EQ(compiled_report.num_compiled_ops, compiled_report.num_ops);
+
+  PartitionReport fallback_report;
+  auto actual = RunPartitionedModel({"relu"}, &fallback_report);
+  LOG(INFO) << fallback_report.DebugString();
+  ASSERT_EQ(fallback_report.num_programs, 2);
+  ASSERT_EQ(fallback_report.num_fallback_segments, 1);
+  ASSERT_EQ(fallback_report.fallback_ops.at("relu"), 1);
+  ASSERT_EQ(fallback_report.num_compiled_ops, fallback_report.num_ops - 1);
+
+  ASSERT_EQ(actual.size(), expect.size());
+  for (size_t i = 0; i < expect.size(); ++i) {
+    ASSERT_NEAR(actual[i], expect[i], 1e-5f);
+  }
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,309 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/pass/pattern_rewriter.h"
+
+#include <absl/container/flat_hash_set.h>
+
+#include <algorithm>
+#include <list>
+
+#include "cinn/frontend/program_pass.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+PatternRef Var(const std::string& name, const std::function<bool(const Variable&)>& var_pred) {
+  auto node      = std::make_shared<PatternNode>();
+  node->name     = name;
+  node->var_pred = var_pred;
+  return node;
+}
+
+PatternRef Op(const std::string& name,
+              const std::string& op_type,
+              const std::vector<PatternRef>& inputs,
+              const std::function<bool(const Instruction&)>& attr_pred,
+              int output_index) {
+  CHECK(!op_type.empty()) << "The op type of the pattern node [" << name << "] should not be empty";
+  auto node          = std::make_shared<PatternNode>();
+  node->name         = name;
+  node->op_type      = op_type;
+  node->inputs       = inputs;
+  node->attr_pred    = attr_pred;
+  node->output_index = output_index;
+  return node;
+}
+
+std::vector<Variable> RewriteBuilder::AppendOp(
+    const std::string& op_type,
+    const std::vector<Variable>& inputs,
+    const absl::flat_hash_map<std::string, hlir::framework::AttrType>& attrs) {
+  Instruction instr(op_type, inputs);
+  for (auto& attr : attrs) {
+    instr->attrs[attr.first] = attr.second;
+  }
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
+void RewriteContext::MapOutToOrigin(const Variable& new_var, const Variable& ori_var) const {
+  if (new_var->shape != ori_var->shape) {
+    LOG(FATAL) << "The output shape shoule be equal to the original. But received : " << new_var->id << ".shape=["
+               << utils::Join(new_var->shape, ", ") << "] and the original var " << ori_var->id << ".shape=["
+               << utils::Join(ori_var->shape, ", ") << "].";
+  }
+  (*var_map_)[new_var->id] = ori_var;
+}
+
+namespace {
+
+// The instructions are kept in a list, so the instructions built by a rewrite are spliced in place of the matched
+// root, after the producers of all their inputs.
+class PatternRewriter {
+ public:
+  PatternRewriter(const Program& program,
+                  const std::unordered_set<std::string>& fetch_ids,
+                  const std::vector<const RewriteRule*>& rules)
+      : fetch_ids_(fetch_ids) {
+    for (auto* rule : rules) {
+      CHECK(rule->pattern()) << "The pattern of rule [" << rule->name << "] is not set";
+      rules_[rule->pattern()->op_type].push_back(rule);
+    }
+    for (size_t i = 0; i < program.size(); ++i) {
+      Insert(instrs_.end(), program[i]);
+    }
+  }
+
+  void Run() {
+    // the worklist is a stack, so the instructions are visited from the last one at first
+    std::vector<Instruction> worklist(instrs_.begin(), instrs_.end());
+    while (!worklist.empty()) {
+      auto instr = worklist.back();
+      worklist.pop_back();
+      auto it = rules_.find(instr->op_type);
+      if (!positions_.count(instr.get()) || it == rules_.end()) continue;
+      for (auto* rule : it->second) {
+        PatternMatch match;
+        if (Match(*rule, instr, &match)) {
+          Rewrite(*rule, instr, match, &worklist);
+          break;
+        }
+      }
+    }
+  }
+
+  const std::list<Instruction>& instrs() const { return instrs_; }
+
+ private:
+  int UseCount(const std::string& var_id) const {
+    auto it = use_count_.find(var_id);
+    return it == use_count_.end() ? 0 : it->second;
+  }
+
+  bool MatchOp(const PatternNode& node, const Instruction& instr, PatternMatch* match) const {
+    if (instr->op_type != node.op_type || instr->inputs.size() != node.inputs.size()) return false;
+    if (node.attr_pred && !node.attr_pred(instr)) return false;
+    match->instrs.emplace(node.name, instr);
+    for (size_t i = 0; i < node.inputs.size(); ++i) {
+      if (!MatchVar(*node.inputs[i], instr->inputs[i], match)) return false;
+    }
+    return true;
+  }
+
+  bool MatchVar(const PatternNode& node, const Variable& var, PatternMatch* match) const {
+    auto bound = match->vars.find(node.name);
+    if (bound != match->vars.end()) {
+      return bound->second->id == var->id;
+    }
+    if (!node.is_op()) {
+      if (node.var_pred && !node.var_pred(var)) return false;
+      match->vars.emplace(node.name, var);
+      return true;
+    }
+    auto it = producers_.find(var->id);
+    if (it == producers_.end()) return false;
+    const auto& instr = it->second;
+    if (node.output_index >= static_cast<int>(instr->outputs.size()) ||
+        instr->outputs[node.output_index]->id != var->id) {
+      return false;
+    }
+    match->vars.emplace(node.name, var);
+    return MatchOp(node, instr, match);
+  }
+
+  bool Match(const RewriteRule& rule, const Instruction& root, PatternMatch* match) const {
+    const auto& pattern = *rule.pattern();
+    if (pattern.output_index >= static_cast<int>(root->outputs.size())) return false;
+    match->vars.emplace(pattern.name, root->outputs[pattern.output_index]);
+    if (!MatchOp(pattern, root, match)) return false;
+
+    // the matched instructions except the root are removed, so their outputs should be used only inside the match
+    absl::flat_hash_set<_Instruction_*> matched;
+    absl::flat_hash_map<std::string, int> inner_uses;
+    for (auto& item : match->instrs) {
+      if (!matched.insert(item.second.get()).second) continue;
+      for (auto& in : item.second->inputs) {
+        inner_uses[in->id]++;
+      }
+    }
+    for (auto& item : match->instrs) {
+      if (item.second.get() == root.get()) continue;
+      for (auto& out : item.second->outputs) {
+        if (fetch_ids_.count(out->id) || UseCount(out->id) != inner_uses[out->id]) return false;
+      }
+    }
+    return rule.Check(*match);
+  }
+
+  void Rewrite(const RewriteRule& rule,
+               const Instruction& root,
+               const PatternMatch& match,
+               std::vector<Instruction>* worklist) {
+    RewriteBuilder builder("pattern_rewrite_builder");
+    absl::flat_hash_map<std::string, Variable> var_map;
+    rule.Run(match, RewriteContext(&builder, &var_map));
+    auto replacement = builder.Build();
+
+    absl::flat_hash_set<std::string> mapped;
+    for (auto& item : var_map) {
+      mapped.insert(item.second->id);
+    }
+    for (auto& out : root->outputs) {
+      CHECK(mapped.count(out->id) || (UseCount(out->id) == 0 && !fetch_ids_.count(out->id)))
+          << "The output " << out->id << " of " << root << " is used but not mapped by rule [" << rule.name << "]";
+    }
+    VLOG(3) << "Rewrite " << root << " by rule [" << rule.name << "] into " << replacement.size() << " instructions";
+
+    // the outputs of the root are produced by the replacement, and the consumers of the root are kept
+    auto pos = positions_.at(root.get());
+    std::vector<Instruction> inserted;
+    for (size_t i = 0; i < replacement.size(); ++i) {
+      auto instr = replacement[i];
+      for (auto* vars : {&instr->outputs, &instr->inputs}) {
+        for (auto& var : *vars) {
+          auto it = var_map.find(var->id);
+          if (it != var_map.end()) {
+            var = it->second;
+          }
+        }
+      }
+      Insert(pos, instr);
+      inserted.push_back(instr);
+    }
+    absl::flat_hash_set<_Instruction_*> erased;
+    for (auto& item : match.instrs) {
+      if (erased.insert(item.second.get()).second) {
+        Erase(item.second);
+      }
+    }
+
+    // the new instructions may be matched as a root or as a part of the patterns rooted at their consumers
+    for (auto& instr : inserted) {
+      for (auto& in : instr->inputs) {
+        auto it = producers_.find(in->id);
+        if (it != producers_.end()) {
+          worklist->push_back(it->second);
+        }
+      }
+      for (auto& out : instr->outputs) {
+        for (auto& consumer : consumers_[out->id]) {
+          worklist->push_back(consumer);
+        }
+      }
+    }
+    worklist->insert(worklist->end(), inserted.begin(), inserted.end());
+  }
+
+  void Insert(std::list<Instruction>::iterator pos, const Instruction& instr) {
+    positions_[instr.get()] = instrs_.insert(pos, instr);
+    for (auto& in : instr->inputs) {
+      use_count_[in->id]++;
+      consumers_[in->id].push_back(instr);
+    }
+    for (auto& out : instr->outputs) {
+      producers_[out->id] = instr;
+    }
+  }
+
+  void Erase(const Instruction& instr) {
+    for (auto& in : instr->inputs) {
+      use_count_[in->id]--;
+      auto& consumers = consumers_[in->id];
+      consumers.erase(std::remove_if(consumers.begin(),
+                                     consumers.end(),
+                                     [&](const Instruction& consumer) { return consumer.get() == instr.get(); }),
+                      consumers.end());
+    }
+    for (auto& out : instr->outputs) {
+      auto it = producers_.find(out->id);
+      if (it != producers_.end() && it->second.get() == instr.get()) {
+        producers_.erase(it);
+      }
+    }
+    auto it = positions_.find(instr.get());
+    instrs_.erase(it->second);
+    positions_.erase(it);
+  }
+
+  const std::unordered_set<std::string>& fetch_ids_;
+  absl::flat_hash_map<std::string, std::vector<const RewriteRule*>> rules_;
+
+  std::list<Instruction> instrs_;
+  absl::flat_hash_map<_Instruction_*, std::list<Instruction>::iterator> positions_;
+  absl::flat_hash_map<std::string, Instruction> producers_;
+  absl::flat_hash_map<std::string, std::vector<Instruction>> consumers_;
+  absl::flat_hash_map<std::string, int> use_count_;
+};
+
+}  // namespace
+
+void ApplyRewriteRules(Program* program,
+                       const std::unordered_set<std::string>& fetch_ids,
+                       const std::vector<const RewriteRule*>& rules) {
+  PatternRewriter rewriter(*program, fetch_ids, rules);
+  rewriter.Run();
+
+  RewriteBuilder builder("pattern_rewrite_builder");
+  for (auto& var : program->GetInputs()) {
+    builder.CreateInput(var);
+  }
+  for (auto& instr : rewriter.instrs()) {
+    builder.AppendInstruction(instr);
+  }
+  VLOG(2) << "Rewrite the program of " << program->size() << " instructions into " << builder.size()
+          << " instructions.";
+  *program = builder.Build();
+}
+
+/*
+ * Apply all the registered rewrite rules, such as mul + elementwise_add -> mulbias, conv2d + batchnorm folding,
+ * scale chain folding and transpose pair folding.
+ */
+void PatternRewrite(Program* program, const std::unordered_set<std::string>& fetch_ids) {
+  ApplyRewriteRules(program, fetch_ids, RewriteRuleRegistry::Global()->List());
+}
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(PatternRewrite) {
+  CINN_REGISTER_PROGRAM_PASS_FUNCTION(PatternRewrite).set_body(cinn::frontend::pass::PatternRewrite);
+
+  return true;
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/utils/registry.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+struct PatternNode;
+using PatternRef = std::shared_ptr<PatternNode>;
+
+/**
+ * A node of a DAG pattern over the instructions of a Program. An operand node binds to any variable satisfying
+ * `var_pred`, an op node binds to the `output_index`-th output of an instruction of `op_type` whose inputs match
+ * `inputs` and whose attributes satisfy `attr_pred`. A node referenced twice in the pattern binds to the same variable.
+ */
+struct PatternNode {
+  std::string name;
+  std::string op_type;
+  std::vector<PatternRef> inputs;
+  int output_index{0};
+  std::function<bool(const Variable&)> var_pred;
+  std::function<bool(const Instruction&)> attr_pred;
+
+  bool is_op() const { return !op_type.empty(); }
+};
+
+// An operand of the pattern, bound to any variable satisfying the predicate.
+PatternRef Var(const std::string& name, const std::function<bool(const Variable&)>& var_pred = nullptr);
+
+// An instruction of the pattern, bound to the `output_index`-th output of the instruction.
+PatternRef Op(const std::string& name,
+              const std::string& op_type,
+              const std::vector<PatternRef>& inputs,
+              const std::function<bool(const Instruction&)>& attr_pred = nullptr,
+              int output_index                                        = 0);
+
+// The variables and the instructions bound to the named nodes of a pattern.
+struct PatternMatch {
+  absl::flat_hash_map<std::string, Variable> vars;
+  absl::flat_hash_map<std::string, Instruction> instrs;
+
+  const Variable& var(const std::string& name) const {
+    auto it = vars.find(name);
+    CHECK(it != vars.end()) << "No variable is bound to the pattern node [" << name << "]";
+    return it->second;
+  }
+
+  const Instruction& instr(const std::string& name) const {
+    auto it = instrs.find(name);
+    CHECK(it != instrs.end()) << "No instruction is bound to the pattern node [" << name << "]";
+    return it->second;
+  }
+};
+
+// NetBuilder with an entry to append any registered operator, used by the rules for the primitive operators.
+class RewriteBuilder : public NetBuilder {
+ public:
+  using NetBuilder::NetBuilder;
+
+  std::vector<Variable> AppendOp(const std::string& op_type,
+                                 const std::vector<Variable>& inputs,
+                                 const absl::flat_hash_map<std::string, hlir::framework::AttrType>& attrs = {});
+};
+
+class RewriteContext {
+ public:
+  RewriteContext(RewriteBuilder* builder, absl::flat_hash_map<std::string, Variable>* var_map)
+      : builder_(builder), var_map_(var_map) {}
+
+  RewriteBuilder* builder() const { return builder_; }
+
+  // Map the new var to the output of the matched root instruction, so the consumers and the fetch ids are kept.
+  void MapOutToOrigin(const Variable& new_var, const Variable& ori_var) const;
+
+ private:
+  RewriteBuilder* builder_{nullptr};
+  absl::flat_hash_map<std::string, Variable>* var_map_{nullptr};
+};
+
+/**
+ * A rewrite rule replaces the instructions matched by `pattern` with the instructions built by the body. The root of
+ * the pattern must be an op node. The instructions bound to the other op nodes are removed, so their outputs must be
+ * used only inside the match, and the body must map every used output of the root to a new variable.
+ */
+class RewriteRule {
+ public:
+  using Constraint  = std::function<bool(const PatternMatch&)>;
+  using RewriteBody = std::function<void(const PatternMatch&, const RewriteContext&)>;
+
+  RewriteRule& set_pattern(const PatternRef& pattern) {
+    CHECK(pattern && pattern->is_op()) << "The root of the pattern of rule [" << name << "] should be an op node";
+    pattern_ = pattern;
+    return *this;
+  }
+
+  // the constraint across the nodes of the match, checked before the body is run
+  RewriteRule& set_constraint(const Constraint& constraint) {
+    constraint_ = constraint;
+    return *this;
+  }
+
+  RewriteRule& set_body(const RewriteBody& body) {
+    body_ = body;
+    return *this;
+  }
+
+  const PatternRef& pattern() const { return pattern_; }
+  bool Check(const PatternMatch& match) const { return !constraint_ || constraint_(match); }
+  void Run(const PatternMatch& match, const RewriteContext& context) const { body_(match, context); }
+
+  std::string name;
+
+ private:
+  PatternRef pattern_;
+  Constraint constraint_;
+  RewriteBody body_;
+};
+
+class RewriteRuleRegistry : public Registry<RewriteRule> {
+ public:
+  static RewriteRuleRegistry* Global() {
+    static RewriteRuleRegistry x;
+    return &x;
+  }
+
+ private:
+  RewriteRuleRegistry() = default;
+  CINN_DISALLOW_COPY_AND_ASSIGN(RewriteRuleRegistry);
+};
+
+/**
+ * @def CINN_REGISTER_REWRITE_RULE
+ * \brief Register a rewrite rule applied by the program pass `PatternRewrite`
+ *
+ * \code
+ *  CINN_REGISTER_REWRITE_RULE(fuse_mul_add)
+ *      .set_pattern(Op("add", "elementwise_add", {Op("mul", "mul", {Var("x"), Var("y")}), Var("bias")}))
+ *      .set_body([](const PatternMatch& match, const RewriteContext& context) { ... });
+ * \endcode
+ */
+#define CINN_REGISTER_REWRITE_RULE(name) ::cinn::frontend::pass::RewriteRuleRegistry::Global()->__REGISTER__(#name)
+
+/**
+ * Apply the rules to the program in one worklist pass: the instructions are visited from the last one, and the
+ * instructions built by a rewrite, the producers of their inputs and the consumers of their outputs are visited
+ * again, until no rule matches. The outputs in `fetch_ids` are never removed.
+ */
+void ApplyRewriteRules(Program* program,
+                       const std::unordered_set<std::string>& fetch_ids,
+                       const std::vector<const RewriteRule*>& rules);
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,160 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/pass/pattern_rewriter.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <numeric>
+#include <unordered_map>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn::frontend {
+
+std::vector<float> RunProgram(const Program& program,
+                              const std::unordered_map<std::string, std::vector<float>>& inputs,
+                              const std::string& output_id) {
+  Target target = GetTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  for (auto& input : inputs) {
+    scope->Var<hlir::framework::Tensor>(input.first);
+    CopyFromVector<float>(input.second, scope->GetTensor(input.first), target);
+  }
+  runtime_program->Execute();
+
+  std::vector<float> output;
+  CopyToVector<float>(scope->GetTensor(output_id), &output);
+  return output;
+}
+
+int CountOp(const Program& program, const std::string& op_type) {
+  int count = 0;
+  for (size_t i = 0; i < program.size(); ++i) {
+    count += program[i]->op_type == op_type;
+  }
+  return count;
+}
+
+// Rewrite the program built by the builder, check the number of the instructions after the rewrite and the output
+// computed by the rewritten program is the same as the origin one. Return the rewritten program.
+Program CheckRewrite(NetBuilder* builder,
+                     const Variable& output,
+                     size_t expect_size,
+                     const std::unordered_set<std::string>& fetch_ids = {},
+                     float atol                                       = 1e-5f,
+                     float rtol                                       = 1e-5f) {
+  auto origin  = builder->Build();
+  auto program = origin;
+  LOG(INFO) << program;
+  ApplyPass(&program, fetch_ids, "PatternRewrite");
+  LOG(INFO) << program;
+  EXPECT_EQ(program.size(), expect_size);
+
+  std::unordered_map<std::string, std::vector<float>> inputs;
+  for (auto& var : origin.GetInputs()) {
+    int numel = std::accumulate(var->shape.begin(), var->shape.end(), 1, std::multiplies<int>());
+    InitRandomVector<float>(&inputs[var->id], numel, 0.0f, 1.0f);
+  }
+  auto expect = RunProgram(origin, inputs, output->id);
+  auto actual = RunProgram(program, inputs, output->id);
+  CheckOutput<float>(actual, expect, atol, rtol);
+  return program;
+}
+
+TEST(PatternRewrite, fuse_mul_add) {
+  NetBuilder builder("net_builder");
+  auto x    = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto y    = builder.CreateInput(Float(32), {64, 16}, "y");
+  auto bias = builder.CreateInput(Float(32), {32, 64}, "bias");
+  auto out  = builder.elementwise_add(builder.mul(x, y), bias);
+
+  auto program = CheckRewrite(&builder, out, 1);
+  ASSERT_EQ(program[0]->op_type, "mulbias");
+}
+
+TEST(PatternRewrite, cant_fuse_mul_add_by_broadcast) {
+  NetBuilder builder("net_builder");
+  auto x    = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto y    = builder.CreateInput(Float(32), {64, 16}, "y");
+  auto bias = builder.CreateInput(Float(32), {64}, "bias");
+  auto out  = builder.elementwise_add(builder.mul(x, y), bias, 1);
+
+  CheckRewrite(&builder, out, 2);
+}
+
+TEST(PatternRewrite, cant_fuse_mul_add_by_fetch_ids) {
+  NetBuilder builder("net_builder");
+  auto x    = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto y    = builder.CreateInput(Float(32), {64, 16}, "y");
+  auto bias = builder.CreateInput(Float(32), {32, 64}, "bias");
+  auto mul  = builder.mul(x, y);
+  auto out  = builder.elementwise_add(mul, bias);
+
+  CheckRewrite(&builder, out, 2, {mul->id});
+}
+
+TEST(PatternRewrite, fold_conv_batchnorm) {
+  NetBuilder builder("net_builder");
+  auto x        = builder.CreateInput(Float(32), {2, 3, 8, 8}, "x");
+  auto w        = builder.CreateInput(Float(32), {4, 3, 3, 3}, "w");
+  auto scale    = builder.CreateInput(Float(32), {4}, "scale");
+  auto bias     = builder.CreateInput(Float(32), {4}, "bias");
+  auto mean     = builder.CreateInput(Float(32), {4}, "mean");
+  auto variance = builder.CreateInput(Float(32), {4}, "variance");
+  auto conv     = builder.conv2d(x, w, {1, 1}, {1, 1});
+  auto out      = builder.batchnorm(conv, scale, bias, mean, variance, 1e-5f, 0.9f, "NCHW", true)[0];
+
+  auto program = CheckRewrite(&builder, out, 9, {}, 1e-4f, 1e-3f);
+  ASSERT_EQ(CountOp(program, "batchnorm"), 0);
+}
+
+TEST(PatternRewrite, fold_scale_chain) {
+  NetBuilder builder("net_builder");
+  auto x   = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto s1  = builder.scale(x, 2.0f, 1.0f, true);
+  auto s2  = builder.scale(s1, 0.5f, 1.0f, false);
+  auto out = builder.scale(s2, 3.0f, -1.0f, true);
+
+  CheckRewrite(&builder, out, 1);
+}
+
+TEST(PatternRewrite, fold_transpose_pair) {
+  NetBuilder builder("net_builder");
+  auto x   = builder.CreateInput(Float(32), {2, 3, 4}, "x");
+  auto t1  = builder.transpose(x, {1, 0, 2});
+  auto out = builder.transpose(t1, {0, 2, 1});
+
+  auto program = CheckRewrite(&builder, out, 1);
+  ASSERT_EQ(program[0]->op_type, "transpose");
+  ASSERT_EQ(program[0].GetAttrs<std::vector<int>>("axis"), std::vector<int>({1, 2, 0}));
+}
+
+TEST(PatternRewrite, fold_transpose_pair_to_identity) {
+  NetBuilder builder("net_builder");
+  auto x   = builder.CreateInput(Float(32), {2, 3, 4}, "x");
+  auto t1  = builder.transpose(x, {1, 2, 0});
+  auto out = builder.transpose(t1, {2, 0, 1});
+
+  auto program = CheckRewrite(&builder, out, 1);
+  ASSERT_EQ(program[0]->op_type, "identity");
+}
+
+}  // namespace cinn::frontend
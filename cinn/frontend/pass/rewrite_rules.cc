@@ -0,0 +1,134 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utility>
+
+#include "cinn/frontend/pass/pattern_rewriter.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+namespace {
+
+template <typename T>
+T GetAttrOrDefault(const Instruction& instr, const std::string& key, const T& default_value) {
+  auto it = instr->attrs.find(key);
+  return it == instr->attrs.end() ? default_value : absl::get<T>(it->second);
+}
+
+std::function<bool(const Instruction&)> AttrEquals(const std::string& key, const std::string& value) {
+  return [=](const Instruction& instr) { return GetAttrOrDefault<std::string>(instr, key, "") == value; };
+}
+
+// scale(x) = scale * x + bias if bias_after_scale, otherwise scale * (x + bias), return the {a, b} of a * x + b
+std::pair<float, float> LinearOfScale(const Instruction& instr) {
+  float scale           = GetAttrOrDefault<float>(instr, "scale", 1.0f);
+  float bias            = GetAttrOrDefault<float>(instr, "bias", 0.0f);
+  bool bias_after_scale = GetAttrOrDefault<bool>(instr, "bias_after_scale", true);
+  return {scale, bias_after_scale ? bias : scale * bias};
+}
+
+// mul(x, y) + bias -> mulbias(x, y, bias), the bias of mulbias is added element-wisely without broadcast.
+void FuseMulAdd(const PatternMatch& match, const RewriteContext& context) {
+  auto& mul = match.instr("mul");
+  auto out  = context.builder()->mulbias(match.var("x"),
+                                        match.var("y"),
+                                        match.var("bias"),
+                                        GetAttrOrDefault<int>(mul, "x_num_col_dims", 1),
+                                        GetAttrOrDefault<int>(mul, "y_num_col_dims", 1));
+  context.MapOutToOrigin(out, match.var("add"));
+}
+
+// batchnorm(conv2d(x, w)) -> conv2d(x, w * factor) + (bias - mean * factor), factor = scale / sqrt(variance + eps).
+// The factor is computed on the shape of the channel, and the add after the convolution is fused by OpFusion.
+void FoldConvBatchNorm(const PatternMatch& match, const RewriteContext& context) {
+  auto* builder = context.builder();
+  float epsilon = GetAttrOrDefault<float>(match.instr("bn"), "epsilon", 1e-5f);
+
+  auto rsqrt_variance = builder->AppendOp("rsqrt", {builder->scale(match.var("variance"), 1.0f, epsilon)})[0];
+  auto factor         = builder->elementwise_mul(match.var("scale"), rsqrt_variance);
+  auto weight         = builder->elementwise_mul(match.var("w"), factor, 0);
+  auto mean_factor    = builder->elementwise_mul(match.var("mean"), factor);
+  auto bias           = builder->elementwise_add(match.var("bias"), builder->scale(mean_factor, -1.0f));
+
+  auto conv = builder->AppendOp("conv2d", {match.var("x"), weight}, match.instr("conv")->attrs)[0];
+  auto out  = builder->elementwise_add(conv, bias, 1);
+  context.MapOutToOrigin(out, match.var("bn"));
+}
+
+// scale(scale(x)) -> scale(x), a2 * (a1 * x + b1) + b2 = (a2 * a1) * x + (a2 * b1 + b2).
+void FoldScaleChain(const PatternMatch& match, const RewriteContext& context) {
+  auto inner = LinearOfScale(match.instr("inner"));
+  auto outer = LinearOfScale(match.instr("outer"));
+  auto out   = context.builder()->scale(
+      match.var("x"), outer.first * inner.first, outer.first * inner.second + outer.second, true);
+  context.MapOutToOrigin(out, match.var("outer"));
+}
+
+// transpose(transpose(x, p1), p2) -> transpose(x, q), q[i] = p1[p2[i]], or identity(x) if q is the identity.
+void FoldTransposePair(const PatternMatch& match, const RewriteContext& context) {
+  auto inner = match.instr("inner").GetAttrs<std::vector<int>>("axis");
+  auto outer = match.instr("outer").GetAttrs<std::vector<int>>("axis");
+  CHECK_EQ(inner.size(), outer.size()) << "The axes of the transpose pair should have the same size";
+
+  std::vector<int> axis(outer.size());
+  bool is_identity = true;
+  for (size_t i = 0; i < outer.size(); ++i) {
+    axis[i]     = inner[outer[i]];
+    is_identity = is_identity && axis[i] == static_cast<int>(i);
+  }
+  auto* builder = context.builder();
+  auto out      = is_identity ? builder->identity(match.var("x")) : builder->transpose(match.var("x"), axis);
+  context.MapOutToOrigin(out, match.var("outer"));
+}
+
+}  // namespace
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(rewrite_rules) {
+  using cinn::frontend::pass::AttrEquals;
+  using cinn::frontend::pass::Op;
+  using cinn::frontend::pass::PatternMatch;
+  using cinn::frontend::pass::Var;
+
+  CINN_REGISTER_REWRITE_RULE(fuse_mul_add)
+      .set_pattern(Op("add", "elementwise_add", {Op("mul", "mul", {Var("x"), Var("y")}), Var("bias")}))
+      .set_constraint([](const PatternMatch& match) { return match.var("bias")->shape == match.var("mul")->shape; })
+      .set_body(cinn::frontend::pass::FuseMulAdd);
+
+  CINN_REGISTER_REWRITE_RULE(fold_conv_batchnorm)
+      .set_pattern(Op("bn",
+                      "batchnorm",
+                      {Op("conv", "conv2d", {Var("x"), Var("w")}, AttrEquals("data_format", "NCHW")),
+                       Var("scale"),
+                       Var("bias"),
+                       Var("mean"),
+                       Var("variance")},
+                      AttrEquals("data_layout", "NCHW")))
+      .set_body(cinn::frontend::pass::FoldConvBatchNorm);
+
+  CINN_REGISTER_REWRITE_RULE(fold_scale_chain)
+      .set_pattern(Op("outer", "scale", {Op("inner", "scale", {Var("x")})}))
+      .set_body(cinn::frontend::pass::FoldScaleChain);
+
+  CINN_REGISTER_REWRITE_RULE(fold_transpose_pair)
+      .set_pattern(Op("outer", "transpose", {Op("inner", "transpose", {Var("x")})}))
+      .set_body(cinn::frontend::pass::FoldTransposePair);
+
+  return true;
+}
@@ -17,4 +17,6 @@
 #include "cinn/common/macros.h"
 
 CINN_USE_REGISTER(Decomposer)
+CINN_USE_REGISTER(PatternRewrite)
 CINN_USE_REGISTER(RemoveIdentity)
+CINN_USE_REGISTER(rewrite_rules)
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/segment_executor.h"
+
+#include <utility>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+void SegmentExecutor::Build(std::vector<ModelSegment> segments, const std::vector<std::string>& graph_passes) {
+  segments_ = std::move(segments);
+  graph_compilers_.clear();
+  runtime_programs_.clear();
+
+  for (auto& segment : segments_) {
+    if (segment.is_fallback) {
+      for (auto& op_desc : segment.fallback_ops) {
+        CHECK(FallbackKernelRegistry::Global()->Find(op_desc.Type()))
+            << "Op [" << op_desc.Type() << "] has no fallback kernel";
+      }
+      runtime_programs_.emplace_back(nullptr);
+      continue;
+    }
+
+    auto graph = std::make_shared<hlir::framework::Graph>(segment.program, target_);
+    for (auto& pass : graph_passes) {
+      hlir::framework::ApplyPass(graph.get(), pass);
+    }
+    hlir::framework::ApplyPass(graph.get(), "OpFusion");
+    scope_ = hlir::framework::BuildScope(target_, graph, scope_);
+
+    graph_compilers_.emplace_back(new hlir::framework::GraphCompiler(target_, scope_, graph));
+    hlir::framework::GraphCompiler::CompileOptions options;
+    options.with_instantiate_variables = true;
+    auto fetch_ids                     = segment.fetch_ids;
+    runtime_programs_.emplace_back(graph_compilers_.back()->Build(options, std::move(fetch_ids)).runtime_program);
+    runtime_programs_.back()->PreRun();
+  }
+}
+
+void SegmentExecutor::Run() {
+  FallbackContext ctx(scope_.get(), target_);
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    if (runtime_programs_[i]) {
+      runtime_programs_[i]->Execute();
+      continue;
+    }
+    for (auto& op_desc : segments_[i].fallback_ops) {
+      VLOG(4) << "Running fallback Op " << op_desc.Type();
+      FallbackKernelRegistry::Global()->Find(op_desc.Type())->Run(op_desc, ctx);
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,65 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/paddle_model_convertor.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * The executor for the segments of a partitioned model. The CINN programs are compiled into runtime programs, and
+ * run in order with the fallback kernels. All the segments share the scope of the PaddleModelConvertor, so the
+ * tensors are handed between the segments without copy.
+ */
+class SegmentExecutor final {
+ public:
+  SegmentExecutor(const Target& target, std::shared_ptr<hlir::framework::Scope> scope)
+      : target_(target), scope_(std::move(scope)) {
+    CHECK(scope_);
+  }
+
+  /**
+   * Compile the programs of the segments.
+   * @param segments The segments returned by PaddleModelConvertor::Partition.
+   * @param graph_passes The graph passes applied on each program before OpFusion.
+   */
+  void Build(std::vector<ModelSegment> segments, const std::vector<std::string>& graph_passes = {});
+
+  /**
+   * Run the segments in order.
+   */
+  void Run();
+
+  std::shared_ptr<hlir::framework::Scope> scope() { return scope_; }
+
+ private:
+  Target target_;
+  std::shared_ptr<hlir::framework::Scope> scope_;
+
+  std::vector<ModelSegment> segments_;
+  std::vector<std::unique_ptr<hlir::framework::GraphCompiler>> graph_compilers_;
+  // the runtime program of each segment, nullptr for the fallback segments
+  std::vector<std::unique_ptr<hlir::framework::Program>> runtime_programs_;
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -19,6 +19,7 @@ namespace hlir {
 namespace framework {
 
 void Buffer::Resize(uint32_t size) {
+  CHECK(!base_) << "A buffer view can't be resized";
   if (size_ > 0) {
     Free();
     size_ = 0;
@@ -32,6 +33,7 @@ void Buffer::Resize(uint32_t size) {
 }
 
 void Buffer::Resize(uint32_t alignment, uint32_t size) {
+  CHECK(!base_) << "A buffer view can't be resized";
   if (size_ > 0) {
     Free();
     size_ = 0;
@@ -49,6 +51,25 @@ void Buffer::SetTarget(const common::Target& target) {
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
 }
 
+void Buffer::ShareWith(const std::shared_ptr<Buffer>& base, uint32_t offset, uint32_t size) {
+  CHECK(base);
+  CHECK(base.get() != this) << "A buffer can't be a view of itself";
+  Free();
+  // flatten the view of a view so that every view refers to the buffer owning memory
+  if (base->base_) {
+    base_   = base->base_;
+    offset_ = base->offset_ + offset;
+  } else {
+    base_   = base;
+    offset_ = offset;
+  }
+  target_           = base_->target_;
+  memory_mng_cache_ = base_->memory_mng_cache_;
+  size_             = size;
+  data_.memory_size = size;
+  data();
+}
+
 void Buffer::ResizeLazy(uint32_t size) {
   if (size <= size_) return;
   Resize(size);
@@ -53,12 +53,28 @@ struct Buffer final {
 
   void SetTarget(const common::Target& target);
 
+  /**
+   * Make this buffer a view of \p size bytes on the memory of \p base starting at \p offset bytes. A view owns no
+   * memory, it always follows the memory held by its base and can't be resized beyond \p size.
+   */
+  void ShareWith(const std::shared_ptr<Buffer>& base, uint32_t offset, uint32_t size);
+
+  //! Whether this buffer is a view of another buffer.
+  bool is_view() const { return base_ != nullptr; }
+
   const cinn_buffer_t* data() const { return &data_; }
-  cinn_buffer_t* data() { return &data_; }
+  cinn_buffer_t* data() {
+    if (base_) {
+      // the base may allocate its memory after the view created
+      auto* base_memory = base_->data()->memory;
+      data_.memory      = base_memory ? base_memory + offset_ : nullptr;
+    }
+    return &data_;
+  }
 
   //! Free all the memory owned by this buffer.
   void Free() {
-    if (!data_.memory) return;
+    if (!data_.memory || base_) return;
     memory_mng_cache_->free(data_.memory);
   }
 
@@ -84,6 +100,12 @@ struct Buffer final {
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! The buffer this view shares memory with, null if this buffer owns its memory.
+  std::shared_ptr<Buffer> base_;
+
+  //! Offset in bytes of this view from the beginning of the base memory.
+  uint32_t offset_{};
 };
 
 }  // namespace framework
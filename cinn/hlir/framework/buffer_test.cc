@@ -18,6 +18,7 @@
 #endif
 #include <gtest/gtest.h>
 
+#include <memory>
 #include <vector>
 
 namespace cinn {
@@ -31,6 +32,28 @@ TEST(Buffer, basic) {
   for (int i = 0; i < 10; i++) data[i] = i;
 }
 
+TEST(Buffer, view) {
+  auto base = std::make_shared<Buffer>(common::DefaultHostTarget());
+  Buffer view;
+  view.ShareWith(base, 4 * sizeof(float), 4 * sizeof(float));
+  ASSERT_TRUE(view.is_view());
+  // the view follows the memory allocated by its base later
+  base->Resize(10 * sizeof(float));
+  auto* data = reinterpret_cast<float*>(base->data()->memory);
+  for (int i = 0; i < 10; i++) data[i] = i;
+  auto* view_data = reinterpret_cast<float*>(view.data()->memory);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(view_data[i], i + 4);
+  }
+
+  // a view of a view refers to the buffer owning memory
+  auto view_ptr = std::make_shared<Buffer>();
+  view_ptr->ShareWith(base, 4 * sizeof(float), 4 * sizeof(float));
+  Buffer sub_view;
+  sub_view.ShareWith(view_ptr, 2 * sizeof(float), 2 * sizeof(float));
+  ASSERT_EQ(reinterpret_cast<float*>(sub_view.data()->memory)[0], 6);
+}
+
 #ifdef CINN_WITH_CUDA
 TEST(Buffer, nvgpu) {
   const int num_elements = 10;
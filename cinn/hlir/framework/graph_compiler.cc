@@ -14,7 +14,10 @@
 
 #include "cinn/hlir/framework/graph_compiler.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -23,6 +26,7 @@
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/poly/stage.h"
 
 namespace cinn {
@@ -64,16 +68,28 @@ Program::Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_pt
 }
 
 void Program::PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  flattened_ = false;
   for (auto& ins : prerun_instrs_) {
     ins->Run(name2podargs);
   }
   for (auto& ins : instrs_) {
     if (ins->size() == 4) {
       ins->PreRun(name2podargs);
+      // the entry still calls the kernels removed from the instruction
+      if (entry_fn_) {
+        VLOG(3) << "Drop the program entry since PreRun changes the instruction " << ins->function_name();
+        entry_fn_ = nullptr;
+      }
     }
   }
 }
 
+void Program::SetEntry(lower_func_ptr_t fn, const std::vector<std::string>& arg_names) {
+  entry_fn_        = fn;
+  entry_arg_names_ = arg_names;
+  flattened_       = false;
+}
+
 void Program::Export(const std::vector<std::string>& persistent_vars, const std::string& filename) {
   auto writeplaceholder = [=](int s, int n, FILE* f) -> int {
     int pos = ftell(f);
@@ -100,9 +116,10 @@ void Program::Export(const std::vector<std::string>& persistent_vars, const std:
     }
   };
   auto varnames = scope_->var_names();
-  std::unordered_map<std::string, int> varindex;
+  // the index of each variable in the exported buffers, by its slot in the scope
+  std::vector<int> varindex(scope_->num_slots(), -1);
   for (int i = 0; i < varnames.size(); i++) {
-    varindex[(std::string)varnames[i]] = i;
+    varindex[scope_->FindSlot(std::string(varnames[i]))] = i;
   }
 
   FILE* f = fopen(filename.c_str(), "w+");
@@ -186,7 +203,9 @@ void Program::Export(const std::vector<std::string>& persistent_vars, const std:
       padding(alignof(cinn_pod_value_t), 0, f);
       tellplaceholder(instplaceholder + findex * 12 + 8, f);
       for (auto& arg : all_args) {
-        uintptr_t bufindex = varindex[arg];
+        int slot = scope_->FindSlot(arg);
+        CHECK_GE(slot, 0) << "Argument [" << arg << "] not found in the scope";
+        uintptr_t bufindex = varindex[slot];
         cinn_pod_value_t v((cinn_buffer_t*)bufindex);
         fwrite(&v, sizeof(cinn_pod_value_t), 1, f);
       }
@@ -197,9 +216,41 @@ void Program::Export(const std::vector<std::string>& persistent_vars, const std:
   fclose(f);
 }
 
-void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream) {
+void Program::Flatten() {
+  kernel_calls_.clear();
+  entry_args_.clear();
+  if (entry_fn_) {
+    for (auto& name : entry_arg_names_) {
+      entry_args_.emplace_back(scope_->GetTensor(name)->buffer());
+    }
+    flattened_ = true;
+    VLOG(3) << "Run " << instrs_.size() << " instructions by the entry with " << entry_args_.size() << " arguments";
+    return;
+  }
   for (auto& ins : instrs_) {
-    ins->Run(name2podargs, false, stream);
+    ins->Flatten(&kernel_calls_);
+  }
+  flattened_ = true;
+  VLOG(3) << "Flatten " << instrs_.size() << " instructions into " << kernel_calls_.size() << " kernel calls";
+}
+
+void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream) {
+  if (name2podargs == nullptr) {
+    if (!flattened_) Flatten();
+    if (entry_fn_) entry_fn_(entry_args_.data(), entry_args_.size());
+    for (auto& call : kernel_calls_) {
+      if (call.fn) {
+        call.fn(call.args, call.num_args);
+      } else {
+        call.instr->Run(nullptr, false, stream);
+      }
+    }
+  } else {
+    // the instructions prepare their arguments from name2podargs again, which invalidates the flattened ones
+    flattened_ = false;
+    for (auto& ins : instrs_) {
+      ins->Run(name2podargs, false, stream);
+    }
   }
 #ifdef CINN_WITH_CUDA
   VLOG(4) << "-- The value of the used stream: " << stream;
@@ -287,7 +338,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
     std::string input_id = i->source()->as<NodeData>()->id();
     auto in_shape        = shape_dict.at(input_id);
     Type dtype           = dtype_dict.at(input_id);
-    CHECK(dtype == Float(32) || dtype.is_bool() || dtype == Int(32))
+    CHECK(dtype == Float(32) || dtype.is_bool() || dtype == Int(32) || dtype == Int(64))
         << "The dtype of node " << input_id << " is not float or bool or int! Other dtype is not implemented yet.";
     ir::Tensor temp;
     if (dtype == Float(32)) {
@@ -296,6 +347,8 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const Node* node) {
       temp = lang::Placeholder<bool>(input_id, in_shape);
     } else if (dtype == Int(32)) {
       temp = lang::Placeholder<int>(input_id, in_shape);
+    } else if (dtype == Int(64)) {
+      temp = lang::Placeholder<int64_t>(input_id, in_shape);
     }
     inputs.push_back(temp);
     cinn_inputs.push_back(common::CINNValue(temp));
@@ -388,7 +441,7 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
         std::string input_id = source_data->id();
         auto in_shape        = shape_dict.at(input_id);
         Type dtype           = dtype_dict.at(input_id);
-        CHECK(dtype == Float(32) || dtype.is_bool() || dtype == Int(32))
+        CHECK(dtype == Float(32) || dtype.is_bool() || dtype == Int(32) || dtype == Int(64))
             << "The dtype of node " << input_id << " is not float or bool or int! Other dtype is not implemented yet.";
         ir::Tensor temp_in;
         if (dtype == Float(32)) {
@@ -397,6 +450,8 @@ std::vector<ir::LoweredFunc> GraphCompiler::GetOpFunc(const std::vector<Node*>&
           temp_in = lang::Placeholder<bool>(input_id, in_shape);
         } else if (dtype == Int(32)) {
           temp_in = lang::Placeholder<int>(input_id, in_shape);
+        } else if (dtype == Int(64)) {
+          temp_in = lang::Placeholder<int64_t>(input_id, in_shape);
         }
         inputs.push_back(temp_in);
         temp_inputs.push_back(temp_in);
@@ -582,9 +637,13 @@ void GraphCompiler::ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_
       }
       function2input_args_[i->name]  = input_args;
       function2output_args_[i->name] = output_args;
+      function2cost_[i->name]        = ir::EstimateKernelCost(i);
+      function2lowered_[i->name]     = i;
       m_builder_.AddFunction(i);
     }
   } else {
+    function2cost_[lowered_func[0]->name]    = ir::EstimateKernelCost(lowered_func[0]);
+    function2lowered_[lowered_func[0]->name] = lowered_func[0];
     m_builder_.AddFunction(lowered_func[0]);
   }
 }
@@ -646,25 +705,39 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   }
 
   compiler_->Build(build_module, options.attached_code, stream);
+  AnalyzeBufferAlias();
   auto instructions = BuildInstructions();
   RemoveInvalidVariables(instructions);
+  if (options.with_inplace_reuse) {
+    AnalyzeInplaceReuse(instructions);
+  }
   if (options.with_buffer_handle_instruction_inserted) {
     VLOG(3) << "option.with_buffer_handle_instruction_inserted enable";
+    if (options.remat_memory_budget >= 0) {
+      Rematerialize(&instructions, options.remat_memory_budget);
+    }
     InsertBufferHandlers(&instructions);
   }
+  auto aliased_vars = ApplyBufferAlias();
+  for (auto& instr : instructions) {
+    for (auto& fn_name : instr->GetFnNames()) {
+      auto it = function2cost_.find(fn_name);
+      if (it != function2cost_.end()) instr->cost += it->second;
+    }
+  }
 
   if (options.with_instantiate_variables) {
     VLOG(3) << "Initantiate all variables on compile-time";
+    auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
     // All variables reside in scope_, so traverse it to instantiate each one
     for (auto& name : scope_->var_names()) {
+      // the aliased variables follow the buffers of their sources
+      if (aliased_vars.count(std::string({name.data(), name.size()}))) continue;
       auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
       auto& tensor = absl::get<Tensor>(*var);
-      if (reuse_vars_map_.count(name)) {
-        auto src_var_name = reuse_vars_map_.at(name);
-        auto* src_var     = scope_->Var<Tensor>(src_var_name);
-        auto& src_tensor  = absl::get<Tensor>(*src_var);
-        VLOG(3) << name << " shares buffer with " << src_var_name;
-        tensor->set_buffer(src_tensor->get_buffer());
+      auto it      = dtype_dict.find(std::string({name.data(), name.size()}));
+      if (it != dtype_dict.end() && it->second.is_int(64)) {
+        tensor->mutable_data<int64_t>(target_);
       } else {
         tensor->mutable_data<float>(target_);
       }
@@ -673,9 +746,83 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
 
   GraphCompiler::CompilationResult result;
   result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+  if (options.with_program_entry) {
+    BuildProgramEntry(result.runtime_program.get());
+  }
   return result;
 }
 
+void GraphCompiler::BuildProgramEntry(Program* program) {
+  if (target_.arch != Target::Arch::X86 || compile_options_.with_buffer_handle_instruction_inserted) {
+    LOG(WARNING) << "The program entry is only supported on X86 without the buffer handle instructions, skip it";
+    return;
+  }
+  ir::Module::Builder builder(UniqName("entry_module"), target_);
+  std::unordered_set<std::string> linked_funcs;
+  // each variable is passed to the entry by one buffer argument, in the order it is firstly used
+  std::vector<ir::Argument> entry_args;
+  std::vector<std::string> entry_arg_names;
+  absl::flat_hash_map<std::string, int> var2entry_arg;
+  std::vector<Expr> kernel_calls;
+  for (auto& instr : program->GetRunInstructions()) {
+    if (instr->function_name() == "no_run" || instr->zero_copy) continue;
+    auto in_args  = instr->GetInArgs();
+    auto out_args = instr->GetOutArgs();
+    auto fn_names = instr->GetFnNames();
+    for (int i = 0; i < fn_names.size(); i++) {
+      auto it = function2lowered_.find(fn_names[i]);
+      if (it == function2lowered_.end()) {
+        LOG(WARNING) << "The function " << fn_names[i] << " is not lowered by the graph compiler, skip the entry";
+        return;
+      }
+      auto& func = it->second;
+      std::vector<std::string> all_args(in_args[i].begin(), in_args[i].end());
+      all_args.insert(std::end(all_args), out_args[i].begin(), out_args[i].end());
+      CHECK_EQ(all_args.size(), func->args.size()) << "The arguments of the function " << fn_names[i] << " mismatch";
+
+      // the arguments are packed in the same order as the instruction prepares them
+      std::vector<Expr> read_args;
+      std::vector<Expr> write_args;
+      for (int j = 0; j < all_args.size(); j++) {
+        CHECK(func->args[j].is_buffer()) << "The function " << fn_names[i] << " has a non-buffer argument";
+        auto arg_it = var2entry_arg.find(all_args[j]);
+        if (arg_it == var2entry_arg.end()) {
+          // the buffer names of the kernels may differ from the variable names, so name the buffers of the entry anew
+          auto buffer  = optim::IRCopy(Expr(func->args[j].buffer_arg())).as_buffer_ref();
+          buffer->name = "_entry_arg_" + std::to_string(entry_args.size());
+          arg_it       = var2entry_arg.emplace(all_args[j], entry_args.size()).first;
+          entry_args.emplace_back(buffer, ir::Argument::IO::kInput);
+          entry_arg_names.push_back(all_args[j]);
+        }
+        auto& entry_arg = entry_args[arg_it->second];
+        if (j < in_args[i].size()) {
+          read_args.push_back(Expr(entry_arg.buffer_arg()));
+        } else {
+          entry_arg.io = ir::Argument::IO::kOutput;
+          write_args.push_back(Expr(entry_arg.buffer_arg()));
+        }
+      }
+      kernel_calls.push_back(
+          ir::Call::Make(Void(), fn_names[i], read_args, write_args, ir::CallType::CINN, ir::FunctionRef(), 0));
+      if (linked_funcs.insert(fn_names[i]).second) {
+        builder.AddFunction(func);
+      }
+    }
+  }
+  if (kernel_calls.empty()) return;
+
+  // the kernels are defined before the entry, so the calls can find them in the module
+  auto& entry_name = GetOrGenFullFuncName("fn_program_entry");
+  builder.AddFunction(ir::_LoweredFunc_::Make(entry_name, entry_args, ir::Block::Make(kernel_calls), {}));
+  entry_compiler_ = backends::Compiler::Create(target_);
+  entry_compiler_->Build(builder.Build());
+  auto* entry_fn = entry_compiler_->Lookup(entry_name);
+  CHECK(entry_fn) << "The program entry " << entry_name << " is not found after compiled";
+  program->SetEntry(entry_fn, entry_arg_names);
+  VLOG(3) << "Build the program entry " << entry_name << " calling " << kernel_calls.size() << " kernels with "
+          << entry_args.size() << " arguments";
+}
+
 void GraphCompiler::SetSubKernels(Instruction* instr, const std::string& func_name) {
   int i                   = 1;
   std::string new_op_func = func_name + "_" + std::to_string(i);
@@ -706,19 +853,9 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
     if (group.size() == 1) {
       auto node       = group[0];
       auto instr_name = node->op()->name;
-      if (node->op()->name == "reshape" && compile_options_.with_instantiate_variables) {
-        // not run instruction and shares buffer only when instantiate_variables
-        auto& inlinks  = node->inlinks_in_order();
-        auto& outlinks = node->outlinks_in_order();
-        CHECK_EQ(inlinks.size(), 1U);
-        CHECK_EQ(outlinks.size(), 1U);
-        std::string in_id       = inlinks[0]->source()->safe_as<NodeData>()->id();
-        std::string out_id      = outlinks[0]->sink()->safe_as<NodeData>()->id();
-        reuse_vars_map_[out_id] = in_id;
-        instr_name              = "no_run";
-      }
-      auto instr = std::unique_ptr<Instruction>(
+      auto instr      = std::unique_ptr<Instruction>(
           new Instruction(target_, scope_.get(), OpGetInputNames(node), OpGetOutputNames(node), instr_name));
+      instr->zero_copy = zero_copy_nodes_.count(node->id());
 
       if (target_.arch == Target::Arch::NVGPU) {
         if (node->op()->name == "conv2d") {
@@ -833,7 +970,13 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
             auto in_shape     = shape_dict.at(in_id);
             instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
           }
-          AddAttrs(node->attrs.attr_store, {"axis"}, instr.get());
+          auto& attr_store = node->attrs.attr_store;
+          int axis         = attr_store.count("axis") ? absl::get<int>(attr_store.at("axis")) : -1;
+          bool use_log     = attr_store.count("use_log") ? absl::get<bool>(attr_store.at("use_log")) : false;
+          CHECK(!attr_store.count("scale") || absl::get<float>(attr_store.at("scale")) == 1.f)
+              << "The cudnn softmax doesn't support scaling the input! Please check.";
+          instr->attrs.push_back(axis);
+          instr->attrs.push_back(use_log);
         } else if (node->op()->name == "mul") {
           auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
           for (auto& in_node : node->inlinks_in_order()) {
@@ -996,12 +1139,20 @@ static void BufferFreeWithCallback(void* args, int num_args) {
 void GraphCompiler::AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions,
                                             std::unordered_map<int, std::vector<std::string>>* step2malloc,
                                             std::unordered_map<int, std::vector<std::string>>* step2free) {
+  // the variable owning the buffer a variable uses
+  auto get_buffer_source = [this](std::string var_name) {
+    while (reuse_vars_map_.count(var_name) || view_vars_map_.count(var_name)) {
+      var_name = reuse_vars_map_.count(var_name) ? reuse_vars_map_.at(var_name) : view_vars_map_.at(var_name).first;
+    }
+    return var_name;
+  };
   absl::flat_hash_map<std::string, int> variable_last_used, variable_first_used;
   for (auto step = 0; step < instructions.size(); ++step) {
     const auto& instr = instructions.at(step);
 
     for (const auto& args : instr->GetInArgs()) {
-      for (const auto& var_name : args) {
+      for (const auto& arg : args) {
+        auto var_name = get_buffer_source(arg);
         // use try_emplace to record the first time a variable appearance
         variable_first_used.try_emplace(var_name, step);
         // will update until last time a variable used
@@ -1009,7 +1160,8 @@ void GraphCompiler::AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<In
       }
     }
     for (const auto& args : instr->GetOutArgs()) {
-      for (const auto& var_name : args) {
+      for (const auto& arg : args) {
+        auto var_name = get_buffer_source(arg);
         variable_first_used.try_emplace(var_name, step);
         variable_last_used[var_name] = step;
       }
@@ -1066,6 +1218,149 @@ void GraphCompiler::InsertBufferHandlers(std::vector<std::unique_ptr<Instruction
   instructions->swap(results);
 }
 
+namespace {
+// Get the offset(in elements) of the slice in its input if the sliced region is contiguous in memory, or -1.
+int64_t GetContiguousSliceOffset(const Node* node, const shape_t& in_shape, const shape_t& out_shape) {
+  auto& attr_store = node->attrs.attr_store;
+  if (!attr_store.count("starts") || in_shape.size() != out_shape.size()) return -1;
+  auto starts = absl::get<std::vector<int>>(attr_store.at("starts"));
+  std::vector<int> axes;
+  if (attr_store.count("axes")) {
+    axes = absl::get<std::vector<int>>(attr_store.at("axes"));
+  } else {
+    for (int i = 0; i < starts.size(); i++) {
+      axes.push_back(i);
+    }
+  }
+  CHECK_EQ(starts.size(), axes.size());
+  std::vector<int> begins(in_shape.size(), 0);
+  for (int i = 0; i < axes.size(); i++) {
+    int begin = starts[i] < 0 ? starts[i] + in_shape[axes[i]] : starts[i];
+    begins[axes[i]] = std::min(std::max(begin, 0), in_shape[axes[i]]);
+  }
+  // the region is contiguous only if the axes before the last sliced one keep one element
+  int last_sliced = -1;
+  for (int i = 0; i < in_shape.size(); i++) {
+    if (out_shape[i] != in_shape[i]) last_sliced = i;
+  }
+  int64_t offset = 0;
+  int64_t stride = 1;
+  for (int i = in_shape.size() - 1; i >= 0; i--) {
+    if (i < last_sliced && out_shape[i] != 1) return -1;
+    offset += begins[i] * stride;
+    stride *= in_shape[i];
+  }
+  return offset;
+}
+
+int GetBytesOfType(const Type& type) { return (type.bits() + 7) / 8; }
+}  // namespace
+
+void GraphCompiler::AnalyzeBufferAlias() {
+  auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto is_aliased  = [this](const std::string& var) { return reuse_vars_map_.count(var) || view_vars_map_.count(var); };
+  auto numel       = [](const shape_t& shape) {
+    return std::accumulate(shape.begin(), shape.end(), int64_t(1), std::multiplies<int64_t>());
+  };
+
+  // a view holds its own cinn_buffer_t whose memory follows the base only when the instructions prepare their
+  // arguments, while the buffer handle instructions malloc and free the memory of the base on every run, so only
+  // the reshape outputs sharing the whole buffers of their inputs are aliased then
+  bool with_views = !compile_options_.with_buffer_handle_instruction_inserted;
+
+  // only the ops not fused with others have their inputs and outputs reside in the scope
+  std::vector<Node*> single_nodes;
+  for (auto& group : graph_->groups) {
+    if (group.size() == 1) single_nodes.push_back(group[0]);
+  }
+
+  for (auto* node : single_nodes) {
+    auto& op_name = node->op()->name;
+    if (op_name != "reshape" && op_name != "slice") continue;
+    auto in_ids  = OpGetInputNames(node);
+    auto out_ids = OpGetOutputNames(node);
+    CHECK_EQ(in_ids.size(), 1U);
+    CHECK_EQ(out_ids.size(), 1U);
+    if (op_name == "reshape") {
+      reuse_vars_map_[out_ids[0]] = in_ids[0];
+    } else {
+      if (!with_views) continue;
+      auto offset = GetContiguousSliceOffset(node, shape_dict.at(in_ids[0]), shape_dict.at(out_ids[0]));
+      if (offset < 0) continue;
+      view_vars_map_[out_ids[0]] = {in_ids[0], offset * GetBytesOfType(dtype_dict.at(in_ids[0]))};
+    }
+    VLOG(3) << "The output of " << node->id() << " aliases the buffer of " << in_ids[0];
+    zero_copy_nodes_.insert(node->id());
+  }
+
+  // concat in place: the producers write their outputs into the sub-regions of the concat output directly
+  for (auto* node : single_nodes) {
+    if (!with_views || node->op()->name != "concat") continue;
+    auto in_ids  = OpGetInputNames(node);
+    auto out_ids = OpGetOutputNames(node);
+    CHECK_EQ(out_ids.size(), 1U);
+    auto& out_shape = shape_dict.at(out_ids[0]);
+    int axis        = node->attrs.attr_store.count("axis") ? absl::get<int>(node->attrs.attr_store.at("axis")) : 0;
+    if (axis < 0) axis += out_shape.size();
+    // every input occupies a contiguous region only if the axes before the concat axis keep one element
+    bool can_inplace = std::all_of(out_shape.begin(), out_shape.begin() + axis, [](int dim) { return dim == 1; });
+    std::unordered_set<std::string> visited;
+    for (auto& in_id : in_ids) {
+      auto* graph_node = graph_->RetrieveNode(in_id);
+      auto* in_node    = graph_node ? graph_node->safe_as<NodeData>() : nullptr;
+      // graph inputs are fed by users and only the outputs of op nodes can be redirected
+      can_inplace = can_inplace && in_node && in_node->source_node.get() && !is_aliased(in_id) &&
+                    visited.insert(in_id).second && dtype_dict.at(in_id) == dtype_dict.at(out_ids[0]);
+    }
+    if (!can_inplace) continue;
+    int64_t offset = 0;
+    for (auto& in_id : in_ids) {
+      view_vars_map_[in_id] = {out_ids[0], offset * GetBytesOfType(dtype_dict.at(in_id))};
+      offset += numel(shape_dict.at(in_id));
+    }
+    VLOG(3) << "Concat " << node->id() << " in place on the buffer of " << out_ids[0];
+    zero_copy_nodes_.insert(node->id());
+  }
+}
+
+std::unordered_set<std::string> GraphCompiler::ApplyBufferAlias() {
+  auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  std::unordered_set<std::string> aliased_vars;
+  // the source of an alias may be aliased too, so resolve it before the ones depending on it
+  std::function<void(const std::string&)> resolve = [&](const std::string& name) {
+    if (aliased_vars.count(name) || !scope_->FindVar(name)) return;
+    auto& tensor = absl::get<Tensor>(*scope_->FindVar(name));
+    if (reuse_vars_map_.count(name)) {
+      auto& src_name = reuse_vars_map_.at(name);
+      CHECK(scope_->FindVar(src_name)) << "The buffer source " << src_name << " of " << name << " is not in the scope";
+      resolve(src_name);
+      VLOG(3) << name << " shares buffer with " << src_name;
+      tensor->set_buffer(scope_->GetTensor(src_name)->get_buffer());
+    } else if (view_vars_map_.count(name)) {
+      auto& src_name = view_vars_map_.at(name).first;
+      auto offset    = view_vars_map_.at(name).second;
+      CHECK(scope_->FindVar(src_name)) << "The buffer source " << src_name << " of " << name << " is not in the scope";
+      resolve(src_name);
+      VLOG(3) << name << " is a view of " << src_name << " at offset " << offset;
+      auto view = std::make_shared<Buffer>();
+      view->ShareWith(scope_->GetTensor(src_name)->get_buffer(),
+                      offset,
+                      tensor->shape().numel() * GetBytesOfType(dtype_dict.at(name)));
+      tensor->set_buffer(view);
+      tensor->Resize(tensor->shape());
+    } else {
+      return;
+    }
+    aliased_vars.insert(name);
+  };
+
+  for (auto& name : scope_->var_names()) {
+    resolve(std::string({name.data(), name.size()}));
+  }
+  return aliased_vars;
+}
+
 std::vector<std::string> GraphCompiler::OpGetInputNames(const Node* node) const {
   std::vector<std::string> res;
   for (auto& i : node->inlinks_in_order()) {
@@ -1082,6 +1377,206 @@ std::vector<std::string> GraphCompiler::OpGetOutputNames(const Node* node) const
   return res;
 }
 
+void GraphCompiler::AnalyzeInplaceReuse(const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& shape_dict      = graph_->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict      = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& groups          = graph_->groups;
+  CHECK_EQ(groups.size(), instructions.size());
+
+  // the instructions producing and using the variables for the last time
+  absl::flat_hash_map<std::string, int> var_producer, var_last_used;
+  for (int step = 0; step < instructions.size(); ++step) {
+    for (auto& args : instructions[step]->GetInArgs()) {
+      for (auto& var : args) var_last_used[var] = step;
+    }
+    for (auto& args : instructions[step]->GetOutArgs()) {
+      for (auto& var : args) {
+        var_producer.try_emplace(var, step);
+        var_last_used[var] = step;
+      }
+    }
+  }
+  // the variable owning the buffer shared by a chain of reuses
+  auto get_reuse_source = [this](std::string var) {
+    while (reuse_vars_map_.count(var)) var = reuse_vars_map_.at(var);
+    return var;
+  };
+  auto is_view = [this](const std::string& var) {
+    return view_vars_map_.count(var) ||
+           std::any_of(view_vars_map_.begin(), view_vars_map_.end(), [&](auto& it) { return it.second.first == var; });
+  };
+  // the buffer of a variable can be overwritten at the step if none of the variables sharing it is fetched or used
+  // after the step, and it is allocated by an instruction running on every execution rather than fed by users or
+  // computed once by PreRun
+  auto can_overwrite = [&](const std::string& var, int step) {
+    auto source = get_reuse_source(var);
+    if (!var_producer.count(source) || instructions[var_producer.at(source)]->pre_run) return false;
+    for (auto& it : var_last_used) {
+      if (get_reuse_source(it.first) != source) continue;
+      if (it.second > step || fetch_var_ids_.count(it.first) || is_view(it.first)) return false;
+    }
+    return true;
+  };
+
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto& instr = instructions[step];
+    // every element of the output only reads the elements at the same position of the inputs of the same shape
+    bool elementwise = std::all_of(groups[step].begin(), groups[step].end(), [&](Node* node) {
+      return op_pattern_dict.Find(node->op()) && op_pattern_dict[node->op()] <= kBroadcast;
+    });
+    if (!elementwise || instr->size() != 1 || instr->pre_run || instr->zero_copy) continue;
+    auto out_args = instr->GetOutArgs().front();
+    if (out_args.size() != 1 || reuse_vars_map_.count(out_args[0]) || is_view(out_args[0])) continue;
+    auto& out = out_args[0];
+
+    for (auto& in : instr->GetInArgs().front()) {
+      if (shape_dict.at(in) != shape_dict.at(out) || dtype_dict.at(in) != dtype_dict.at(out)) continue;
+      if (!can_overwrite(in, step)) continue;
+      VLOG(3) << "The instruction " << instr->GetFnNames().front() << " writes " << out << " in place of " << in;
+      reuse_vars_map_[out] = in;
+      break;
+    }
+  }
+}
+
+int64_t GraphCompiler::EstimatePeakMemory(const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto get_bytes   = [&](const std::string& name) -> int64_t {
+    // the aliased variables share the buffers of others
+    if (reuse_vars_map_.count(name) || view_vars_map_.count(name) || !scope_->FindVar(name)) return 0;
+    auto& src_name = remat_vars_map_.count(name) ? remat_vars_map_.at(name) : name;
+    auto type      = dtype_dict.count(src_name) ? dtype_dict.at(src_name) : Float(32);
+    return scope_->GetTensor(name)->shape().numel() * GetBytesOfType(type);
+  };
+
+  std::unordered_map<int, std::vector<std::string>> step2malloc, step2free;
+  AnalyzeVariableLifeTime(instructions, &step2malloc, &step2free);
+  int64_t peak = 0, used = 0;
+  for (int step = 0; step < instructions.size(); ++step) {
+    for (auto& name : step2malloc[step]) used += get_bytes(name);
+    peak = std::max(peak, used);
+    for (auto& name : step2free[step]) used -= get_bytes(name);
+  }
+  return peak;
+}
+
+void GraphCompiler::Rematerialize(std::vector<std::unique_ptr<Instruction>>* instructions, int64_t budget) {
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  auto& groups          = graph_->groups;
+  CHECK_EQ(groups.size(), instructions->size());
+  // the instructions cheap enough to run again
+  std::vector<bool> cheap;
+  for (auto& group : groups) {
+    cheap.push_back(std::all_of(group.begin(), group.end(), [&](Node* node) {
+      return (op_pattern_dict.Find(node->op()) && op_pattern_dict[node->op()] <= kBroadcast) ||
+             node->op()->name == "batchnorm";
+    }));
+  }
+  auto is_alias_source = [this](const std::string& var) {
+    return std::any_of(reuse_vars_map_.begin(), reuse_vars_map_.end(), [&](auto& it) { return it.second == var; }) ||
+           std::any_of(view_vars_map_.begin(), view_vars_map_.end(), [&](auto& it) { return it.second.first == var; });
+  };
+
+  int64_t peak = EstimatePeakMemory(*instructions);
+  VLOG(3) << "Peak memory before rematerialization: " << peak << " bytes, the budget is " << budget << " bytes";
+  std::unordered_set<std::string> visited;
+  while (peak > budget) {
+    absl::flat_hash_map<std::string, std::vector<int>> var_used_steps;
+    absl::flat_hash_map<std::string, int> var_last_used;
+    for (int step = 0; step < instructions->size(); ++step) {
+      auto& instr = instructions->at(step);
+      for (auto& args : instr->GetInArgs()) {
+        for (auto& var : args) {
+          var_used_steps[var].push_back(step);
+          var_last_used[var] = step;
+        }
+      }
+      for (auto& args : instr->GetOutArgs()) {
+        for (auto& var : args) var_last_used[var] = step;
+      }
+    }
+
+    // pick the output of a cheap instruction left unused for the longest time, whose inputs are alive at the late use
+    int best_step = -1, best_late_step = -1;
+    int64_t best_gain = 0;
+    std::string best_var;
+    for (int step = 0; step < instructions->size(); ++step) {
+      auto& instr = instructions->at(step);
+      if (!cheap[step] || instr->size() != 1 || instr->pre_run || instr->zero_copy) continue;
+      auto out_args = instr->GetOutArgs();
+      if (out_args.size() != 1 || out_args[0].size() != 1) continue;
+      auto& var = out_args[0][0];
+      if (visited.count(var) || fetch_var_ids_.count(var) || reuse_vars_map_.count(var) || view_vars_map_.count(var) ||
+          is_alias_source(var)) {
+        continue;
+      }
+
+      int prev_step = step, late_step = -1, gap = 1;
+      for (int used_step : var_used_steps[var]) {
+        if (used_step - prev_step > gap) {
+          gap       = used_step - prev_step;
+          late_step = used_step;
+        }
+        prev_step = used_step;
+      }
+      if (late_step < 0) continue;
+      auto in_args = instr->GetInArgs().front();
+      if (!std::all_of(in_args.begin(), in_args.end(), [&](auto& in) { return var_last_used[in] >= late_step; })) {
+        continue;
+      }
+      int64_t gain = scope_->GetTensor(var)->shape().numel() * gap;
+      if (gain > best_gain) {
+        best_step      = step;
+        best_late_step = late_step;
+        best_gain      = gain;
+        best_var       = var;
+      }
+    }
+    if (best_step < 0) break;
+    visited.insert(best_var);
+
+    // run the instruction again right before the late use, writing a new variable
+    auto& instr      = instructions->at(best_step);
+    auto remat_var   = UniqName(best_var + "_remat");
+    auto* var        = scope_->Var<Tensor>(remat_var);
+    auto fn_name     = instr->GetFnNames().front();
+    auto remat_instr = std::make_unique<Instruction>(
+        target_, scope_.get(), instr->GetInArgs().front(), std::vector<std::string>({remat_var}), fn_name);
+    auto* fn = compiler_->Lookup(fn_name);
+    CHECK(fn);
+    remat_instr->SetLoweredFunc(fn, fn_name);
+    remat_instr->attrs     = instr->attrs;
+    remat_instr->str_attrs = instr->str_attrs;
+    remat_instr->Finalize();
+    absl::get<Tensor>(*var)->Resize(scope_->GetTensor(best_var)->shape());
+    remat_vars_map_[remat_var] = best_var;
+
+    for (int step = best_late_step; step < instructions->size(); ++step) {
+      instructions->at(step)->ReplaceInArg(best_var, remat_var);
+    }
+    instructions->insert(instructions->begin() + best_late_step, std::move(remat_instr));
+    cheap.insert(cheap.begin() + best_late_step, false);
+
+    auto new_peak = EstimatePeakMemory(*instructions);
+    if (new_peak >= peak) {
+      // the peak is elsewhere, so undo it
+      instructions->erase(instructions->begin() + best_late_step);
+      cheap.erase(cheap.begin() + best_late_step);
+      for (int step = best_late_step; step < instructions->size(); ++step) {
+        instructions->at(step)->ReplaceInArg(remat_var, best_var);
+      }
+      remat_vars_map_.erase(remat_var);
+      scope_->EraseVar(remat_var);
+      continue;
+    }
+    VLOG(3) << "Recompute " << best_var << " as " << remat_var << " before the instruction " << best_late_step
+            << ", the peak memory is reduced to " << new_peak << " bytes";
+    peak = new_peak;
+  }
+  VLOG(3) << "Peak memory after rematerialization: " << peak << " bytes";
+}
+
 std::shared_ptr<Scope> BuildScope(Target target, const std::shared_ptr<Graph>& graph, std::shared_ptr<Scope> scope) {
   auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
   auto& dtype_dict = graph->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
@@ -1096,7 +1591,7 @@ std::shared_ptr<Scope> BuildScope(Target target, const std::shared_ptr<Graph>& g
     VLOG(3) << "Tensor [" << iter.first << "] resize to " << utils::Join(shape, ",");
     tensor->Resize(Shape{shape});
     CHECK(dtype_dict.at(iter.first) == Float(32) || dtype_dict.at(iter.first).is_bool() ||
-          dtype_dict.at(iter.first) == Int(32))
+          dtype_dict.at(iter.first) == Int(32) || dtype_dict.at(iter.first) == Int(64))
         << "The dtype of node " << iter.first << " is not float or bool or int! Other dtype is not implemented yet.";
   }
   return scope;
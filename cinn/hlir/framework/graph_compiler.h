@@ -30,6 +30,7 @@
 #include "cinn/hlir/framework/instruction.h"
 #include "cinn/hlir/framework/op_strategy.h"
 #include "cinn/hlir/framework/scope.h"
+#include "cinn/ir/kernel_cost.h"
 #include "cinn/ir/lowered_func.h"
 #include "cinn/lang/packed_func.h"
 #include "cinn/utils/timer.h"
@@ -69,13 +70,32 @@ class Program {
   const std::vector<std::unique_ptr<Instruction>>& GetPreRunInstructions() { return prerun_instrs_; }
   const std::vector<std::unique_ptr<Instruction>>& GetRunInstructions() { return instrs_; }
 
+  /**
+   * Set the function calling the kernels of all the instructions in order, which Execute calls once with the buffers
+   * of the variables \p arg_names in the scope instead of calling the kernels one by one when no arguments are passed
+   * in. It is dropped by PreRun if PreRun removes some kernels from the instructions.
+   */
+  void SetEntry(lower_func_ptr_t fn, const std::vector<std::string>& arg_names);
+
+  bool has_entry() const { return entry_fn_ != nullptr; }
+
  private:
+  // flatten the instructions into kernel_calls_, which Execute runs in a loop when no arguments are passed in
+  void Flatten();
+
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
   // prerun instructions
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+  // the functions of instrs_ with their prepared arguments, invalid once the arguments of the instructions change
+  std::vector<KernelCall> kernel_calls_;
+  bool flattened_{false};
+  // the entry calling all the kernels, with the names of the variables passed to it and their prepared arguments
+  lower_func_ptr_t entry_fn_{};
+  std::vector<std::string> entry_arg_names_;
+  std::vector<cinn_pod_value_t> entry_args_;
 };
 
 /**
@@ -94,6 +114,16 @@ class GraphCompiler final {
     std::string attached_code                    = "";
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
+    // the budget(in bytes) of the peak memory of the buffers handled by the inserted instructions, the cheap ops whose
+    // outputs are used again long after are recomputed right before the late uses to meet it, disabled if negative
+    int64_t remat_memory_budget = -1;
+    // let the elementwise instructions write their outputs in the buffers of the inputs of the same shapes
+    // used for the last time, except the graph inputs and the fetch vars
+    bool with_inplace_reuse = false;
+    // generate an entry function calling all the kernels in order, and compile it with the kernels in another module,
+    // so LLVM can inline the small kernels into it and the program runs by one call. It costs one more compilation,
+    // and only works on X86 without the buffer handle instructions
+    bool with_program_entry = false;
   };
 
   // Compile with a packing option and result, to be extended easily.
@@ -135,16 +165,45 @@ class GraphCompiler final {
 
   // find the first and last instruction where a variable used, and mark the
   // variable should allocate buffer before the first instruction runing and
-  // can release the buffer after the last instruction finished.
+  // can release the buffer after the last instruction finished. The variables
+  // sharing the buffers of others are counted as uses of the source buffers.
   void AnalyzeVariableLifeTime(const std::vector<std::unique_ptr<Instruction>>& instructions,
                                std::unordered_map<int, std::vector<std::string>>* step2malloc,
                                std::unordered_map<int, std::vector<std::string>>* step2free);
 
+  // find the outputs of the elementwise instructions(such as the gradient accumulations and relu_grad)
+  // which can reuse the buffers of their inputs used for the last time, and record them in reuse_vars_map_
+  void AnalyzeInplaceReuse(const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  // estimate the peak memory(in bytes) of the buffers allocated and released at the steps
+  // decided by AnalyzeVariableLifeTime
+  int64_t EstimatePeakMemory(const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  // recompute the outputs of the cheap instructions(elementwise, broadcast and batchnorm ops) right
+  // before their uses long after the others, such as the forward activations used by the backward
+  // ops, instead of keeping them alive in between, until the peak memory meets the budget
+  void Rematerialize(std::vector<std::unique_ptr<Instruction>>* instructions, int64_t budget);
+
   // insert a buffer malloc instruction applying on variables before they are
   // firstly used in the next instruction, and insert a buffer free instruction
   // applying on variables after no instruction will use them anymore
   void InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions);
 
+  // find the variables which can alias the buffers of other variables instead of materializing
+  // their own ones: the outputs of reshape and contiguous slice become views of their inputs, and
+  // the inputs of concat become views of the sub-regions of its output when they are contiguous,
+  // so the instructions of these ops need not run. Only reshape is aliased with the buffer handle
+  // instructions inserted.
+  void AnalyzeBufferAlias();
+
+  // make the aliased variables in the scope share the buffers recorded by AnalyzeBufferAlias,
+  // return the names of the aliased variables
+  std::unordered_set<std::string> ApplyBufferAlias();
+
+  // generate the entry function calling the kernels of the run instructions of \p program, whose arguments are the
+  // buffers of all the variables used by them, compile it with the kernels and set it to \p program
+  void BuildProgramEntry(Program* program);
+
  private:
   void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_func);
   void SetSubKernels(Instruction* instr, const std::string& func_name);
@@ -155,14 +214,26 @@ class GraphCompiler final {
   std::map<std::string, std::vector<std::string>> function2input_args_;
   // mapping a function's name to its output artuments' names
   std::map<std::string, std::vector<std::string>> function2output_args_;
+  // mapping a function's name to its static cost
+  absl::flat_hash_map<std::string, ir::KernelCost> function2cost_;
+  // mapping a function's name to its lowered function before optimized by the module
+  absl::flat_hash_map<std::string, ir::LoweredFunc> function2lowered_;
   // fetch var ids in cinn and the corresponding var nodes will not be fused so as to get the result
   std::unordered_set<std::string> fetch_var_ids_;
 
   absl::flat_hash_map<std::string, std::string> prefix2full_namemap_;
   // map dst reuse var to the src var sharing buffer
   absl::flat_hash_map<std::string, std::string> reuse_vars_map_;
+  // map dst view var to the src var and the offset(in bytes) where the view begins in the src buffer
+  absl::flat_hash_map<std::string, std::pair<std::string, uint32_t>> view_vars_map_;
+  // map the var recomputed by Rematerialize to the var it replaces in the late uses
+  absl::flat_hash_map<std::string, std::string> remat_vars_map_;
+  // the op nodes whose instructions are skipped because their outputs are aliased
+  std::unordered_set<std::string> zero_copy_nodes_;
 
   std::unique_ptr<backends::Compiler> compiler_;
+  // compiles the program entry with the kernels, which are linked again since the engines can't call each other
+  std::unique_ptr<backends::Compiler> entry_compiler_;
   CompileOptions compile_options_;
 
   ir::Module::Builder m_builder_;
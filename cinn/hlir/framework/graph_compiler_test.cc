@@ -16,7 +16,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <functional>
+
 #include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/op/use_ops.h"
@@ -114,6 +118,283 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestRematerialize) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {1024}, "A");
+  auto b = builder.relu(a);
+  auto c = builder.elementwise_mul(b, a);
+  auto d = builder.scale(c, 2.f);
+  auto e = builder.elementwise_add(c, d);
+  auto f = builder.scale(e, 0.5f);
+  // b is used again long after it is computed, and a is still alive then
+  auto g = builder.elementwise_add(f, b);
+  auto h = builder.elementwise_add(g, a);
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_buffer_handle_instruction_inserted = true;
+  options.remat_memory_budget                     = 0;
+  auto runtime_program                            = gc.Build(options).runtime_program;
+
+  // relu runs again right before the late use of b, writing a new variable
+  std::vector<Instruction*> computations;
+  for (auto& instr : runtime_program->GetRunInstructions()) {
+    auto fn_name = instr->GetFnNames().front();
+    if (fn_name.find("malloc_buffer_instruction") == 0 || fn_name.find("free_buffer_instruction") == 0) continue;
+    computations.push_back(instr.get());
+  }
+  ASSERT_EQ(computations.size(), 8UL);
+  ASSERT_EQ(computations[5]->GetFnNames(), computations[0]->GetFnNames());
+  auto remat_var = computations[5]->GetOutArgs().front().front();
+  ASSERT_NE(remat_var, b->id);
+  ASSERT_NE(scope->FindVar(remat_var), nullptr);
+  auto g_in_args = computations[6]->GetInArgs().front();
+  ASSERT_NE(std::find(g_in_args.begin(), g_in_args.end(), remat_var), g_in_args.end());
+  ASSERT_EQ(std::find(g_in_args.begin(), g_in_args.end(), b->id), g_in_args.end());
+}
+
+TEST(GraphCompilerTest, TestInplaceReuse) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {1024}, "A");
+  auto b = builder.relu(a);
+  auto c = builder.scale(b, 2.f);
+  // the gradient is written in place of c, and the accumulation in place of the gradient
+  auto d = builder.relu_grad(c, b);
+  auto e = builder.elementwise_add(d, b);
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_inplace_reuse = true;
+  auto runtime_program       = gc.Build(options).runtime_program;
+
+  auto buffer_of = [&](const std::string& name) { return scope->GetTensor(name)->get_buffer(); };
+  // a is the graph input, and b is used again after c
+  ASSERT_NE(buffer_of(b->id), buffer_of(a->id));
+  ASSERT_NE(buffer_of(c->id), buffer_of(b->id));
+  ASSERT_EQ(buffer_of(d->id), buffer_of(c->id));
+  ASSERT_EQ(buffer_of(e->id), buffer_of(c->id));
+
+  auto* a_data = scope->GetTensor(a->id)->mutable_data<float>(target);
+  for (int i = 0; i < 1024; i++) {
+    a_data[i] = i - 512;
+  }
+  for (auto& name : {b->id, c->id}) {
+    scope->GetTensor(name)->mutable_data<float>(target);
+  }
+  runtime_program->Execute();
+  auto* e_data = scope->GetTensor(e->id)->data<float>();
+  for (int i = 0; i < 1024; i++) {
+    ASSERT_EQ(e_data[i], 3.f * std::max(i - 512, 0));
+  }
+}
+
+TEST(GraphCompilerTest, TestInplaceReuseFetchVar) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {1024}, "A");
+  auto b = builder.relu(a);
+  auto c = builder.scale(b, 2.f);
+  auto d = builder.relu_grad(c, b);
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_inplace_reuse = true;
+  // the fetch var c is read after the run, so d cannot overwrite it
+  auto runtime_program = gc.Build(options, {c->id}).runtime_program;
+  ASSERT_NE(scope->GetTensor(d->id)->get_buffer(), scope->GetTensor(c->id)->get_buffer());
+}
+
+TEST(GraphCompilerTest, TestZeroCopySliceConcat) {
+  Placeholder A(Float(32), {1, 4, 8}, "A");
+  Placeholder B(Float(32), {1, 4, 8}, "B");
+
+  frontend::Program program;
+  auto x0 = program.relu(A);
+  auto x1 = program.relu(B);
+  // x0 and x1 are computed in place inside y
+  auto y = program.concat({x0, x1}, 1);
+  // a contiguous slice becomes a view of y
+  auto z = program.slice(
+      y, {{"starts", std::vector<int>({2})}, {"ends", std::vector<int>({6})}, {"axes", std::vector<int>({1})}});
+  // a strided slice is still materialized
+  auto w = program.slice(
+      y, {{"starts", std::vector<int>({1})}, {"ends", std::vector<int>({3})}, {"axes", std::vector<int>({2})}});
+  program.SetInputs({A, B});
+  program.Validate();
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(program, target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  auto runtime_program = gc.Build(options).runtime_program;
+
+  int zero_copy_num = 0;
+  for (auto& instr : runtime_program->GetRunInstructions()) {
+    zero_copy_num += instr->zero_copy;
+  }
+  ASSERT_EQ(zero_copy_num, 2);
+
+  auto y_tensor = scope->GetTensor(y->id);
+  auto* y_data  = y_tensor->mutable_data<float>(target);
+  EXPECT_EQ(scope->GetTensor(x0->id)->data<float>(), y_data);
+  EXPECT_EQ(scope->GetTensor(x1->id)->data<float>(), y_data + 4 * 8);
+  EXPECT_EQ(scope->GetTensor(z->id)->data<float>(), y_data + 2 * 8);
+
+  for (auto& name : {std::string(A.id()), std::string(B.id()), w->id}) {
+    scope->GetTensor(name)->mutable_data<float>(target);
+  }
+  auto* a_data = scope->GetTensor(std::string(A.id()))->mutable_data<float>(target);
+  auto* b_data = scope->GetTensor(std::string(B.id()))->mutable_data<float>(target);
+  for (int i = 0; i < 4 * 8; i++) {
+    a_data[i] = i - 16;
+    b_data[i] = 16 - i;
+  }
+  runtime_program->Execute();
+
+  auto* z_data = scope->GetTensor(z->id)->data<float>();
+  for (int i = 0; i < 4 * 8; i++) {
+    int j = i + 2 * 8;
+    ASSERT_EQ(z_data[i], j < 4 * 8 ? std::max(j - 16, 0) : std::max(16 - (j - 4 * 8), 0));
+  }
+  auto* w_data = scope->GetTensor(w->id)->data<float>();
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 2; j++) {
+      ASSERT_EQ(w_data[i * 2 + j], y_data[i * 8 + j + 1]);
+    }
+  }
+}
+
+TEST(GraphCompilerTest, TestBufferAliasWithBufferHandlers) {
+  Placeholder A(Float(32), {4, 8}, "A");
+  Placeholder B(Float(32), {4, 8}, "B");
+
+  frontend::Program program;
+  auto x0 = program.relu(A);
+  auto x1 = program.relu(B);
+  auto y  = program.concat({x0, x1}, 0);
+  auto z  = program.slice(
+      y, {{"starts", std::vector<int>({2})}, {"ends", std::vector<int>({6})}, {"axes", std::vector<int>({0})}});
+  auto w   = program.reshape(z, {32});
+  auto out = program.relu(w);
+  program.SetInputs({A, B});
+  program.Validate();
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(program, target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_buffer_handle_instruction_inserted = true;
+  auto runtime_program                            = gc.Build(options).runtime_program;
+
+  // the memory of the base is freed and malloc'd again on every run, so only reshape shares the whole buffer
+  int zero_copy_num = 0;
+  for (auto& instr : runtime_program->GetRunInstructions()) {
+    zero_copy_num += instr->zero_copy;
+  }
+  ASSERT_EQ(zero_copy_num, 1);
+  ASSERT_EQ(scope->GetTensor(w->id)->get_buffer(), scope->GetTensor(z->id)->get_buffer());
+
+  // the inputs and the output are held out of CINN, and the others are allocated by the buffer handle instructions
+  absl::flat_hash_map<std::string, std::vector<float>> external_data;
+  for (auto& name : {std::string(A.id()), std::string(B.id()), out->id}) {
+    external_data[name].resize(scope->GetTensor(name)->shape().numel());
+  }
+  using BufferCallback = std::function<int(void*, cinn_buffer_t*)>;
+  for (auto& name_view : scope->var_names()) {
+    std::string name(name_view.data(), name_view.size());
+    auto* buffer = scope->GetTensor(name)->buffer();
+    // the reshape output shares the cinn_buffer_t of its input
+    if (buffer->external_malloc) continue;
+    if (external_data.count(name)) {
+      auto* data              = external_data[name].data();
+      buffer->external_malloc = new BufferCallback([data](void*, cinn_buffer_t* buf) {
+        buf->memory = reinterpret_cast<uint8_t*>(data);
+        return 0;
+      });
+      buffer->external_free = new BufferCallback([](void*, cinn_buffer_t* buf) { return 0; });
+    } else {
+      int numel               = scope->GetTensor(name)->shape().numel();
+      buffer->external_malloc = new BufferCallback([numel](void*, cinn_buffer_t* buf) {
+        buf->memory = reinterpret_cast<uint8_t*>(new float[numel]);
+        return 0;
+      });
+      buffer->external_free = new BufferCallback([](void*, cinn_buffer_t* buf) {
+        delete[] reinterpret_cast<float*>(buf->memory);
+        buf->memory = nullptr;
+        return 0;
+      });
+    }
+  }
+
+  auto& a_data   = external_data[std::string(A.id())];
+  auto& b_data   = external_data[std::string(B.id())];
+  auto& out_data = external_data[out->id];
+  for (int run = 0; run < 2; run++) {
+    for (int i = 0; i < 4 * 8; i++) {
+      a_data[i] = i - 16 + run;
+      b_data[i] = 16 - i - run;
+    }
+    runtime_program->Execute();
+    // the rows 2 and 3 of A followed by the rows 0 and 1 of B
+    for (int i = 0; i < 4 * 8; i++) {
+      float expected = i < 2 * 8 ? a_data[i + 2 * 8] : b_data[i - 2 * 8];
+      ASSERT_EQ(out_data[i], std::max(expected, 0.f));
+    }
+  }
+}
+
+TEST(GraphCompilerTest, TestProgramEntry) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {1024}, "A");
+  auto b = builder.CreateInput(Float(32), {1024}, "B");
+  auto c = builder.relu(a);
+  auto d = builder.scale(c, 2.f);
+  auto e = builder.elementwise_add(d, b);
+  // the output of reshape is a view of e, and the entry skips its instruction
+  auto f = builder.reshape(e, {32, 32});
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  auto scope  = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.with_program_entry         = true;
+  auto runtime_program               = gc.Build(options).runtime_program;
+  ASSERT_TRUE(runtime_program->has_entry());
+
+  auto* a_data = scope->GetTensor(a->id)->mutable_data<float>(target);
+  auto* b_data = scope->GetTensor(b->id)->mutable_data<float>(target);
+  // the entry keeps the buffers, so the inputs updated in place are read by the next run
+  for (int run = 0; run < 2; run++) {
+    for (int i = 0; i < 1024; i++) {
+      a_data[i] = i - 512 + run;
+      b_data[i] = run - i;
+    }
+    runtime_program->Execute();
+    auto* f_data = scope->GetTensor(f->id)->data<float>();
+    for (int i = 0; i < 1024; i++) {
+      ASSERT_EQ(f_data[i], 2.f * std::max(i - 512 + run, 0) + run - i);
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
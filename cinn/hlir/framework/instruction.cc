@@ -37,9 +37,16 @@ std::vector<cinn_pod_value_t>& Instruction::PreparePodArgs(
       builder.Add(name2podargs->at(arg));
     }
   } else {
-    for (auto& arg : all_args) {
-      auto* var = scope_->FindVar(arg);
-      CHECK(var) << "Argument [" << arg << "] not found in the scope";
+    auto& slots = ResolveArgSlots(i);
+    for (int j = 0; j < slots.size(); ++j) {
+      auto* var = scope_->GetVar(slots[j]);
+      if (!var) {
+        // the variable is erased and may be created again by the name in a new slot
+        int slot = scope_->FindSlot(all_args[j]);
+        CHECK_GE(slot, 0) << "Argument [" << all_args[j] << "] is erased from the scope";
+        arg_slots_[i][j] = slot;
+        var              = scope_->GetVar(slot);
+      }
 
       // TODO(Superjomn) Support other types.
       auto& tensor = absl::get<Tensor>(*var);
@@ -52,22 +59,62 @@ std::vector<cinn_pod_value_t>& Instruction::PreparePodArgs(
   return args_cached_[i];
 }
 
+const std::vector<int>& Instruction::ResolveArgSlots(int i) {
+  if (arg_slots_.size() > i) return arg_slots_[i];
+  if (arg_slots_.size() < i) ResolveArgSlots(i - 1);
+  std::vector<int> slots;
+  for (auto* args : {&in_args_[i], &out_args_[i]}) {
+    for (auto& arg : *args) {
+      int slot = scope_->FindSlot(arg);
+      CHECK_GE(slot, 0) << "Argument [" << arg << "] not found in the scope";
+      slots.push_back(slot);
+    }
+  }
+  arg_slots_.push_back(std::move(slots));
+  return arg_slots_[i];
+}
+
 void Instruction::Finalize() {
   if (fn_.size() > 1 && fn_.size() != in_args_.size()) {
     out_args_.back()[0] = out_args_.front()[0];
     out_args_.erase(out_args_.begin());
     in_args_.erase(in_args_.begin());
   }
+  arg_slots_.clear();
 
   finalized_flag_ = true;
 }
 
+void Instruction::Flatten(std::vector<KernelCall>* calls) {
+  CHECK(finalized_flag_) << "Instruction must be finalized before flattened";
+  if (function_name_ == "no_run" || zero_copy) {
+    return;
+  }
+#ifdef CINN_WITH_CUDNN
+  if (target_.arch == Target::Arch::NVGPU &&
+      (function_name_ == "conv2d" || function_name_ == "depthwise_conv2d" || function_name_ == "pool2d" ||
+       function_name_ == "softmax" || function_name_ == "mul")) {
+    calls->push_back({nullptr, nullptr, 0, this});
+    return;
+  }
+#endif
+  for (int i = 0; i < fn_.size(); i++) {
+    auto& pod_args = PreparePodArgs(i, nullptr);
+    CHECK(fn_[i]) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
+    calls->push_back({fn_[i], pod_args.data(), static_cast<int>(pod_args.size()), nullptr});
+  }
+}
+
 void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs, bool dryrun, void* stream) {
   CHECK(finalized_flag_) << "Instruction must be finalized before run";
   if (function_name_ == "no_run") {
     VLOG(2) << "skip instruction";
     return;
   }
+  if (zero_copy && name2podargs == nullptr) {
+    VLOG(2) << "skip zero-copy instruction " << function_name_;
+    return;
+  }
 
   if (name2podargs != nullptr) {
     args_cached_.clear();
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <utility>
@@ -21,6 +22,7 @@
 
 #include "cinn/backends/cuda_util.h"
 #include "cinn/hlir/framework/scope.h"
+#include "cinn/ir/kernel_cost.h"
 #ifdef CINN_WITH_CUDNN
 #include "cinn/runtime/cuda/cuda_util.h"
 #endif
@@ -31,6 +33,17 @@ namespace cinn {
 namespace hlir {
 namespace framework {
 
+class Instruction;
+
+// A compiled function with its prepared arguments, the element of the flattened program. The functions which can't be
+// called directly, e.g. the ones dispatched to cuDNN by name, are run by their instruction instead.
+struct KernelCall {
+  lower_func_ptr_t fn{};
+  cinn_pod_value_t* args{};
+  int num_args{0};
+  Instruction* instr{};
+};
+
 /**
  * Instruction is the basic executable element in runtime, it holds a pointer to the JIT-compiled LoweredFunc, and
  * collect the cinn_buffer of the inputs and outputs from the scope, prepare the arguments and finally pass them into
@@ -74,12 +87,20 @@ class Instruction {
            bool dryrun                                                 = false,
            void* stream                                                = nullptr);
 
+  /**
+   * Append the functions of the instruction with their arguments prepared from the scope to \p calls, the no-run and
+   * the zero-copy instructions append nothing. The arguments are kept by the instruction, so \p calls is invalid
+   * once the instruction runs with the arguments passed in by name2podargs.
+   */
+  void Flatten(std::vector<KernelCall>* calls);
+
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) {
     CHECK_EQ(fn_.size(), 4);
     if (fn_.size() > 1 && fn_.size() != in_args_.size()) {
       out_args_.back()[0] = out_args_.front()[0];
       out_args_.erase(out_args_.begin());
       in_args_.erase(in_args_.begin());
+      arg_slots_.clear();
     }
     if (name2podargs != nullptr) {
       args_cached_.clear();
@@ -104,6 +125,7 @@ class Instruction {
       args_cached_.erase(args_cached_.begin() + flag);
       in_args_.erase(in_args_.begin() + flag);
       out_args_.erase(out_args_.begin() + flag);
+      if (arg_slots_.size() > flag) arg_slots_.erase(arg_slots_.begin() + flag);
       fn_.erase(fn_.begin() + flag);
       fn_names_.erase(fn_names_.begin() + flag);
     }
@@ -114,15 +136,29 @@ class Instruction {
   std::vector<std::vector<std::string>> GetInArgs() { return in_args_; }
   std::vector<std::vector<std::string>> GetOutArgs() { return out_args_; }
   std::vector<std::string> GetFnNames() { return fn_names_; }
+  const std::string& function_name() const { return function_name_; }
   void AddInArgs(const std::vector<std::string>& in_args) { in_args_.push_back(in_args); }
   void AddOutArgs(const std::vector<std::string>& out_args) { out_args_.push_back(out_args); }
+  // replace the input argument \p from with \p to for all the functions, before the instruction runs
+  void ReplaceInArg(const std::string& from, const std::string& to) {
+    CHECK(args_cached_.empty()) << "Can't replace the arguments of the instruction prepared";
+    for (auto& args : in_args_) std::replace(args.begin(), args.end(), from, to);
+    arg_slots_.clear();
+  }
   std::vector<int> attrs;
   std::vector<std::string> str_attrs;
   bool pre_run = false;
+  // the outputs alias the buffers of other variables in the scope, so the instruction
+  // only runs when the arguments are passed in by name2podargs
+  bool zero_copy = false;
+  // the static cost of the kernels of the instruction, estimated from their lowered functions
+  ir::KernelCost cost;
   Target target_;
 
  protected:
   std::vector<cinn_pod_value_t>& PreparePodArgs(int i, const std::map<std::string, cinn_pod_value_t>* name2podargs);
+  // the scope slots of the inputs and outputs of the i-th function, resolved from their names once
+  const std::vector<int>& ResolveArgSlots(int i);
 
  private:
   bool finalized_flag_ = false;
@@ -131,6 +167,7 @@ class Instruction {
   std::vector<std::vector<std::string>> in_args_;
   std::vector<std::vector<std::string>> out_args_;
 
+  std::vector<std::vector<int>> arg_slots_;
   std::vector<std::vector<cinn_pod_value_t>> args_cached_;
 
   std::vector<lower_func_ptr_t> fn_{};
@@ -97,6 +97,40 @@ TEST(Instruction, basic) {
   }
 }
 
+TEST(Instruction, RecreateVar) {
+  const int M = 10;
+  const int N = 20;
+
+  Scope scope;
+  InstantiateScope(M, N, &scope);
+  Instruction instr(common::DefaultHostTarget(), &scope, {"x", "y"}, {"z"});
+  auto jit     = GetLoweredFunc(M, N);
+  auto fn_addr = jit->Lookup("fn");
+  CHECK(fn_addr);
+  instr.SetLoweredFunc(reinterpret_cast<lower_func_ptr_t>(fn_addr));
+  instr.Finalize();
+  instr.Run();
+
+  // the arguments passed in by name drop the prepared ones, then the output is erased and created again by the name
+  std::map<std::string, cinn_pod_value_t> name2podargs;
+  for (auto& name : std::vector<std::string>({"x", "y", "z"})) {
+    name2podargs.emplace(name, scope.GetTensor(name)->buffer());
+  }
+  instr.Run(&name2podargs);
+  scope.EraseVar("z");
+  auto& z = absl::get<Tensor>(*scope.Var<Tensor>("z"));
+  z->Resize(Shape{{M, N}});
+  z->mutable_data<float>(common::DefaultHostTarget());
+  instr.Run();
+
+  auto* xd = scope.GetTensor("x")->data<float>();
+  auto* yd = scope.GetTensor("y")->data<float>();
+  auto* zd = scope.GetTensor("z")->data<float>();
+  for (int i = 0; i < M * N; i++) {
+    ASSERT_NEAR(xd[i] + yd[i], zd[i], 1e-5);
+  }
+}
+
 TEST(Instruction, RunWithRawPodArgs) {
   const int M       = 10;
   const int N       = 20;
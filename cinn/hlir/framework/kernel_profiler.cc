@@ -0,0 +1,113 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/kernel_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+KernelProfiler::KernelProfiler(bool with_perf_counters) {
+  if (with_perf_counters) {
+    perf_counters_.reset(new utils::PerfCounters());
+  }
+}
+
+void KernelProfiler::Profile(Program* program, int repeat, int warmup) {
+  auto& instrs = program->GetRunInstructions();
+  if (records_.empty()) {
+    records_.resize(instrs.size());
+    for (size_t i = 0; i < instrs.size(); ++i) {
+      records_[i].name = instrs[i]->function_name();
+      records_[i].cost = instrs[i]->cost;
+    }
+  }
+  CHECK_EQ(records_.size(), instrs.size()) << "The profiler is used by another program";
+
+  for (int i = 0; i < warmup; ++i) {
+    program->Execute();
+  }
+
+  utils::Timer timer;
+  for (int i = 0; i < repeat; ++i) {
+    for (size_t j = 0; j < instrs.size(); ++j) {
+      if (perf_counters_) perf_counters_->Start();
+      timer.Start();
+      instrs[j]->Run();
+#ifdef CINN_WITH_CUDA
+      if (instrs[j]->target_.arch == Target::Arch::NVGPU) {
+        CUDA_CALL(cudaDeviceSynchronize());
+      }
+#endif
+      records_[j].total_ms += timer.Stop();
+      if (perf_counters_) records_[j].counters += perf_counters_->Stop();
+      records_[j].runs++;
+    }
+  }
+}
+
+std::string KernelProfiler::Report(const RooflinePeak& peak) const {
+  std::vector<const Record*> sorted;
+  double total_ms = 0.;
+  for (auto& record : records_) {
+    sorted.push_back(&record);
+    total_ms += record.total_ms;
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Record* a, const Record* b) { return a->total_ms > b->total_ms; });
+
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << std::left << std::setw(48) << "kernel" << std::right << std::setw(8) << "time%" << std::setw(12) << "ms/run"
+     << std::setw(12) << "MFLOP" << std::setw(12) << "MB" << std::setw(10) << "FLOP/B" << std::setw(12) << "GFLOP/s"
+     << std::setw(12) << "GB/s";
+  if (peak.defined()) ss << std::setw(10) << "bound" << std::setw(10) << "roof%";
+  if (perf_counters_ && perf_counters_->available()) ss << std::setw(8) << "IPC" << std::setw(14) << "LLC miss/run";
+  ss << "\n";
+
+  for (auto* record : sorted) {
+    std::string name = record->name.size() > 46 ? record->name.substr(0, 43) + "..." : record->name;
+    double intensity = record->cost.arithmetic_intensity();
+    ss << std::left << std::setw(48) << name << std::right << std::setw(8)
+       << (total_ms > 0. ? record->total_ms * 100. / total_ms : 0.) << std::setw(12) << record->avg_ms()
+       << std::setw(12) << record->cost.flops / 1e6 << std::setw(12) << record->cost.bytes / 1e6 << std::setw(10)
+       << intensity << std::setw(12) << record->achieved_gflops() << std::setw(12) << record->achieved_gbps();
+    if (peak.defined()) {
+      // below the ridge point the attainable throughput is limited by the bandwidth, the kernels without floating
+      // point operations are compared with the bandwidth only
+      bool memory_bound = intensity < peak.gflops / peak.gbps;
+      double roof_ratio = record->cost.flops > 0.
+                              ? record->achieved_gflops() / std::min(peak.gflops, intensity * peak.gbps)
+                              : record->achieved_gbps() / peak.gbps;
+      ss << std::setw(10) << (memory_bound ? "memory" : "compute") << std::setw(10) << roof_ratio * 100.;
+    }
+    if (perf_counters_ && perf_counters_->available()) {
+      auto& counters = record->counters;
+      ss << std::setw(8) << (counters.cycles > 0 ? static_cast<double>(counters.instructions) / counters.cycles : 0.)
+         << std::setw(14) << (record->runs > 0 ? static_cast<double>(counters.llc_misses) / record->runs : 0.);
+    }
+    ss << "\n";
+  }
+  ss << "total " << (records_.empty() || records_[0].runs == 0 ? 0. : total_ms / records_[0].runs) << " ms/run\n";
+  return ss.str();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
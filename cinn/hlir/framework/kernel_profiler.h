@@ -0,0 +1,83 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/ir/kernel_cost.h"
+#include "cinn/utils/perf_counters.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+// The peak compute throughput and memory bandwidth of the machine, the roof of the roofline.
+struct RooflinePeak {
+  double gflops{0.};
+  double gbps{0.};
+
+  bool defined() const { return gflops > 0. && gbps > 0.; }
+};
+
+/**
+ * Profile the kernels of a runtime program on the roofline. The instructions are run one by one and each run is
+ * timed, optionally with the hardware counters around it. The achieved GFLOP/s and GB/s of each kernel are computed
+ * from its static cost, and compared with the roof at its arithmetic intensity to tell whether it is compute-bound or
+ * memory-bound and how far it is from the roof.
+ *
+ *   KernelProfiler profiler(true);
+ *   profiler.Profile(runtime_program.get(), 100);
+ *   LOG(INFO) << profiler.Report({peak_gflops, peak_gbps});
+ */
+class KernelProfiler {
+ public:
+  struct Record {
+    std::string name;
+    ir::KernelCost cost;
+    int runs{0};
+    double total_ms{0.};
+    utils::PerfCounters::Values counters;
+
+    double avg_ms() const { return runs > 0 ? total_ms / runs : 0.; }
+    double achieved_gflops() const { return total_ms > 0. ? cost.flops * runs / total_ms / 1e6 : 0.; }
+    double achieved_gbps() const { return total_ms > 0. ? cost.bytes * runs / total_ms / 1e6 : 0.; }
+  };
+
+  explicit KernelProfiler(bool with_perf_counters = false);
+
+  /**
+   * Run the program \p repeat times after \p warmup runs, and accumulate the time of each instruction.
+   */
+  void Profile(Program* program, int repeat, int warmup = 1);
+
+  const std::vector<Record>& records() const { return records_; }
+
+  /**
+   * The report of the kernels from the most time-consuming one. Without the peak of the machine the kernels are not
+   * compared with the roof.
+   */
+  std::string Report(const RooflinePeak& peak = RooflinePeak()) const;
+
+ private:
+  std::unique_ptr<utils::PerfCounters> perf_counters_;
+  std::vector<Record> records_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,57 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/kernel_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(KernelProfiler, roofline) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {1, 64, 56, 56}, "A");
+  auto b = builder.CreateInput(Float(32), {64}, "B");
+  auto c = builder.relu(builder.elementwise_add(a, b, 1));
+
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  ApplyPass(graph.get(), "OpFusion");
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  // the fused add + relu reads A and B and writes C at least
+  ASSERT_EQ(runtime_program->size(), 1);
+  auto& cost = runtime_program->GetRunInstructions().front()->cost;
+  EXPECT_GE(cost.bytes, (2. * 64 * 56 * 56 + 64) * 4);
+  EXPECT_GT(cost.flops, 0.);
+
+  KernelProfiler profiler(true);
+  profiler.Profile(runtime_program.get(), 10);
+  ASSERT_EQ(profiler.records().size(), 1UL);
+  EXPECT_EQ(profiler.records()[0].runs, 10);
+  EXPECT_GT(profiler.records()[0].achieved_gbps(), 0.);
+  LOG(INFO) << "\n" << profiler.Report({100., 20.});
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -21,16 +21,24 @@ namespace hlir {
 namespace framework {
 
 void Scope::EraseVar(const std::string& name) {
-  CHECK(data_.count(name)) << "Variable(" << name << ") not found";
-  data_.erase(name);
+  auto it = name2slot_.find(name);
+  CHECK(it != name2slot_.end()) << "Variable(" << name << ") not found";
+  // the slot is not reused, so the slots resolved by the others are kept valid
+  vars_[it->second].reset();
+  name2slot_.erase(it);
 }
 
 Variable* Scope::FindVar(const std::string& name) const {
-  auto it = data_.find(name);
-  if (it != data_.end()) return it->second.get();
+  auto it = name2slot_.find(name);
+  if (it != name2slot_.end()) return vars_[it->second].get();
   return nullptr;
 }
 
+int Scope::FindSlot(const std::string& name) const {
+  auto it = name2slot_.find(name);
+  return it != name2slot_.end() ? it->second : -1;
+}
+
 Tensor Scope::GetTensor(const std::string& name) const {
   CheckVarNameValid(name);
   auto* var = FindVar(name);
@@ -40,8 +48,8 @@ Tensor Scope::GetTensor(const std::string& name) const {
 
 std::vector<absl::string_view> Scope::var_names() const {
   std::vector<absl::string_view> names;
-  for (auto& item : data_) {
-    names.push_back(item.first);
+  for (int i = 0; i < vars_.size(); i++) {
+    if (vars_[i]) names.push_back(slot_names_[i]);
   }
   return names;
 }
@@ -33,6 +33,11 @@ using Variable = absl::variant<Tensor>;
 
 struct _Tensor_;
 
+/**
+ * Scope holds the runtime variables. Each variable is assigned a dense integer slot when it is created, the compiled
+ * instructions resolve their arguments to the slots once and then access the variables by slot, the lookups by name
+ * are kept for the external API.
+ */
 class Scope {
  public:
   static std::shared_ptr<Scope> Create() { return std::make_shared<Scope>(); }
@@ -47,15 +52,30 @@ class Scope {
   //! Find a variable, get null if not exists.
   Variable* FindVar(const std::string& name) const;
 
+  //! Get the slot of a variable, get -1 if not exists.
+  int FindSlot(const std::string& name) const;
+
+  //! Get the variable in a slot, get null if it is erased.
+  Variable* GetVar(int slot) const {
+    CHECK_GE(slot, 0);
+    CHECK_LT(slot, num_slots());
+    return vars_[slot].get();
+  }
+
   Tensor GetTensor(const std::string& name) const;
 
-  //! Get variable names.
+  //! The number of the slots, including the ones of the erased variables.
+  int num_slots() const { return vars_.size(); }
+
+  //! Get variable names, in the order of their slots.
   std::vector<absl::string_view> var_names() const;
 
   Scope() = default;
 
  private:
-  absl::flat_hash_map<std::string, std::unique_ptr<Variable>> data_;
+  absl::flat_hash_map<std::string, int> name2slot_;
+  std::vector<std::unique_ptr<Variable>> vars_;
+  std::vector<std::string> slot_names_;
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Scope);
 };
@@ -65,8 +85,10 @@ Variable* Scope::Var(const std::string& name) {
   VLOG(4) << "Scope insert Var [" << name << "]";
   Variable* x = FindVar(name);
   if (x) return x;
-  auto* data = new Variable(T());
-  data_[name].reset(data);
+  auto* data       = new Variable(T());
+  name2slot_[name] = vars_.size();
+  vars_.emplace_back(data);
+  slot_names_.push_back(name);
   return data;
 }
 
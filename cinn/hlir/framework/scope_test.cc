@@ -40,6 +40,28 @@ TEST(ScopeTest, TestEraseVar) {
   ASSERT_DEATH(scope.EraseVar("key"), "");
 }
 
+TEST(ScopeTest, TestSlot) {
+  Scope scope;
+  auto* a = scope.Var<Tensor>("a");
+  auto* b = scope.Var<Tensor>("b");
+  ASSERT_EQ(scope.FindSlot("a"), 0);
+  ASSERT_EQ(scope.FindSlot("b"), 1);
+  EXPECT_EQ(scope.GetVar(0), a);
+  EXPECT_EQ(scope.GetVar(1), b);
+
+  // the slot of the erased variable is not reused
+  scope.EraseVar("a");
+  EXPECT_EQ(scope.FindSlot("a"), -1);
+  EXPECT_EQ(scope.GetVar(0), nullptr);
+  scope.Var<Tensor>("c");
+  EXPECT_EQ(scope.FindSlot("c"), 2);
+  EXPECT_EQ(scope.GetVar(1), b);
+  EXPECT_EQ(scope.num_slots(), 3);
+  ASSERT_EQ(scope.var_names().size(), 2UL);
+  EXPECT_EQ(scope.var_names()[0], "b");
+  EXPECT_EQ(scope.var_names()[1], "c");
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -90,6 +90,19 @@ std::shared_ptr<OpStrategy> StrategyForElementwise(const framework::NodeAttr &at
   return strategy;
 }
 
+std::shared_ptr<OpStrategy> StrategyForGelu(const framework::NodeAttr &attrs,
+                                            const std::vector<ir::Tensor> &inputs,
+                                            const std::vector<Type> &out_type,
+                                            const std::vector<std::vector<int>> &output_shapes,
+                                            const Target &target) {
+  bool approximate = false;
+  if (attrs.attr_store.count("approximate")) {
+    approximate = absl::get<bool>(attrs.attr_store.at("approximate"));
+  }
+  PeFunc gelu = [=](const ir::Tensor &A, const std::string &out_name) { return pe::Gelu(A, approximate, out_name); };
+  return StrategyForElementwise(attrs, inputs, out_type, output_shapes, target, "gelu", gelu);
+}
+
 std::vector<shape_t> InferShapeForElementwise(const std::vector<shape_t> &inputs_shape,
                                               const framework::AttrMapType &attrs) {
   CHECK_EQ(inputs_shape.size(), 1UL);
@@ -441,6 +454,17 @@ CINN_REGISTER_HELPER(elementwise_ops) {
 
 #undef CINN_REGISTER_UNARY
 
+  CINN_REGISTER_OP(gelu)
+      .describe("GELU activation, approximated with tanh when the attribute approximate is true")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForGelu)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForElementwise))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForElementwise))
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForElementwise))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(scale)
       .describe("Putting scale and bias to the input Tensor")
       .set_num_inputs(1)
@@ -25,6 +25,9 @@
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/layout.h"
 #include "cinn/poly/stage.h"
+#ifdef CINN_WITH_MKLDNN
+#include "cinn/runtime/cpu/mkldnn_math.h"
+#endif
 
 namespace cinn {
 namespace hlir {
@@ -214,6 +217,13 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
                                    target);
         } else {
 #ifdef CINN_WITH_MKLDNN
+          // the third input is the filter reordered once by conv2d_mkldnn_reorder_weights
+          ir::Tensor reordered_weights;
+          if (a.size() > 2U) {
+            Expr C = a[2];
+            CHECK(C.as_tensor());
+            reordered_weights = C.as_tensor_ref();
+          }
           out = pe::Conv2d_NCHW_MKLDNN(A.as_tensor_ref(),
                                        B.as_tensor_ref(),
                                        padding[0],
@@ -222,6 +232,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
                                        stride[1],
                                        dilation[0],
                                        dilation[1],
+                                       reordered_weights,
                                        UniqName("Conv2d_nchw_mkldnn_out"));
 #else
           out = pe::Conv2d_NCHW_5D(A.as_tensor_ref(),
@@ -274,6 +285,10 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
       LOG(FATAL) << "Only support NCHW and NHWC data layout\n";
     }
     auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref()});
+    if (a.size() > 2U) {
+      Expr C = a[2];
+      stages->InsertLazily(C.as_tensor_ref());
+    }
 
     for (auto &t : out) {
       stages->InsertLazily(t);
@@ -578,6 +593,89 @@ std::vector<std::vector<std::string>> InferLayoutForConv2d(const std::vector<fra
   return {{input_layouts[0], input_layouts[0], input_layouts[0], input_layouts[0]}, input_layouts};
 }
 
+#ifdef CINN_WITH_MKLDNN
+std::shared_ptr<OpStrategy> StrategyForConv2dMKLDNNReorderWeights(const framework::NodeAttr &attrs,
+                                                                  const std::vector<ir::Tensor> &inputs,
+                                                                  const std::vector<Type> &out_type,
+                                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                                  const Target &target) {
+  framework::CINNCompute reorder_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of conv2d_mkldnn_reorder_weights compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK_GE(a.size(), 1U) << "at least 1 input tensor for conv2d_mkldnn_reorder_weights compute\n";
+    Expr B = a[0];
+    CHECK(B.as_tensor());
+    auto input_shape = absl::get<std::vector<int>>(attrs.attr_store.at("input_shape"));
+    auto padding     = absl::get<std::vector<int>>(attrs.attr_store.at("padding"));
+    auto stride      = absl::get<std::vector<int>>(attrs.attr_store.at("stride"));
+    auto dilation    = absl::get<std::vector<int>>(attrs.attr_store.at("dilation"));
+
+    auto B_tensor = B.as_tensor_ref();
+    auto stages   = CreateStages({B_tensor});
+    auto out      = pe::Conv2d_NCHW_MKLDNN_ReorderWeights(B_tensor,
+                                                          input_shape,
+                                                          padding[0],
+                                                          padding[1],
+                                                          stride[0],
+                                                          stride[1],
+                                                          dilation[0],
+                                                          dilation[1],
+                                                          UniqName("Conv2d_mkldnn_reorder_weights_out"));
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule reorder_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of conv2d_mkldnn_reorder_weights schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 3UL);
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(reorder_compute, reorder_schedule, "strategy.conv2d_mkldnn_reorder_weights.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForConv2dMKLDNNReorderWeights(const std::vector<shape_t> &inputs_shape,
+                                                             const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The input's shape size should be 1! Please check again.";
+  auto &filter_shape = inputs_shape[0];
+  CHECK_EQ(filter_shape.size(), 4U) << "The filter of conv2d_mkldnn_reorder_weights should be 4-D! Please check.";
+  auto input_shape = absl::get<std::vector<int>>(attrs.at("input_shape"));
+  auto padding     = absl::get<std::vector<int>>(attrs.at("padding"));
+  auto stride      = absl::get<std::vector<int>>(attrs.at("stride"));
+  auto dilation    = absl::get<std::vector<int>>(attrs.at("dilation"));
+  int group        = input_shape[1] / filter_shape[1];
+  int size         = cinn_cpu_mkldnn_conv2d_reordered_weights_size_fp32(input_shape[0],
+                                                                        input_shape[1],
+                                                                        input_shape[2],
+                                                                        input_shape[3],
+                                                                        filter_shape[0],
+                                                                        group,
+                                                                        filter_shape[2],
+                                                                        filter_shape[3],
+                                                                        padding[0],
+                                                                        padding[1],
+                                                                        stride[0],
+                                                                        stride[1],
+                                                                        dilation[0],
+                                                                        dilation[1]);
+  return {{size}, {1}};
+}
+
+std::vector<Type> InferDtypeForConv2dMKLDNNReorderWeights(const std::vector<Type> &inputs_type,
+                                                          const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0]};
+}
+#endif
+
 std::shared_ptr<OpStrategy> StrategyForConv2dNCHWc(const framework::NodeAttr &attrs,
                                                    const std::vector<ir::Tensor> &inputs,
                                                    const std::vector<Type> &out_type,
@@ -886,14 +984,15 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
         CHECK(data.as_tensor());
         ir::Tensor packed_out_tensor = packed_out.as_tensor_ref();
         bool do_padding              = (padding[0] == 0 && padding[1] == 0) ? false : true;
-        pe::Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(stages,
-                                                       res.as_tensor_ref(),
-                                                       packed_out_tensor,
-                                                       input_pad.as_tensor_ref(),
-                                                       weights_dilation.as_tensor_ref(),
-                                                       data.as_tensor_ref(),
-                                                       target,
-                                                       do_padding);
+        pe::Depthwise_Conv2d_NCHWc_Schedule_CPU(stages,
+                                                res.as_tensor_ref(),
+                                                packed_out_tensor,
+                                                input_pad.as_tensor_ref(),
+                                                weights_dilation.as_tensor_ref(),
+                                                data.as_tensor_ref(),
+                                                target,
+                                                key,
+                                                do_padding);
         if (do_padding) {
           *ret = CINNValuePack{
               {CINNValue(res), CINNValue(packed_out_tensor), arg_pack[2], arg_pack[3], CINNValue(stages)}};
@@ -1300,6 +1399,40 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
     *ret = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
   });
 
+  framework::CINNCompute global_pool2d_cpu_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of pool2d compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    Expr A          = a[0];
+    CHECK(A.as_tensor());
+    ir::Tensor A_tensor = A.as_tensor_ref();
+    int lanes           = pe::GetBasicFactor(A_tensor->type(), target);
+    auto out            = pe::GlobalPool2dCPU(A_tensor, pool_type, lanes, UniqName("T_GlobalPool2d_out"));
+    CHECK(out.size() == 2U || out.size() == 3U) << "The size of pe::GlobalPool2dCPU's output should be 2 or 3.";
+    auto stages = CreateStages({A_tensor});
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule global_pool2d_cpu_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of pool2d schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK(arg_pack.size() == 3UL || arg_pack.size() == 4UL);
+    std::vector<ir::Tensor> tensors;
+    for (int i = 0; i < arg_pack.size() - 1; i++) {
+      Expr temp = arg_pack[i];
+      CHECK(temp.as_tensor());
+      tensors.push_back(temp.as_tensor_ref());
+    }
+    poly::StageMap stages = arg_pack[arg_pack.size() - 1];
+    pe::GlobalPoolScheduleCPU(stages, tensors, target);
+    *ret = CINNValuePack{{arg_pack[0], CINNValue(stages)}};
+  });
+
   framework::CINNCompute pool2d_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of pool2d compute is empty! Please check.\n";
     CINNValuePack a = args[0];
@@ -1346,6 +1479,8 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
     if (target.arch == Target::Arch::NVGPU) {
       pe::PoolScheduleGPU(stages, temp_out, target);
       arg_pack[arg_pack.size() - 2] = Expr(temp_out);
+    } else if (target.arch == Target::Arch::X86) {
+      pe::PoolScheduleCPU(stages, temp_out, target);
     }
     *ret = CINNValuePack{{CINNValue(Out), CINNValue(stages)}};
   });
@@ -1364,6 +1499,9 @@ std::shared_ptr<OpStrategy> StrategyForPool2d(const framework::NodeAttr &attrs,
   if (use_warp_reduce) {
     strategy->AddImpl(global_pool2d_compute, global_pool2d_schedule, "strategy.pool2d.gpu.global", 2);
   }
+  if (global_pooling && !adaptive && data_format == "NCHW" && target.arch == Target::Arch::X86) {
+    strategy->AddImpl(global_pool2d_cpu_compute, global_pool2d_cpu_schedule, "strategy.pool2d.x86.global", 2);
+  }
 
   return strategy;
 }
@@ -1637,12 +1775,22 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
                                                const Target &target) {
   int axis        = -1;
   bool use_mkldnn = false;
+  float scale     = 1.f;
+  bool use_log    = false;
   if (attrs.attr_store.count("axis")) {
     axis = absl::get<int>(attrs.attr_store.at("axis"));
   }
   if (attrs.attr_store.count("use_mkldnn")) {
     use_mkldnn = absl::get<bool>(attrs.attr_store.at("use_mkldnn"));
   }
+  if (attrs.attr_store.count("scale")) {
+    scale = absl::get<float>(attrs.attr_store.at("scale"));
+  }
+  if (attrs.attr_store.count("use_log")) {
+    use_log = absl::get<bool>(attrs.attr_store.at("use_log"));
+  }
+  // the fused kernel finds the max and the exp-sum in one pass, and covers the scale and log variants mkldnn lacks
+  bool use_fused = target.arch == Target::Arch::X86 && (!use_mkldnn || scale != 1.f || use_log);
   framework::CINNCompute softmax_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input arguments of softmax compute is empty! Please check.";
     CINNValuePack a = args[0];
@@ -1656,15 +1804,19 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
       new_axis = A->shape.size() - 1;
     }
     std::vector<ir::Tensor> out;
-#ifdef CINN_WITH_MKLDNN
-    if (use_mkldnn) {
-      out = pe::SoftmaxMKLDNN(A, new_axis, UniqName("Softmax_mkldnn_output"));
+    if (use_fused) {
+      out = pe::SoftmaxFused(A, new_axis, scale, use_log, UniqName("Softmax_fused_output"));
     } else {
-      out = pe::Softmax(A, new_axis, UniqName("Softmax_output"));
-    }
+#ifdef CINN_WITH_MKLDNN
+      if (use_mkldnn) {
+        out = pe::SoftmaxMKLDNN(A, new_axis, UniqName("Softmax_mkldnn_output"));
+      } else {
+        out = pe::Softmax(A, new_axis, scale, use_log, UniqName("Softmax_output"));
+      }
 #else
-    out = pe::Softmax(A, new_axis, UniqName("Softmax_output"));
+      out = pe::Softmax(A, new_axis, scale, use_log, UniqName("Softmax_output"));
 #endif
+    }
     std::vector<CINNValue> res;
     for (auto &t : out) {
       stages->InsertLazily(t);
@@ -1696,7 +1848,7 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
         int shape_size = tensor_a->shape.size();
         stages[tensor_b]->ComputeAt(stages[tensor_a], shape_size);
       }
-    } else if (target.arch == Target::Arch::X86) {
+    } else if (target.arch == Target::Arch::X86 && !use_fused) {
       pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, axis);
     }
     *ret = arg_pack;
@@ -1733,6 +1885,108 @@ std::vector<std::vector<std::string>> InferLayoutForSoftmax(const std::vector<fr
   return {{input_layouts[0], input_layouts[0]}, input_layouts};
 }
 
+std::shared_ptr<OpStrategy> StrategyForLayerNorm(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<Type> &out_type,
+                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                 const Target &target) {
+  int begin_norm_axis = 1;
+  float epsilon       = 0.00001f;
+  if (attrs.attr_store.count("begin_norm_axis")) {
+    begin_norm_axis = absl::get<int>(attrs.attr_store.at("begin_norm_axis"));
+  }
+  if (attrs.attr_store.count("epsilon")) {
+    epsilon = absl::get<float>(attrs.attr_store.at("epsilon"));
+  }
+  framework::CINNCompute layer_norm_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of layer_norm compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 3U) << "3 input tensors for layer_norm compute\n";
+    Expr X     = a[0];
+    Expr Scale = a[1];
+    Expr Bias  = a[2];
+    CHECK(X.as_tensor());
+    CHECK(Scale.as_tensor());
+    CHECK(Bias.as_tensor());
+    auto out    = pe::LayerNorm(X.as_tensor_ref(),
+                             Scale.as_tensor_ref(),
+                             Bias.as_tensor_ref(),
+                             begin_norm_axis,
+                             epsilon,
+                             UniqName("LayerNorm_output"));
+    auto stages = CreateStages({X.as_tensor_ref()});
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule layer_norm_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of layer_norm schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 4UL);
+    Expr out              = arg_pack[0];
+    Expr mean             = arg_pack[1];
+    Expr variance         = arg_pack[2];
+    poly::StageMap stages = arg_pack[3];
+    CHECK(out.as_tensor());
+    CHECK(mean.as_tensor());
+    CHECK(variance.as_tensor());
+    pe::LayerNormSchedule(
+        stages, out.as_tensor_ref(), mean.as_tensor_ref(), variance.as_tensor_ref(), begin_norm_axis, target);
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of layer_norm op is empty! Please check.";
+  if (out_type[0] == Float(32)) {
+    strategy->AddImpl(layer_norm_compute, layer_norm_schedule, "strategy.layer_norm.x86", 1);
+  } else {
+    LOG(FATAL) << "LayerNorm op with dtype != float32 is not implemented yet!";
+  }
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForLayerNorm(const std::vector<shape_t> &inputs_shape,
+                                            const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 3U) << "The input's shape size should be 3! Please check again.";
+  int begin_norm_axis = 1;
+  if (attrs.count("begin_norm_axis")) {
+    begin_norm_axis = absl::get<int>(attrs.at("begin_norm_axis"));
+  }
+  auto &x_shape = inputs_shape[0];
+  CHECK(begin_norm_axis >= 1 && begin_norm_axis < x_shape.size())
+      << "begin_norm_axis should be in [1, " << x_shape.size() << ")! Please check again.";
+  int row_size = 1;
+  for (int i = begin_norm_axis; i < x_shape.size(); i++) {
+    row_size *= x_shape[i];
+  }
+  CHECK(inputs_shape[1] == shape_t({row_size})) << "The shape of scale should be [" << row_size << "]";
+  CHECK(inputs_shape[2] == shape_t({row_size})) << "The shape of bias should be [" << row_size << "]";
+  shape_t row_shape(x_shape.begin(), x_shape.begin() + begin_norm_axis);
+  return {x_shape, row_shape, row_shape};
+}
+
+std::vector<Type> InferDtypeForLayerNorm(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0], inputs_type[0]};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForLayerNorm(const std::vector<framework::shape_t> &input_shapes,
+                                                              const std::vector<std::string> &input_layouts,
+                                                              const framework::NodeAttr &attrs,
+                                                              const Target &target) {
+  CHECK_EQ(input_layouts.size(), 3U) << "The input's layout size is not 3! Please check again.";
+  if (input_shapes[0].size() > 4) {
+    // the normalized axes are defined on the original layout
+    return {{"NCHW", "", ""}, {"NCHW", input_layouts[1], input_layouts[2]}};
+  }
+  return {{input_layouts[0], "", ""}, input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForSlice(const framework::NodeAttr &attrs,
                                              const std::vector<ir::Tensor> &inputs,
                                              const std::vector<Type> &out_type,
@@ -2187,6 +2441,19 @@ CINN_REGISTER_HELPER(nn_ops) {
 #endif
       .set_support_level(4);
 
+#ifdef CINN_WITH_MKLDNN
+  CINN_REGISTER_OP(conv2d_mkldnn_reorder_weights)
+      .describe("This operator reorders the constant filter of a oneDNN conv2d into the layout of its primitive once.")
+      .set_num_inputs(1)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForConv2dMKLDNNReorderWeights)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForConv2dMKLDNNReorderWeights))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForConv2dMKLDNNReorderWeights))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+#endif
+
   CINN_REGISTER_OP(conv2d_NCHWc)
       .describe("Do a 2-D convolution with an NCHWc layout. Input is 5D tensor and weight is 6D tensor.")
       .set_num_inputs(2)  // here we consider filter as another input
@@ -2284,6 +2551,19 @@ CINN_REGISTER_HELPER(nn_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(layer_norm)
+      .describe("This operator implements the layer normalization over the axes from begin_norm_axis")
+      .set_num_inputs(3)
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForLayerNorm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForLayerNorm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForLayerNorm))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForLayerNorm))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(slice)
       .describe("This operator implements the slice layer")
       .set_num_inputs(1)
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <string>
@@ -202,6 +203,69 @@ TEST(Operator, Operator_Pool2d_Test2) {
   ASSERT_EQ(pool2d->description, "Do pooling on the height and width dimension of the input tensor.");
 }
 
+TEST(Operator, Operator_Pool2d_Test_Global) {
+  auto pool2d   = Operator::Get("pool2d");
+  Operator temp = *pool2d;
+  auto strategy = Operator::GetAttrs<StrategyFunction>("CINNStrategy");
+
+  int n = 2, c = 16, h = 16, w = 16;
+  Expr N(n), C(c), H(h), W(w);
+  Placeholder<float> A("A", {N, C, H, W});
+
+  for (std::string pool_type : {"avg", "max"}) {
+    NodeAttr attrs;
+    attrs.attr_store["kernel_size"]    = std::vector<int>({h, w});
+    attrs.attr_store["stride_size"]    = std::vector<int>({1, 1});
+    attrs.attr_store["padding_size"]   = std::vector<int>({0, 0, 0, 0});
+    attrs.attr_store["pool_type"]      = pool_type;
+    attrs.attr_store["global_pooling"] = true;
+    std::vector<ir::Tensor> inputs{A.tensor()};
+    std::vector<Type> type{Float(32)};
+    common::Target target = common::DefaultHostTarget();
+    auto impl = OpStrategy::SelectImpl(strategy[pool2d](attrs, inputs, type, {{n, c, 1, 1}}, target));
+    ASSERT_EQ(impl->name, "strategy.pool2d.x86.global");
+    common::CINNValuePack cinn_input = common::CINNValuePack{{common::CINNValue(A)}};
+    common::CINNValuePack rets       = impl->fcompute(cinn_input);
+    rets                             = impl->fschedule(rets);
+    ASSERT_EQ(rets.size(), 2UL);
+    // the last element is a StageMap
+    for (int i = 0; i < rets->size() - 1; i++) {
+      Expr temp = rets[i];
+      inputs.push_back(temp.as_tensor_ref());
+    }
+    std::string func_name = "global_pool2d_" + pool_type;
+    auto func             = Lower(func_name, rets.back(), inputs);
+    LOG(INFO) << "Test Strategy Codegen:\n" << func;
+
+    Module::Builder builder("module_" + pool_type, target);
+    builder.AddFunction(func);
+    auto jit    = backends::ExecutionEngine::Create({});
+    auto module = builder.Build();
+
+    jit->Link(module);
+    auto fn = jit->Lookup(func_name);
+    CHECK(fn);
+    auto fn_ = reinterpret_cast<void (*)(void *, int32_t)>(fn);
+
+    cinn_buffer_t *A_buf = common::BufferBuilder(Float(32), {n, c, h, w}).set_random().Build();
+    cinn_buffer_t *B_buf = common::BufferBuilder(Float(32), {n, c, 1, 1}).set_zero().Build();
+    cinn_pod_value_t a_arg(A_buf), b_arg(B_buf);
+    cinn_pod_value_t args[] = {a_arg, b_arg};
+    fn_(args, 2);
+
+    auto input  = reinterpret_cast<float *>(A_buf->memory);
+    auto output = reinterpret_cast<float *>(B_buf->memory);
+    for (int i = 0; i < n * c; i++) {
+      float sum = 0.f, max = input[i * h * w];
+      for (int j = 0; j < h * w; j++) {
+        sum += input[i * h * w + j];
+        max = std::max(max, input[i * h * w + j]);
+      }
+      ASSERT_NEAR(output[i], pool_type == "avg" ? sum / (h * w) : max, 1e-5);
+    }
+  }
+}
+
 TEST(Operator, Operator_Pool3d_Test0) {
   auto pool3d   = Operator::Get("pool3d");
   Operator temp = *pool3d;
@@ -542,6 +606,71 @@ TEST(Operator, Operator_Transpose_Test0) {
   ASSERT_EQ(transpose->description, "This operator implements the meta op transpose.");
 }
 
+TEST(Operator, Operator_Transpose_Test1) {
+  auto transpose = Operator::Get("transpose");
+  auto strategy  = Operator::GetAttrs<StrategyFunction>("CINNStrategy");
+
+  // swap the last two dims, which is scheduled with the tiled transpose schedule on x86
+  int b = 4, m = 64, n = 48;
+  Expr B(b), M(m), N(n);
+  Placeholder<float> A("A", {B, M, N});
+
+  NodeAttr attrs;
+  std::vector<int> axis    = {0, 2, 1};
+  attrs.attr_store["axis"] = axis;
+  std::vector<ir::Tensor> inputs{A.tensor()};
+  std::vector<Type> type{Float(32)};
+  common::Target target = common::DefaultHostTarget();
+
+  auto input_shape  = {b, m, n};
+  auto output_shape = {b, n, m};
+
+  auto impl = OpStrategy::SelectImpl(strategy[transpose](attrs, inputs, type, {output_shape}, target));
+  common::CINNValuePack cinn_input = common::CINNValuePack{{common::CINNValue(A)}};
+  common::CINNValuePack rets       = impl->fcompute(cinn_input);
+  rets                             = impl->fschedule(rets);
+  ASSERT_EQ(rets.size(), 2UL);
+
+  // the last element is a StageMap
+  for (int i = 0; i < rets->size() - 1; i++) {
+    Expr temp = rets[i];
+    inputs.push_back(temp.as_tensor_ref());
+  }
+  auto func = Lower("transpose_tiled", rets.back(), inputs);
+  LOG(INFO) << "Test Strategy Codegen:\n" << func;
+
+  Module::Builder builder("module0", target);
+  builder.AddFunction(func);
+  auto jit    = backends::ExecutionEngine::Create({});
+  auto module = builder.Build();
+
+  jit->Link(module);
+  auto fn = jit->Lookup("transpose_tiled");
+  CHECK(fn);
+  auto fn_ = reinterpret_cast<void (*)(void *, int32_t)>(fn);
+
+  cinn_buffer_t *A_buf = common::BufferBuilder(Float(32), input_shape).set_random().Build();
+  cinn_buffer_t *B_buf = common::BufferBuilder(Float(32), output_shape).set_random().Build();
+  cinn_pod_value_t a_arg(A_buf), b_arg(B_buf);
+  cinn_pod_value_t args[] = {a_arg, b_arg};
+  fn_(args, 2);
+
+  auto input  = reinterpret_cast<float *>(A_buf->memory);
+  auto output = reinterpret_cast<float *>(B_buf->memory);
+
+  for (int idx = 0; idx < b; ++idx) {
+    for (int idy = 0; idy < n; ++idy) {
+      for (int idz = 0; idz < m; ++idz) {
+        // (b, n, m) (idx, idy, idz)
+        int index = idx * (n * m) + idy * m + idz;
+        // (b, m, n) (idx, idz, idy)
+        int _index = idx * (m * n) + idz * n + idy;
+        ASSERT_EQ(output[index], input[_index]);
+      }
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -0,0 +1,118 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+
+// The optimizer operators update the parameters element-wisely, they are decomposed into the primitive elementwise
+// operators fused into one kernel. So many parameters coalesced into one flat buffer by the caller are updated in one
+// launch.
+namespace {
+
+// check the tensors updated together have the same shape as the parameter, and the learning rate is a scalar
+void CheckOptimizerInputs(const std::vector<framework::shape_t> &inputs_shape,
+                          const std::vector<int> &param_like_indices,
+                          int learning_rate_index,
+                          const std::string &op_name) {
+  auto &param_shape = inputs_shape[0];
+  for (int i : param_like_indices) {
+    CHECK(inputs_shape[i] == param_shape)
+        << "The " << i << "-th input of " << op_name << " should have the same shape as the parameter, but received "
+        << utils::Join(inputs_shape[i], ",") << " and " << utils::Join(param_shape, ",");
+  }
+  CHECK(inputs_shape[learning_rate_index] == framework::shape_t({1}))
+      << "The learning rate of " << op_name << " should be a scalar tensor of shape [1], but received "
+      << utils::Join(inputs_shape[learning_rate_index], ",");
+}
+
+}  // namespace
+
+// inputs: param, grad, learning_rate, outputs: param_out
+std::vector<framework::shape_t> InferShapeForSgd(const std::vector<framework::shape_t> &inputs_shape,
+                                                 const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 3U) << "The input's size of sgd is not 3! Please check again.";
+  CheckOptimizerInputs(inputs_shape, {1}, 2, "sgd");
+  return {inputs_shape[0]};
+}
+
+std::vector<Type> InferDtypeForSgd(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0]};
+}
+
+// inputs: param, grad, velocity, learning_rate, outputs: param_out, velocity_out
+std::vector<framework::shape_t> InferShapeForMomentum(const std::vector<framework::shape_t> &inputs_shape,
+                                                      const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 4U) << "The input's size of momentum is not 4! Please check again.";
+  CheckOptimizerInputs(inputs_shape, {1, 2}, 3, "momentum");
+  return {inputs_shape[0], inputs_shape[0]};
+}
+
+std::vector<Type> InferDtypeForMomentum(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0]};
+}
+
+// inputs: param, grad, learning_rate, moment1, moment2, beta1_pow, beta2_pow
+// outputs: param_out, moment1_out, moment2_out, beta1_pow_out, beta2_pow_out
+std::vector<framework::shape_t> InferShapeForAdam(const std::vector<framework::shape_t> &inputs_shape,
+                                                  const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 7U) << "The input's size of adam is not 7! Please check again.";
+  CheckOptimizerInputs(inputs_shape, {1, 3, 4}, 2, "adam");
+  CHECK(inputs_shape[5] == framework::shape_t({1})) << "beta1_pow of adam should be a scalar tensor of shape [1]";
+  CHECK(inputs_shape[6] == framework::shape_t({1})) << "beta2_pow of adam should be a scalar tensor of shape [1]";
+  return {inputs_shape[0], inputs_shape[0], inputs_shape[0], inputs_shape[5], inputs_shape[6]};
+}
+
+std::vector<Type> InferDtypeForAdam(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0], inputs_type[0], inputs_type[0], inputs_type[0]};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(optimizer_ops) {
+  CINN_REGISTER_OP(sgd)
+      .describe("Update the parameter by the stochastic gradient descent.")
+      .set_num_inputs(3)
+      .set_num_outputs(1)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForSgd))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForSgd))
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(momentum)
+      .describe("Update the parameter and the velocity by the momentum method.")
+      .set_num_inputs(4)
+      .set_num_outputs(2)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForMomentum))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForMomentum))
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(adam)
+      .describe("Update the parameter and the moments by the adaptive moment estimation.")
+      .set_num_inputs(7)
+      .set_num_outputs(5)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForAdam))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForAdam))
+      .set_support_level(4);
+
+  return true;
+}
@@ -21,6 +21,7 @@
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/framework/op_strategy.h"
 #include "cinn/hlir/pe/broadcast.h"
+#include "cinn/hlir/pe/nn.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/hlir/pe/transform.h"
 #include "cinn/ir/ir_operators.h"
@@ -220,6 +221,89 @@ std::shared_ptr<OpStrategy> StrategyForBnGradBiasScaleReduce(const framework::No
   return strategy;
 }
 
+std::shared_ptr<OpStrategy> StrategyForBnMeanVarianceWelford(const framework::NodeAttr &attrs,
+                                                             const std::vector<ir::Tensor> &inputs,
+                                                             const std::vector<Type> &out_type,
+                                                             const std::vector<std::vector<int>> &output_shapes,
+                                                             const Target &target) {
+  CHECK_EQ(inputs.size(), 1) << "bn_mean_variance_welford should has 1 input!";
+  std::string data_layout = "NCHW";
+  if (attrs.attr_store.count("data_layout")) {
+    data_layout = absl::get<std::string>(attrs.attr_store.at("data_layout"));
+  }
+
+  framework::CINNCompute bn_mean_variance_welford_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of bn_mean_variance_welford compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK(!a.empty()) << "at least one input tensor for bn_mean_variance_welford compute.";
+    Expr A = a[0];
+    CHECK(A.as_tensor());
+    auto x = A.as_tensor_ref();
+
+    auto stages = CreateStages({x});
+    auto out    = pe::BatchNormStatsCPU(x, data_layout, UniqName("bn_mean_variance_welford_out"));
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  // the statistics are computed by the extern call, there is nothing to schedule
+  framework::CINNSchedule bn_mean_variance_welford_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of bn_mean_variance_welford schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 4UL);
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of bn_mean_variance_welford op is empty! Please check.";
+  CHECK(target.arch == Target::Arch::X86) << "bn_mean_variance_welford op is only implemented on X86!";
+  if (out_type[0] == Float(32)) {
+    strategy->AddImpl(bn_mean_variance_welford_compute,
+                      bn_mean_variance_welford_schedule,
+                      "strategy.bn_mean_variance_welford.x86",
+                      1);
+  } else {
+    LOG(FATAL) << "bn_mean_variance_welford op with dtype != float32 is not implemented yet!";
+  }
+  return strategy;
+}
+
+// outputs: mean and variance of shape [c], and the extern call of shape [1]
+std::vector<shape_t> InferShapeForBnMeanVarianceWelford(const std::vector<shape_t> &inputs_shape,
+                                                        const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1UL) << "The input's size of bn_mean_variance_welford is not 1! Please check again.";
+  std::string data_layout = "NCHW";
+  if (attrs.count("data_layout")) {
+    data_layout = absl::get<std::string>(attrs.at("data_layout"));
+  }
+  auto &x_shape = inputs_shape[0];
+  int channel   = 0;
+  if (data_layout == "NCHW") {
+    CHECK_EQ(x_shape.size(), 4UL) << "The input of NCHW bn_mean_variance_welford should be 4-D";
+    channel = x_shape[1];
+  } else if (data_layout == "NHWC") {
+    CHECK_EQ(x_shape.size(), 4UL) << "The input of NHWC bn_mean_variance_welford should be 4-D";
+    channel = x_shape[3];
+  } else if (data_layout == "NCHWc") {
+    CHECK_EQ(x_shape.size(), 5UL) << "The input of NCHWc bn_mean_variance_welford should be 5-D";
+    channel = x_shape[1] * x_shape[4];
+  } else {
+    LOG(FATAL) << "bn_mean_variance_welford doesn't support the data layout " << data_layout;
+  }
+  return {{channel}, {channel}, {1}};
+}
+
+std::vector<Type> InferDtypeForBnMeanVarianceWelford(const std::vector<Type> &inputs_type,
+                                                     const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0], inputs_type[0]};
+}
+
 std::vector<shape_t> InferShapeForBNReduce(const std::vector<shape_t> &inputs_shape,
                                            const framework::AttrMapType &attrs) {
   CHECK(inputs_shape.size() == 3UL || inputs_shape.size() == 1UL);
@@ -442,6 +526,17 @@ CINN_REGISTER_HELPER(reduce_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(bn_mean_variance_welford)
+      .describe("This operator computes the mean and variance of batch norm by Welford's algorithm in one pass on CPU")
+      .set_num_inputs(1)
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy",
+                                                         cinn::hlir::op::StrategyForBnMeanVarianceWelford)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForBnMeanVarianceWelford))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForBnMeanVarianceWelford))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(bn_grad_bias_scale_reduce)
       .describe("This operator implements the optimization of bn grad reduce")
       .set_num_inputs(3)
@@ -14,6 +14,8 @@
 
 #include "cinn/hlir/pe/transform.h"
 
+#include <algorithm>
+
 #include "cinn/common/cas.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -21,6 +23,9 @@
 #include "cinn/hlir/pe/nn.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_printer.h"
+#ifdef CINN_WITH_MKL_CBLAS
+#include "cinn/runtime/cpu/cblas.h"
+#endif
 
 namespace cinn {
 namespace hlir {
@@ -774,6 +779,114 @@ std::vector<std::vector<std::string>> InferLayoutForMul(const std::vector<framew
   return {{"", ""}, new_input_layouts};
 }
 
+#ifdef CINN_WITH_MKL_CBLAS
+std::shared_ptr<OpStrategy> StrategyForGemmPackB(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<Type> &out_type,
+                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                 const Target &target) {
+  framework::CINNCompute pack_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of gemm_pack_b compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK_GE(a.size(), 1U) << "at least 1 input tensor for gemm_pack_b compute\n";
+    Expr B = a[0];
+    CHECK(B.as_tensor());
+    int m        = absl::get<int>(attrs.attr_store.at("m"));
+    int n        = absl::get<int>(attrs.attr_store.at("n"));
+    int k        = absl::get<int>(attrs.attr_store.at("k"));
+    bool trans_b = absl::get<bool>(attrs.attr_store.at("trans_b"));
+    float alpha  = absl::get<float>(attrs.attr_store.at("alpha"));
+
+    auto B_tensor = B.as_tensor_ref();
+    auto stages   = CreateStages({B_tensor});
+    // flatten to 2 dims, new_B: [K, N] or [N, K] if trans_b
+    auto new_B = B_tensor->Reshape({Expr(trans_b ? n : k), Expr(trans_b ? k : n)}, stages);
+    auto out   = pe::PackBMKL(new_B, m, n, k, trans_b, alpha, UniqName("PackBMKL_output"), target);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule pack_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of gemm_pack_b schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 3UL);
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(pack_compute, pack_schedule, "strategy.gemm_pack_b.x86", 1);
+  return strategy;
+}
+
+std::vector<std::vector<int>> InferShapeForGemmPackB(const std::vector<std::vector<int>> &inputs_shape,
+                                                     const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 1U) << "The input's shape size should be 1! Please check again.";
+  int m = absl::get<int>(attrs.at("m"));
+  int n = absl::get<int>(attrs.at("n"));
+  int k = absl::get<int>(attrs.at("k"));
+  return {{cinn_cpu_mkl_gemm_packed_b_size_fp32(m, n, k)}, {1}};
+}
+
+std::shared_ptr<OpStrategy> StrategyForGemmPacked(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  framework::CINNCompute gemm_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of gemm_packed compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK_GE(a.size(), 2U) << "at least 2 input tensors for gemm_packed compute\n";
+    Expr A        = a[0];
+    Expr packed_B = a[1];
+    CHECK(A.as_tensor());
+    CHECK(packed_B.as_tensor());
+    int m        = absl::get<int>(attrs.attr_store.at("m"));
+    int n        = absl::get<int>(attrs.attr_store.at("n"));
+    int k        = absl::get<int>(attrs.attr_store.at("k"));
+    bool trans_a = absl::get<bool>(attrs.attr_store.at("trans_a"));
+
+    auto A_tensor = A.as_tensor_ref();
+    auto B_tensor = packed_B.as_tensor_ref();
+    auto stages   = CreateStages({A_tensor, B_tensor});
+    // flatten to 2 dims, new_A: [M, K] or [K, M] if trans_a
+    auto new_A = A_tensor->Reshape({Expr(trans_a ? k : m), Expr(trans_a ? m : k)}, stages);
+    auto out   = pe::MatmulPackedMKL(new_A, B_tensor, m, n, k, trans_a, UniqName("MatmulPackedMKL_output"), target);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    CHECK(!out_type.empty()) << "Output type of gemm_packed is empty! Please check.\n";
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule gemm_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of gemm_packed schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 3UL);
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(gemm_compute, gemm_schedule, "strategy.gemm_packed.x86", 1);
+  return strategy;
+}
+
+std::vector<std::vector<int>> InferShapeForGemmPacked(const std::vector<std::vector<int>> &inputs_shape,
+                                                      const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  int m = absl::get<int>(attrs.at("m"));
+  int n = absl::get<int>(attrs.at("n"));
+  return {{m, n}, {1}};
+}
+#endif
+
 std::vector<std::vector<int>> InferShapeForMulBias(const std::vector<std::vector<int>> &inputs_shape,
                                                    const framework::AttrMapType &attrs) {
   // CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
@@ -828,15 +941,16 @@ std::shared_ptr<OpStrategy> StrategyForLayoutTransform(const framework::NodeAttr
                                                        const std::vector<Type> &out_type,
                                                        const std::vector<std::vector<int>> &output_shapes,
                                                        const Target &target) {
+  std::string src_layout;
+  std::string dst_layout;
+  if (attrs.attr_store.find("src_layout") != attrs.attr_store.end()) {
+    src_layout = absl::get<std::string>(attrs.attr_store.at("src_layout"));
+  }
+  if (attrs.attr_store.find("dst_layout") != attrs.attr_store.end()) {
+    dst_layout = absl::get<std::string>(attrs.attr_store.at("dst_layout"));
+  }
+
   framework::CINNCompute layout_transform_compute([=](lang::Args args, lang::RetValue *ret) {
-    std::string src_layout;
-    std::string dst_layout;
-    if (attrs.attr_store.find("src_layout") != attrs.attr_store.end()) {
-      src_layout = absl::get<std::string>(attrs.attr_store.at("src_layout"));
-    }
-    if (attrs.attr_store.find("dst_layout") != attrs.attr_store.end()) {
-      dst_layout = absl::get<std::string>(attrs.attr_store.at("dst_layout"));
-    }
     CHECK(!args.empty()) << "The input argument of layout_transform compute is empty! Please check.\n";
     CINNValuePack a = args[0];
     CHECK(!a.empty()) << "at least one input tensor for layout_transform compute\n";
@@ -864,7 +978,8 @@ std::shared_ptr<OpStrategy> StrategyForLayoutTransform(const framework::NodeAttr
       out_shape.push_back(shape.as_int32());
     }
     if (target.arch == Target::Arch::X86) {
-      pe::ScheduleInjectiveCPU(stages[tensor_out], out_shape, target);
+      int src_inner_axis = pe::GetLayoutTransformInnerAxis(src_layout, dst_layout);
+      pe::TransposeScheduleCPU(stages[tensor_out], out_shape, src_inner_axis, target);
     }
     *ret = arg_pack;
   });
@@ -1029,6 +1144,104 @@ std::vector<std::vector<std::string>> InferLayoutForLayoutTransform(const std::v
   return {{dst_layout}, {src_layout}};
 }
 
+std::shared_ptr<OpStrategy> StrategyForGather(const framework::NodeAttr &attrs,
+                                              const std::vector<ir::Tensor> &inputs,
+                                              const std::vector<Type> &out_type,
+                                              const std::vector<std::vector<int>> &output_shapes,
+                                              const Target &target) {
+  CHECK_EQ(inputs.size(), 2U) << "The input tensors of gather should be 2! Please check.\n";
+  int axis        = 0;
+  int padding_idx = -1;
+  if (attrs.attr_store.find("axis") != attrs.attr_store.end()) {
+    axis = absl::get<int>(attrs.attr_store.at("axis"));
+  }
+  if (attrs.attr_store.find("padding_idx") != attrs.attr_store.end()) {
+    padding_idx = absl::get<int>(attrs.attr_store.at("padding_idx"));
+  }
+  int rank = inputs[0]->shape.size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  CHECK(axis >= 0 && axis < rank) << "axis is not in [-n_dim, n_dim), Please check.";
+
+  framework::CINNCompute gather_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of gather compute is empty! Please check.\n";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 2U) << "2 input tensors for gather compute\n";
+    Expr A     = a[0];
+    Expr Index = a[1];
+    CHECK(A.as_tensor());
+    CHECK(Index.as_tensor());
+    auto out =
+        pe::Gather(A.as_tensor_ref(), Index.as_tensor_ref(), axis, padding_idx, UniqName("Gather_output"));
+    auto stages = CreateStages({A.as_tensor_ref(), Index.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule gather_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of gather schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    Expr out              = arg_pack[0];
+    poly::StageMap stages = arg_pack[1];
+    CHECK(out.as_tensor());
+    if (target.arch == Target::Arch::NVGPU) {
+      pe::CudaScheduleInjective(stages[out.as_tensor_ref()], output_shapes[0], target);
+    } else if (target.arch == Target::Arch::X86) {
+      // the picked slices are contiguous unless gathering along the last axis, e.g. the rows of an embedding table
+      // are copied with vector loads and stores
+      pe::ScheduleInjectiveCPU(stages[out.as_tensor_ref()], output_shapes[0], target, axis != rank - 1);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  CHECK(out_type.size()) << "Out_type of gather op is empty! Please check.";
+  if (out_type[0] == Float(32)) {
+    strategy->AddImpl(gather_compute, gather_schedule, "strategy.gather.x86", 1);
+  } else {
+    LOG(FATAL) << "Gather op with dtype != float32 is not implemented yet!";
+  }
+  return strategy;
+}
+
+std::vector<framework::shape_t> InferShapeForGather(const std::vector<framework::shape_t> &inputs_shape,
+                                                    const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  auto &x_shape = inputs_shape[0];
+  int axis      = 0;
+  if (attrs.find("axis") != attrs.end()) {
+    axis = absl::get<int>(attrs.at("axis"));
+  }
+  if (axis < 0) {
+    axis += x_shape.size();
+  }
+  CHECK(axis >= 0 && axis < x_shape.size()) << "axis is not in [-n_dim, n_dim), Please check.";
+  framework::shape_t out_shape(x_shape.begin(), x_shape.begin() + axis);
+  out_shape.insert(out_shape.end(), inputs_shape[1].begin(), inputs_shape[1].end());
+  out_shape.insert(out_shape.end(), x_shape.begin() + axis + 1, x_shape.end());
+  return {out_shape};
+}
+
+std::vector<Type> InferDtypeForGather(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The input's type size should be 2! Please check again.";
+  CHECK(inputs_type[1].is_int(32) || inputs_type[1].is_int(64))
+      << "The index of gather should be int32 or int64! Please check again.";
+  return {inputs_type[0]};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForGather(const std::vector<framework::shape_t> &input_shapes,
+                                                           const std::vector<std::string> &input_layouts,
+                                                           const framework::NodeAttr &attrs,
+                                                           const Target &target) {
+  CHECK_EQ(input_layouts.size(), 2U) << "The input's layout size is not 2! Please check again.";
+  if (input_shapes[0].size() > 4) {
+    // the gather axis is defined on the original layout
+    return {{""}, {"NCHW", input_layouts[1]}};
+  }
+  return {{""}, input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForTranspose(const framework::NodeAttr &attrs,
                                                  const std::vector<ir::Tensor> &inputs,
                                                  const std::vector<Type> &out_type,
@@ -1076,6 +1289,10 @@ std::shared_ptr<OpStrategy> StrategyForTranspose(const framework::NodeAttr &attr
     CHECK(out.as_tensor());
     if (target.arch == Target::Arch::NVGPU) {
       pe::CudaScheduleInjective(stages[out.as_tensor_ref()], output_shapes[0], target);
+    } else if (target.arch == Target::Arch::X86) {
+      // the output axis which walks the innermost axis of input
+      int src_inner_axis = std::find(axis.begin(), axis.end(), static_cast<int>(axis.size()) - 1) - axis.begin();
+      pe::TransposeScheduleCPU(stages[out.as_tensor_ref()], output_shapes[0], src_inner_axis, target);
     }
     *ret = arg_pack;
   });
@@ -1207,6 +1424,19 @@ CINN_REGISTER_HELPER(transform_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(gather)
+      .describe("This operator picks the slices of X along axis by Index, as in an embedding lookup.")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForGather)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForGather))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForGather))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForGather))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kInjective)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(transpose)
       .describe("This operator implements the meta op transpose.")
       .set_num_inputs(1)
@@ -1248,6 +1478,28 @@ CINN_REGISTER_HELPER(transform_ops) {
                                                       cinn::hlir::framework::OpPatternKind::kOutEWiseFusable)
       .set_support_level(4);
 
+#ifdef CINN_WITH_MKL_CBLAS
+  CINN_REGISTER_OP(gemm_pack_b)
+      .describe("This operator packs the constant matrix Y of a matrix multiplication into the layout of MKL once.")
+      .set_num_inputs(1)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForGemmPackB)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForGemmPackB))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForMul))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(gemm_packed)
+      .describe("This operator is used to perform matrix multiplication for input X and Y packed by gemm_pack_b.")
+      .set_num_inputs(2)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForGemmPacked)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForGemmPacked))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForMul))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+#endif
+
   CINN_REGISTER_OP(layout_transform)
       .describe("This operator is used to transform op's layouts")
       .set_num_inputs(1)
@@ -23,3 +23,4 @@ CINN_USE_REGISTER(broadcast_grad_ops)
 CINN_USE_REGISTER(elementwise_ops)
 CINN_USE_REGISTER(transform_ops)
 CINN_USE_REGISTER(reduce_ops)
+CINN_USE_REGISTER(optimizer_ops)
@@ -82,6 +82,13 @@ TEST(const_conv, const_conv) {
 
   hlir::framework::ApplyPass(graph.get(), "InferShape");
   hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  // the filter is constant while the input is not
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == "conv2d") {
+      ASSERT_FALSE(node->attrs.attr_store.count("pre_run"));
+    }
+  }
   auto scope = BuildScope(target, graph);
 
   hlir::framework::GraphCompiler gc(target, scope, graph);
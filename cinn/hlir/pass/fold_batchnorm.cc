@@ -0,0 +1,219 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+
+namespace {
+
+// Builds the op nodes computing the folded weights and bias. All of their inputs are constants, so ConstPropagate
+// marks them pre_run and they are computed only once before running.
+class ConstBuilder {
+ public:
+  ConstBuilder(Graph* graph, ShapeDict* shape_dict, TypeDict* type_dict)
+      : graph_(graph), shape_dict_(shape_dict), type_dict_(type_dict) {}
+
+  NodeData* Scale(NodeData* x, float scale, float bias) {
+    framework::AttrMapType attrs;
+    attrs["scale"] = scale;
+    attrs["bias"]  = bias;
+    return AddOp("scale", {x}, attrs);
+  }
+  NodeData* Rsqrt(NodeData* x) { return AddOp("rsqrt", {x}); }
+  NodeData* Add(NodeData* x, NodeData* y) { return AddOp("elementwise_add", {x, y}); }
+  NodeData* Sub(NodeData* x, NodeData* y) { return AddOp("substract", {x, y}); }
+  NodeData* Mul(NodeData* x, NodeData* y, int axis = -1) {
+    framework::AttrMapType attrs;
+    attrs["axis"] = axis;
+    return AddOp("elementwise_mul", {x, y}, attrs);
+  }
+
+ private:
+  NodeData* AddOp(const std::string& op_type,
+                  const std::vector<NodeData*>& inputs,
+                  const framework::AttrMapType& attrs = {}) {
+    auto* node = new Node(Operator::Get(op_type), op_type, common::UniqName(op_type + "_folded"));
+    std::shared_ptr<Node> node_ptr(node);
+    node->attrs.attr_store = attrs;
+    for (auto* input : inputs) {
+      CHECK(input->is_const());
+      input->LinkTo(node);
+    }
+    auto* output = new NodeData(node_ptr, 0, 0, common::UniqName(node->id() + "_out"), true);
+    node->LinkTo(output);
+    graph_->RegisterNode(node->id(), node);
+    graph_->RegisterNode(output->id(), output);
+    InferOutputs(node, shape_dict_, type_dict_);
+    return output;
+  }
+
+  Graph* graph_;
+  ShapeDict* shape_dict_;
+  TypeDict* type_dict_;
+};
+
+// the ops computing y = x * W whose output channel is axis 1 of y and axis 0 of the weight W
+bool IsFoldableProducer(const Node* node, const ShapeDict& shape_dict) {
+  auto& op_name = node->op()->name;
+  if (op_name != "conv2d" && op_name != "depthwise_conv2d" && op_name != "mul") return false;
+  if (node->inlinks().size() != 2U || !GetInput(node, 1)->is_const()) return false;
+  auto& weight_shape = shape_dict.at(GetInput(node, 1)->id());
+  if (op_name == "mul") {
+    return weight_shape.size() == 2U && GetAttr<int>(node, "y_num_col_dims", 1) == 1 &&
+           shape_dict.at(GetOutput(node, 0)->id()).size() == 2U;
+  }
+  if (GetAttr<std::string>(node, "data_format", "NCHW") != "NCHW" ||
+      GetAttr<std::string>(node, "conv_type", "forward") != "forward") {
+    return false;
+  }
+  // depthwise_conv2d with channel_multiplier > 1 interleaves the output channels
+  return op_name == "conv2d" || weight_shape[1] == 1;
+}
+
+// y -> elementwise_add(y, c): c is a constant bias on the channel axis
+bool IsChannelBiasAdd(const Node* node, const NodeData* y, const ShapeDict& shape_dict) {
+  if (node->op()->name != "elementwise_add" || node->inlinks().size() != 2U) return false;
+  if (GetInput(node, 0) != y) return false;
+  auto* bias       = GetInput(node, 1);
+  auto& y_shape    = shape_dict.at(y->id());
+  auto& bias_shape = shape_dict.at(bias->id());
+  int axis         = GetAttr<int>(node, "axis", -1);
+  if (axis < 0) axis = y_shape.size() - bias_shape.size();
+  return bias->is_const() && axis == 1 && bias_shape == framework::shape_t({y_shape[1]});
+}
+
+// producer(x, W) -> y [-> elementwise_add(y, c) -> z] -> affine: rewrite the weight W and the bias c to absorb the
+// per-channel affine transform, and turn the affine node itself into the bias add
+bool FoldAffine(Graph* graph, Node* producer, ShapeDict* shape_dict, TypeDict* type_dict) {
+  auto* y    = GetOutput(producer, 0);
+  auto* next = GetOnlyConsumer(y);
+  // the weight is rewritten in place, so a fetched y would hold the folded result
+  if (!next || IsGraphOutput(graph, y)) return false;
+  Node* bias_add = nullptr;
+  NodeData* c    = nullptr;
+  NodeData* z    = y;
+  if (IsChannelBiasAdd(next, y, *shape_dict)) {
+    bias_add = next;
+    c        = GetInput(bias_add, 1);
+    z        = GetOutput(bias_add, 0);
+    next     = GetOnlyConsumer(z);
+    if (!next || IsGraphOutput(graph, z)) return false;
+  }
+  if (GetInput(next, 0) != z) return false;
+
+  ConstBuilder builder(graph, shape_dict, type_dict);
+  auto* weight = GetInput(producer, 1);
+  NodeData* new_weight;
+  NodeData* new_bias;
+  if (next->op()->name == "batchnorm") {
+    // batchnorm needs a 4-D input, so only the convolutions reach here
+    if (next->inlinks().size() != 5U) return false;
+    for (int i = 1; i < 5; i++) {
+      if (!GetInput(next, i)->is_const()) return false;
+    }
+    auto* gamma   = GetInput(next, 1);
+    auto* beta    = GetInput(next, 2);
+    auto* mean    = GetInput(next, 3);
+    auto* var     = GetInput(next, 4);
+    float epsilon = GetAttr<float>(next, "epsilon", 0.00001f);
+    // bn(z) = (z - mean) * s + beta, s = gamma / sqrt(var + epsilon)
+    auto* s    = builder.Mul(gamma, builder.Rsqrt(builder.Scale(var, 1.f, epsilon)));
+    new_weight = builder.Mul(weight, s, 0);
+    new_bias   = builder.Add(beta, builder.Mul(c ? builder.Sub(c, mean) : builder.Scale(mean, -1.f, 0.f), s));
+  } else if (next->op()->name == "scale" && c) {
+    float scale           = GetAttr<float>(next, "scale", 1.f);
+    float bias            = GetAttr<float>(next, "bias", 0.f);
+    bool bias_after_scale = GetAttr<bool>(next, "bias_after_scale", true);
+    new_weight            = builder.Scale(weight, scale, 0.f);
+    new_bias              = builder.Scale(c, scale, bias_after_scale ? bias : bias * scale);
+  } else {
+    return false;
+  }
+  VLOG(3) << "Fold " << next->id() << " into the weight " << weight->id() << " of " << producer->id();
+
+  ResetInputs(producer, {GetInput(producer, 0), new_weight});
+  if (bias_add) {
+    UnlinkNode(bias_add);
+  }
+  // keep the output of the affine node so that the fetched variables are unchanged
+  next->attrs.op         = Operator::Get("elementwise_add");
+  next->attrs.node_name  = "elementwise_add";
+  next->attrs.attr_store.clear();
+  next->attrs.attr_store["axis"] = 1;
+  ResetInputs(next, {y, new_bias});
+  InferOutputs(producer, shape_dict, type_dict);
+  InferOutputs(next, shape_dict, type_dict);
+  return true;
+}
+
+}  // namespace
+
+void FoldBatchNormPass(Graph* graph) {
+  auto& shape_dict = graph->GetMutableAttrs<ShapeDict>("infershape");
+  auto& type_dict  = graph->GetMutableAttrs<TypeDict>("inferdtype");
+  int folded_count = 0;
+  bool changed     = true;
+  while (changed) {
+    changed          = false;
+    auto store_nodes = std::get<0>(graph->topological_order());
+    for (auto* graph_node : store_nodes) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node && IsFoldableProducer(node, shape_dict) && FoldAffine(graph, node, &shape_dict, &type_dict)) {
+        changed = true;
+        folded_count++;
+        break;
+      }
+    }
+  }
+  VLOG(3) << "FoldBatchNorm pass folded " << folded_count << " ops";
+  if (folded_count > 0) {
+    absl::flat_hash_map<std::string, std::string> layout_dict;
+    graph->ClearUnlinkedNodes(&shape_dict, &type_dict, &layout_dict);
+  }
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(FoldBatchNorm) {
+  CINN_REGISTER_PASS(FoldBatchNorm)
+      .describe(
+          "This pass folds the batchnorm with constant parameters, and the scale after a constant bias, into the "
+          "constant weight and bias of the preceding conv2d, depthwise_conv2d or mul. The folded weight and bias are "
+          "computed by constant ops which ConstPropagate marks to pre_run.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::FoldBatchNormPass);
+  return true;
+}
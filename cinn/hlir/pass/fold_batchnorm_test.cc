@@ -0,0 +1,182 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/test_helper.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+// the number of ops running on every execution
+int CountRunOps(hlir::framework::Graph* graph) {
+  int count = 0;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && !node->attrs.attr_store.count("pre_run")) {
+      count++;
+    }
+  }
+  return count;
+}
+
+std::vector<float> RunProgram(const Program& program,
+                              bool fold,
+                              const absl::flat_hash_map<std::string, std::vector<float>>& inputs,
+                              const std::string& output_id) {
+  Target target = GetTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  if (fold) {
+    hlir::framework::ApplyPass(graph.get(), "FoldBatchNorm");
+    EXPECT_EQ(CountOps(graph.get(), "batchnorm"), 0);
+  }
+  hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+  if (fold) {
+    // only the producer and the bias add remain in the runtime
+    EXPECT_EQ(CountRunOps(graph.get()), 3);
+  }
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  for (auto& input : inputs) {
+    SetData(scope->GetTensor(input.first), input.second, target);
+  }
+  runtime_program->PreRun();
+  runtime_program->Execute();
+  return GetData(scope->GetTensor(output_id));
+}
+
+void CheckResults(const std::vector<float>& expect, const std::vector<float>& actual) {
+  ASSERT_EQ(expect.size(), actual.size());
+  for (int i = 0; i < expect.size(); i++) {
+    ASSERT_NEAR(expect[i], actual[i], 1e-4 * std::max(1.f, std::abs(expect[i])));
+  }
+}
+
+TEST(FoldBatchNorm, conv2d_bias_batchnorm_scale) {
+  Placeholder A(Float(32), {1, 8, 16, 16}, "A");
+  Placeholder W(Float(32), {16, 8, 3, 3}, "W", true);
+  Placeholder C(Float(32), {16}, "C", true);
+  Placeholder Scale(Float(32), {16}, "Scale", true);
+  Placeholder Bias(Float(32), {16}, "Bias", true);
+  Placeholder Mean(Float(32), {16}, "Mean", true);
+  Placeholder Variance(Float(32), {16}, "Variance", true);
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> conv_attrs;
+  conv_attrs["stride"]      = std::vector<int>({1, 1});
+  conv_attrs["dilation"]    = std::vector<int>({1, 1});
+  conv_attrs["padding"]     = std::vector<int>({1, 1});
+  conv_attrs["data_format"] = std::string("NCHW");
+  auto conv                 = program.conv2d(A, W, conv_attrs);
+  auto biased               = program.elementwise_add(conv, C, 1);
+  absl::flat_hash_map<std::string, Program::attr_t> bn_attrs;
+  bn_attrs["epsilon"] = 0.001f;
+  auto bn             = program.batchnorm(biased, Scale, Bias, Mean, Variance, bn_attrs);
+  absl::flat_hash_map<std::string, Program::attr_t> scale_attrs;
+  scale_attrs["scale"] = 2.f;
+  scale_attrs["bias"]  = 0.5f;
+  auto scaled          = program.scale(bn, scale_attrs);
+  auto out             = program.relu(scaled);
+  program.SetInputs({A, W, C, Scale, Bias, Mean, Variance});
+  program.Validate();
+
+  absl::flat_hash_map<std::string, std::vector<float>> inputs = {
+      {std::string(A.id()), RandomData(1 * 8 * 16 * 16)},
+      {std::string(W.id()), RandomData(16 * 8 * 3 * 3)},
+      {std::string(C.id()), RandomData(16)},
+      {std::string(Scale.id()), RandomData(16)},
+      {std::string(Bias.id()), RandomData(16)},
+      {std::string(Mean.id()), RandomData(16)},
+      {std::string(Variance.id()), RandomData(16, 0.1f, 1.f)}};
+  auto expect = RunProgram(program, false, inputs, out->id);
+  auto actual = RunProgram(program, true, inputs, out->id);
+  CheckResults(expect, actual);
+}
+
+TEST(FoldBatchNorm, mul_bias_scale) {
+  Placeholder A(Float(32), {4, 32}, "A");
+  Placeholder W(Float(32), {16, 32}, "W", true);
+  Placeholder C(Float(32), {16}, "C", true);
+
+  Program program;
+  auto mul    = program.mul(A, W);
+  auto biased = program.elementwise_add(mul, C, 1);
+  absl::flat_hash_map<std::string, Program::attr_t> scale_attrs;
+  scale_attrs["scale"]            = 0.5f;
+  scale_attrs["bias"]             = -1.f;
+  scale_attrs["bias_after_scale"] = false;
+  auto scaled                     = program.scale(biased, scale_attrs);
+  auto out                        = program.relu(scaled);
+  program.SetInputs({A, W, C});
+  program.Validate();
+
+  absl::flat_hash_map<std::string, std::vector<float>> inputs = {{std::string(A.id()), RandomData(4 * 32)},
+                                                                 {std::string(W.id()), RandomData(16 * 32)},
+                                                                 {std::string(C.id()), RandomData(16)}};
+  auto expect = RunProgram(program, false, inputs, out->id);
+  auto actual = RunProgram(program, true, inputs, out->id);
+  CheckResults(expect, actual);
+}
+
+// the fetched output of the conv or of its bias add must keep its value, so batchnorm isn't folded into them
+TEST(FoldBatchNorm, fetched_conv_output) {
+  Placeholder A(Float(32), {1, 8, 16, 16}, "A");
+  Placeholder W(Float(32), {16, 8, 3, 3}, "W", true);
+  Placeholder C(Float(32), {16}, "C", true);
+  Placeholder Scale(Float(32), {16}, "Scale", true);
+  Placeholder Bias(Float(32), {16}, "Bias", true);
+  Placeholder Mean(Float(32), {16}, "Mean", true);
+  Placeholder Variance(Float(32), {16}, "Variance", true);
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> conv_attrs;
+  conv_attrs["stride"]      = std::vector<int>({1, 1});
+  conv_attrs["dilation"]    = std::vector<int>({1, 1});
+  conv_attrs["padding"]     = std::vector<int>({1, 1});
+  conv_attrs["data_format"] = std::string("NCHW");
+  auto conv                 = program.conv2d(A, W, conv_attrs);
+  auto biased               = program.elementwise_add(conv, C, 1);
+  absl::flat_hash_map<std::string, Program::attr_t> bn_attrs;
+  bn_attrs["epsilon"] = 0.001f;
+  auto bn             = program.batchnorm(biased, Scale, Bias, Mean, Variance, bn_attrs);
+  program.SetInputs({A, W, C, Scale, Bias, Mean, Variance});
+  program.Validate();
+
+  Target target = GetTarget();
+  for (auto& fetch_id : {conv->id, biased->id}) {
+    auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+    graph->outputs.push_back(graph->RetrieveNode(fetch_id)->safe_as<hlir::framework::NodeData>());
+    graph->outputs.push_back(graph->RetrieveNode(bn->id)->safe_as<hlir::framework::NodeData>());
+    hlir::framework::ApplyPass(graph.get(), "InferShape");
+    hlir::framework::ApplyPass(graph.get(), "FoldBatchNorm");
+    ASSERT_EQ(CountOps(graph.get(), "batchnorm"), 1);
+    ASSERT_EQ(CountOps(graph.get(), "elementwise_add"), 1);
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,103 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+namespace {
+
+// scale(x) -> y -> softmax(y): softmax(s * x + b) equals softmax(s * x) for the scalar bias b, so the scale node is
+// dropped and s is multiplied into the scale attribute of softmax, which the fused CPU kernel applies while reading x
+bool FoldScale(const Graph* graph, Node* softmax) {
+  auto& inlinks = softmax->inlinks_in_order(true);
+  if (inlinks.size() != 1U) return false;
+  auto* y = inlinks[0]->source()->safe_as<NodeData>();
+  CHECK(y);
+  auto* scale_node = y->source_node.get();
+  if (!scale_node || scale_node->op()->name != "scale" || y->outlinks().size() != 1U) return false;
+  // a fetched y is removed with the scale node
+  if (IsGraphOutput(graph, y)) return false;
+  auto* x = scale_node->inlinks_in_order(true)[0]->source()->safe_as<NodeData>();
+  CHECK(x);
+
+  float scale = GetAttr<float>(scale_node, "scale", 1.f);
+  // for bias_after_scale false, s * (x + b) = s * x + s * b also only shifts by a scalar
+  softmax->attrs.attr_store["scale"] = GetAttr<float>(softmax, "scale", 1.f) * scale;
+  VLOG(3) << "Fold " << scale_node->id() << " into " << softmax->id() << " with scale " << scale;
+
+  x->UnLinkTo(scale_node);
+  scale_node->UnLinkTo(y);
+  y->UnLinkTo(softmax);
+  x->LinkTo(softmax);
+  // refresh the cached input order
+  softmax->inlinks_in_order(true);
+  return true;
+}
+
+}  // namespace
+
+void FoldSoftmaxScalePass(Graph* graph) {
+  if (graph->target_.arch != common::Target::Arch::X86) {
+    return;
+  }
+  int folded_count = 0;
+  auto store_nodes = std::get<0>(graph->topological_order());
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    // scale chains, e.g. scale(scale(x)), are folded one by one
+    while (node && node->op()->name == "softmax" && FoldScale(graph, node)) {
+      folded_count++;
+    }
+  }
+  VLOG(3) << "FoldSoftmaxScale pass folded " << folded_count << " ops";
+  if (folded_count > 0) {
+    auto& shape_dict = graph->GetMutableAttrs<ShapeDict>("infershape");
+    auto& type_dict  = graph->GetMutableAttrs<TypeDict>("inferdtype");
+    absl::flat_hash_map<std::string, std::string> layout_dict;
+    graph->ClearUnlinkedNodes(&shape_dict, &type_dict, &layout_dict);
+  }
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(FoldSoftmaxScale) {
+  CINN_REGISTER_PASS(FoldSoftmaxScale)
+      .describe(
+          "This pass folds the scale op before softmax into the scale attribute of softmax on X86, where the fused "
+          "softmax kernel multiplies the input while reading it. The bias of the scale op is dropped since softmax is "
+          "invariant to shifting its input.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::FoldSoftmaxScalePass);
+  return true;
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/test_helper.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+TEST(FoldSoftmaxScale, scale_softmax) {
+  Placeholder A(Float(32), {4, 8, 64}, "A");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> scale_attrs;
+  scale_attrs["scale"] = 0.125f;
+  scale_attrs["bias"]  = 3.f;
+  auto scaled          = program.scale(A, scale_attrs);
+  absl::flat_hash_map<std::string, Program::attr_t> softmax_attrs;
+  softmax_attrs["axis"] = 1;
+  auto out              = program.softmax(scaled, softmax_attrs);
+  program.SetInputs({A});
+  program.Validate();
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "FoldSoftmaxScale");
+  ASSERT_EQ(CountOps(graph.get(), "scale"), 0);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  std::vector<float> input(4 * 8 * 64);
+  for (auto& v : input) {
+    v = (rand() * 10.f) / RAND_MAX;
+  }
+  auto* input_data = scope->GetTensor(std::string(A.id()))->mutable_data<float>(target);
+  std::copy(input.begin(), input.end(), input_data);
+  runtime_program->Execute();
+
+  auto* output_data = scope->GetTensor(out->id)->data<float>();
+  for (int i = 0; i < 4; i++) {
+    for (int k = 0; k < 64; k++) {
+      float sum = 0.f;
+      for (int j = 0; j < 8; j++) {
+        sum += std::exp(input[(i * 8 + j) * 64 + k] * 0.125f);
+      }
+      for (int j = 0; j < 8; j++) {
+        int index = (i * 8 + j) * 64 + k;
+        ASSERT_NEAR(output_data[index], std::exp(input[index] * 0.125f) / sum, 1e-5);
+      }
+    }
+  }
+}
+
+TEST(FoldSoftmaxScale, fetched_scale) {
+  Placeholder A(Float(32), {4, 8, 64}, "A");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> scale_attrs;
+  scale_attrs["scale"] = 0.125f;
+  auto scaled          = program.scale(A, scale_attrs);
+  absl::flat_hash_map<std::string, Program::attr_t> softmax_attrs;
+  softmax_attrs["axis"] = 1;
+  auto out              = program.softmax(scaled, softmax_attrs);
+  program.SetInputs({A});
+  program.Validate();
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  graph->outputs.push_back(graph->RetrieveNode(scaled->id)->safe_as<hlir::framework::NodeData>());
+  graph->outputs.push_back(graph->RetrieveNode(out->id)->safe_as<hlir::framework::NodeData>());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "FoldSoftmaxScale");
+  // the scaled input is fetched, so the scale op is kept
+  ASSERT_EQ(CountOps(graph.get(), "scale"), 1);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,358 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+using framework::OpPatternKind;
+
+namespace {
+
+// the max number of layout agnostic ops a transform can be sunk through to meet another transform
+constexpr int kMaxSinkDepth = 8;
+
+bool IsTransformOp(const Node* node) {
+  return node->op()->name == "transpose" || node->op()->name == "layout_transform";
+}
+
+bool IsReductionOp(const Node* node) {
+  static std::unordered_set<std::string> reduction_ops = {"reduce_sum", "reduce_prod", "reduce_max", "reduce_min"};
+  return reduction_ops.count(node->op()->name);
+}
+
+// elementwise ops whose inputs and output share the same shape, so that they can be computed in any layout
+bool IsLayoutAgnosticOp(const Node* node) {
+  static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  // ops depend on their output shapes
+  static std::unordered_set<std::string> shape_dependent_ops = {"broadcast_to", "const_scalar", "fill_constant"};
+  if (!op_pattern_dict.Find(node->op()) || shape_dependent_ops.count(node->op()->name)) {
+    return false;
+  }
+  auto pattern = op_pattern_dict[node->op()];
+  if (pattern != framework::kElemWise && pattern != framework::kBroadcast) {
+    return false;
+  }
+  return node->outlinks().size() == 1U;
+}
+
+std::vector<int> GetTransposeAxis(const Node* node) {
+  CHECK(node->attrs.attr_store.count("axis")) << node->id() << " finds no axis attr";
+  return absl::get<std::vector<int>>(node->attrs.attr_store.at("axis"));
+}
+
+std::string GetLayoutAttr(const Node* node, const std::string& key) {
+  CHECK(node->attrs.attr_store.count(key)) << node->id() << " finds no " << key << " attr";
+  return absl::get<std::string>(node->attrs.attr_store.at(key));
+}
+
+// transpose(transpose(x, first), second) = transpose(x, ComposeAxis(first, second))
+std::vector<int> ComposeAxis(const std::vector<int>& first, const std::vector<int>& second) {
+  CHECK_EQ(first.size(), second.size());
+  std::vector<int> axis;
+  for (int idx : second) {
+    axis.push_back(first[idx]);
+  }
+  return axis;
+}
+
+bool IsIdentityAxis(const std::vector<int>& axis) {
+  for (int i = 0; i < axis.size(); i++) {
+    if (axis[i] != i) return false;
+  }
+  return true;
+}
+
+bool IsSameTransform(const Node* a, const Node* b) {
+  if (a->op() != b->op()) return false;
+  if (a->op()->name == "transpose") {
+    return GetTransposeAxis(a) == GetTransposeAxis(b);
+  }
+  return GetLayoutAttr(a, "src_layout") == GetLayoutAttr(b, "src_layout") &&
+         GetLayoutAttr(a, "dst_layout") == GetLayoutAttr(b, "dst_layout");
+}
+
+// whether the transform b undoes the transform a
+bool IsInverseTransform(const Node* a, const Node* b) {
+  if (a->op() != b->op()) return false;
+  if (a->op()->name == "transpose") {
+    return IsIdentityAxis(ComposeAxis(GetTransposeAxis(a), GetTransposeAxis(b)));
+  }
+  return GetLayoutAttr(a, "src_layout") == GetLayoutAttr(b, "dst_layout") &&
+         GetLayoutAttr(a, "dst_layout") == GetLayoutAttr(b, "src_layout");
+}
+
+// insert a copy of the transform node after the first output of producer
+void InsertTransformAfter(Graph* graph,
+                          const Node* transform,
+                          Node* producer,
+                          const framework::AttrMapType& attr_store,
+                          ShapeDict* shape_dict,
+                          TypeDict* type_dict) {
+  std::string op_type         = transform->op()->name;
+  auto* new_node              = new Node(transform->op(), op_type, common::UniqName(op_type + "_sunk"));
+  new_node->attrs.attr_store  = attr_store;
+  auto* dst_data              = GetOutput(producer, 0);
+  framework::InsertGraphOpNodeBefore(graph, new_node, producer, dst_data, 0);
+  InferOutputs(producer, shape_dict, type_dict);
+  InferOutputs(new_node, shape_dict, type_dict);
+}
+
+// whether a transform producing data can meet a transform it folds with by sinking through layout agnostic ops
+bool CanSinkToFold(const NodeData* data, const Node* transform, int depth) {
+  auto consumers = GetConsumers(data);
+  if (consumers.size() != 1U || depth > kMaxSinkDepth) return false;
+  auto* next = consumers[0];
+  if (IsTransformOp(next) && next->op() == transform->op()) {
+    // consecutive transposes are always merged into one
+    return transform->op()->name == "transpose" || IsInverseTransform(transform, next);
+  }
+  if (transform->op()->name == "transpose" && IsReductionOp(next)) {
+    return true;
+  }
+  if (IsLayoutAgnosticOp(next)) {
+    return CanSinkToFold(GetOutput(next, 0), transform, depth + 1);
+  }
+  return false;
+}
+
+// x0 -> transform -> x1 -> next -> x2: remove the inverse pair, or merge two transposes into one
+bool FoldTransformPair(const Graph* graph, Node* transform, Node* next) {
+  auto* x0 = GetInput(transform, 0);
+  auto* x1 = GetOutput(transform, 0);
+  auto* x2 = GetOutput(next, 0);
+  // x1 is removed in both cases
+  if (IsGraphOutput(graph, x1)) return false;
+  if (IsInverseTransform(transform, next)) {
+    auto consumers  = GetConsumers(x2);
+    bool can_bypass = !IsGraphOutput(graph, x2);
+    for (auto* consumer : consumers) {
+      // the consumer has already linked to x0
+      if (x0->IsLinkedTo(consumer)) can_bypass = false;
+    }
+    if (can_bypass) {
+      for (auto* consumer : consumers) {
+        ReplaceInput(consumer, x2, x0);
+      }
+      UnlinkNode(next);
+    } else {
+      // x2 is an output of the graph or can't be bypassed, keep it with a copy of x0
+      ReplaceInput(next, x1, x0);
+      next->attrs.op        = Operator::Get("identity");
+      next->attrs.node_name = "identity";
+      next->attrs.attr_store.clear();
+    }
+    VLOG(3) << "Cancel the inverse transform pair: " << transform->id() << ", " << next->id();
+  } else {
+    CHECK_EQ(transform->op()->name, "transpose");
+    next->attrs.attr_store["axis"] = ComposeAxis(GetTransposeAxis(transform), GetTransposeAxis(next));
+    ReplaceInput(next, x1, x0);
+    VLOG(3) << "Merge transpose " << transform->id() << " into " << next->id();
+  }
+  UnlinkNode(transform);
+  return true;
+}
+
+// transform(x) -> next => next(x) -> transform, next is layout agnostic and all of its inputs are transformed
+// by the same transform
+bool SinkTransformThroughElementwise(
+    Graph* graph, const Node* transform, Node* next, ShapeDict* shape_dict, TypeDict* type_dict) {
+  std::vector<Node*> producers;
+  std::vector<NodeData*> new_inputs;
+  framework::shape_t input_shape;
+  for (auto& link : next->inlinks_in_order(true)) {
+    auto* data     = link->source()->safe_as<NodeData>();
+    auto* producer = GetProducer(data);
+    if (!producer || !IsTransformOp(producer) || !IsSameTransform(producer, transform)) return false;
+    if (GetConsumers(data).size() != 1U || IsGraphOutput(graph, data)) return false;
+    auto* new_input = GetInput(producer, 0);
+    if (new_input->is_const()) return false;
+    if (std::find(new_inputs.begin(), new_inputs.end(), new_input) != new_inputs.end()) return false;
+    // broadcasting binary ops are not layout agnostic
+    CHECK(shape_dict->count(data->id())) << data->id() << " finds no infershape";
+    if (!input_shape.empty() && input_shape != shape_dict->at(data->id())) return false;
+    input_shape = shape_dict->at(data->id());
+    producers.push_back(producer);
+    new_inputs.push_back(new_input);
+  }
+  if (producers.empty()) return false;
+
+  for (int i = 0; i < producers.size(); i++) {
+    ReplaceInput(next, GetOutput(producers[i], 0), new_inputs[i]);
+    UnlinkNode(producers[i]);
+  }
+  if (transform->op()->name == "layout_transform") {
+    // next is computed in the source layout now
+    std::string src_layout = GetLayoutAttr(transform, "src_layout");
+    if (next->attrs.attr_store.count("input_layouts")) {
+      next->attrs.attr_store["input_layouts"] = std::vector<std::string>(new_inputs.size(), src_layout);
+    }
+    if (next->attrs.attr_store.count("out_layouts")) {
+      next->attrs.attr_store["out_layouts"] = std::vector<std::string>({src_layout});
+    }
+  }
+  VLOG(3) << "Sink " << transform->op()->name << " through " << next->id();
+  InsertTransformAfter(graph, transform, next, transform->attrs.attr_store, shape_dict, type_dict);
+  return true;
+}
+
+// transpose(x) -> reduce => reduce(x) -> transpose, with the reduce dims remapped to the axes of x
+bool SinkTransposeThroughReduction(
+    Graph* graph, Node* transpose, Node* reduce, ShapeDict* shape_dict, TypeDict* type_dict) {
+  auto axis  = GetTransposeAxis(transpose);
+  int n_dims = axis.size();
+  if (IsGraphOutput(graph, GetOutput(transpose, 0))) return false;
+  if (!reduce->attrs.attr_store.count("dim")) return false;
+  auto dim = absl::get<std::vector<int>>(reduce->attrs.attr_store.at("dim"));
+  // an empty dim reduces all the axes
+  if (dim.empty()) return false;
+  bool keep_dim = false;
+  if (reduce->attrs.attr_store.count("keep_dim")) {
+    keep_dim = absl::get<bool>(reduce->attrs.attr_store.at("keep_dim"));
+  }
+  for (auto& d : dim) {
+    if (d < 0) d += n_dims;
+  }
+  // the permutation below applies only if the reduced output keeps one axis for each remaining dim, e.g. reducing
+  // all the axes without keep_dim outputs a shape of [1]
+  auto* out = GetOutput(reduce, 0);
+  CHECK(shape_dict->count(out->id())) << out->id() << " finds no infershape";
+  int out_rank = keep_dim ? n_dims : n_dims - static_cast<int>(dim.size());
+  if (shape_dict->at(out->id()).size() != out_rank) return false;
+
+  std::vector<int> new_dim;
+  for (int d : dim) {
+    new_dim.push_back(axis[d]);
+  }
+  std::sort(new_dim.begin(), new_dim.end());
+  // the permutation of the reduced output
+  std::vector<int> new_axis;
+  if (keep_dim) {
+    new_axis = axis;
+  } else {
+    std::vector<int> remain_axes;
+    for (int i = 0; i < n_dims; i++) {
+      if (std::find(dim.begin(), dim.end(), i) == dim.end()) {
+        remain_axes.push_back(axis[i]);
+      }
+    }
+    std::vector<int> sorted_axes = remain_axes;
+    std::sort(sorted_axes.begin(), sorted_axes.end());
+    for (int remain_axis : remain_axes) {
+      new_axis.push_back(std::find(sorted_axes.begin(), sorted_axes.end(), remain_axis) - sorted_axes.begin());
+    }
+  }
+
+  ReplaceInput(reduce, GetOutput(transpose, 0), GetInput(transpose, 0));
+  UnlinkNode(transpose);
+  reduce->attrs.attr_store["dim"] = new_dim;
+  VLOG(3) << "Sink transpose through " << reduce->id() << ", new reduce dim: " << utils::Join(new_dim, ", ");
+  if (IsIdentityAxis(new_axis)) {
+    InferOutputs(reduce, shape_dict, type_dict);
+  } else {
+    framework::AttrMapType attr_store;
+    attr_store["axis"] = new_axis;
+    InsertTransformAfter(graph, transpose, reduce, attr_store, shape_dict, type_dict);
+  }
+  return true;
+}
+
+bool FoldTransform(Graph* graph, Node* transform, ShapeDict* shape_dict, TypeDict* type_dict) {
+  auto* input = GetInput(transform, 0);
+  // transforms of constant weights are computed only once by ConstPropagate's pre_run, keep them
+  if (input->is_const()) return false;
+  auto consumers = GetConsumers(GetOutput(transform, 0));
+  if (consumers.size() != 1U) return false;
+  auto* next = consumers[0];
+  if (IsTransformOp(next) && next->op() == transform->op()) {
+    if (transform->op()->name == "transpose" || IsInverseTransform(transform, next)) {
+      return FoldTransformPair(graph, transform, next);
+    }
+    return false;
+  }
+  if (transform->op()->name == "transpose" && IsReductionOp(next)) {
+    return SinkTransposeThroughReduction(graph, transform, next, shape_dict, type_dict);
+  }
+  if (IsLayoutAgnosticOp(next) && CanSinkToFold(GetOutput(next, 0), transform, 0)) {
+    return SinkTransformThroughElementwise(graph, transform, next, shape_dict, type_dict);
+  }
+  return false;
+}
+
+}  // namespace
+
+void LayoutFoldingPass(Graph* graph) {
+  auto& shape_dict = graph->GetMutableAttrs<ShapeDict>("infershape");
+  auto& type_dict  = graph->GetMutableAttrs<TypeDict>("inferdtype");
+  int folded_count = 0;
+  bool changed     = true;
+  while (changed) {
+    changed          = false;
+    auto store_nodes = std::get<0>(graph->topological_order());
+    for (auto* graph_node : store_nodes) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node && IsTransformOp(node) && FoldTransform(graph, node, &shape_dict, &type_dict)) {
+        changed = true;
+        folded_count++;
+        break;
+      }
+    }
+  }
+  VLOG(3) << "LayoutFolding pass applied " << folded_count << " rewrites";
+  if (folded_count > 0) {
+    absl::flat_hash_map<std::string, std::string> layout_dict;
+    if (graph->HasAttr("inferlayout")) {
+      layout_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, std::string>>("inferlayout");
+    }
+    graph->ClearUnlinkedNodes(&shape_dict, &type_dict, &layout_dict);
+    if (graph->HasAttr("inferlayout")) {
+      graph->attrs["inferlayout"] = std::make_shared<absl::any>(layout_dict);
+    }
+  }
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(LayoutFolding) {
+  CINN_REGISTER_PASS(LayoutFolding)
+      .describe(
+          "This pass sinks transpose and layout_transform ops through layout agnostic ops(elementwise and reduction), "
+          "cancels the inverse transform pairs and merges consecutive transposes into one. Transforms of constant "
+          "weights are kept for ConstPropagate to compute them once before running.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::LayoutFoldingPass);
+  return true;
+}
@@ -0,0 +1,146 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/test_helper.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+std::vector<float> RunGraph(std::shared_ptr<hlir::framework::Graph> graph,
+                            const std::string& input_id,
+                            const std::vector<float>& input,
+                            const std::string& output_id) {
+  Target target = GetTarget();
+  auto scope    = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  SetData(scope->GetTensor(input_id), input, target);
+  runtime_program->Execute();
+  return GetData(scope->GetTensor(output_id));
+}
+
+TEST(LayoutFolding, cancel_inverse_transpose) {
+  Placeholder A(Float(32), {2, 8, 16, 32}, "A");
+
+  Program program;
+  auto b = program.transpose(A, {0, 2, 3, 1});
+  auto c = program.relu(b);
+  auto d = program.transpose(c, {0, 3, 1, 2});
+
+  Target target = GetTarget();
+  program.SetInputs({A});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "LayoutFolding");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+  ASSERT_EQ(CountOps(graph.get(), "transpose"), 0);
+
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  ASSERT_EQ(shape_dict.at(d->id), std::vector<int>({2, 8, 16, 32}));
+
+  std::vector<float> input(2 * 8 * 16 * 32);
+  for (auto& v : input) {
+    v = (rand() * 1.f) / RAND_MAX - 0.5f;
+  }
+  auto output = RunGraph(graph, std::string(A.id()), input, d->id);
+  ASSERT_EQ(output.size(), input.size());
+  for (int i = 0; i < input.size(); i++) {
+    ASSERT_FLOAT_EQ(output[i], std::max(input[i], 0.f));
+  }
+}
+
+TEST(LayoutFolding, merge_transpose) {
+  Placeholder A(Float(32), {4, 8, 16}, "A");
+
+  Program program;
+  auto b = program.transpose(A, {1, 2, 0});
+  auto c = program.transpose(b, {0, 2, 1});
+
+  Target target = GetTarget();
+  program.SetInputs({A});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "LayoutFolding");
+  ASSERT_EQ(CountOps(graph.get(), "transpose"), 1);
+
+  std::vector<float> input(4 * 8 * 16);
+  for (int i = 0; i < input.size(); i++) {
+    input[i] = i;
+  }
+  // c[i][j][k] = A[j][i][k]
+  auto output = RunGraph(graph, std::string(A.id()), input, c->id);
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 4; j++) {
+      for (int k = 0; k < 16; k++) {
+        ASSERT_EQ(output[i * 4 * 16 + j * 16 + k], input[j * 8 * 16 + i * 16 + k]);
+      }
+    }
+  }
+}
+
+TEST(LayoutFolding, keep_fetched_transpose) {
+  Placeholder A(Float(32), {2, 8, 16}, "A");
+
+  Program program;
+  auto b = program.transpose(A, {0, 2, 1});
+  auto c = program.transpose(b, {0, 2, 1});
+  auto d = program.relu(c);
+
+  Target target = GetTarget();
+  program.SetInputs({A});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  // b is fetched, so the pair can't be cancelled
+  graph->outputs.push_back(graph->RetrieveNode(b->id)->safe_as<hlir::framework::NodeData>());
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "LayoutFolding");
+  ASSERT_EQ(CountOps(graph.get(), "transpose"), 2);
+  ASSERT_TRUE(graph->RetrieveNode(b->id));
+}
+
+TEST(LayoutFolding, keep_transpose_before_reduce_all) {
+  Placeholder A(Float(32), {8, 16}, "A");
+
+  Program program;
+  auto b = program.transpose(A, {1, 0});
+  auto c = program.reduce_sum(b, {0, 1});
+
+  Target target = GetTarget();
+  program.SetInputs({A});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "LayoutFolding");
+  // the output of reducing all the axes has a shape of [1], no permutation applies to it
+  ASSERT_EQ(CountOps(graph.get(), "transpose"), 1);
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  ASSERT_EQ(shape_dict.at(c->id), std::vector<int>({1}));
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -41,42 +41,26 @@ struct DomNode {
   int depth{0};
 };
 
-void GetBroadcastPattern(Node* op_node,
-                         OpPatternKind* pattern,
-                         const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict) {
-  if (*pattern == framework::kBroadcast) {
-    auto inlinks  = op_node->inlinks();
-    auto outlinks = op_node->outlinks();
-    CHECK_EQ(inlinks.size(), 2U);
-    CHECK_EQ(outlinks.size(), 1U);
-    std::vector<framework::shape_t> input_shapes;
-    for (auto link : inlinks) {
-      auto source = link->source();
-      CHECK(shape_dict.count(source->id()));
-      input_shapes.push_back(shape_dict.at(source->id()));
-    }
-    int small_index = input_shapes[0].size() <= input_shapes[1].size() ? 0 : 1;
-    auto begin      = std::find(
-        input_shapes[1 - small_index].begin(), input_shapes[1 - small_index].end(), input_shapes[small_index][0]);
-    bool is_same = true;
-    for (int i = 0; i < input_shapes[small_index].size(); i++) {
-      if (input_shapes[small_index][i] != (*begin)) {
-        is_same = false;
-        break;
-      } else {
-        ++begin;
-      }
-    }
-    if (is_same) {
-      *pattern = framework::kElemWise;
-    } else {
-      VLOG(2) << "not fuse broadcast";
-    }
+// the pattern of the op node used in fusion, which may differ from the registered one
+OpPatternKind GetFusionPattern(Node* op_node, const common::Target& target) {
+  static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  if (op_node->attrs.attr_store.count("pre_run") && absl::get<bool>(op_node->attrs.attr_store["pre_run"])) {
+    // not fuse pre_run opnode
+    VLOG(3) << op_node->op()->name << " do pre_run and not fuse";
+    return framework::kOpaque;
+  }
+  if (op_node->op()->name == "pool2d" && target.arch == common::Target::Arch::X86) {
+    // pooling lowers to plain reductions on x86, so the elementwise ops producing its input are computed inline in
+    // the pooling instead of writing a whole activation out and reading it back
+    return framework::kCommReduce;
   }
+  return op_pattern_dict[op_node->op()];
 }
 
 class DomTree {
  public:
+  explicit DomTree(const common::Target& target) : target_(target) {}
+
   std::vector<DomNode*>& CreatePostDomTree(const std::vector<GraphNode*>& nodes) {
     int size = nodes.size();
     dom_nodes_.resize(nodes.size());
@@ -97,6 +81,7 @@ class DomTree {
   std::vector<DomNode*> dom_nodes_;
 
  private:
+  common::Target target_;
   OpPatternKind FusePattern(OpPatternKind p0, OpPatternKind p1) { return p0 > p1 ? p0 : p1; }
   DomNode* LCA(DomNode* l, DomNode* r, OpPatternKind* pattern) {
     while (l != r) {
@@ -118,7 +103,6 @@ class DomTree {
   }
 
   DomNode* FindLCA(GraphNode* graph_node, OpPatternKind* pattern) {
-    static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
     CHECK(graph_node);
     CHECK(pattern);
     DomNode* parent = nullptr;
@@ -156,13 +140,8 @@ class DomTree {
         }
         auto* op_node = sink->safe_as<Node>();
         CHECK(op_node);
-        auto op_pattern = op_pattern_dict[op_node->op()];
+        auto op_pattern = GetFusionPattern(op_node, target_);
         VLOG(2) << sink->id() << "'s op pattern is " << op_pattern;
-        if (op_node->attrs.attr_store.count("pre_run") && absl::get<bool>(op_node->attrs.attr_store["pre_run"])) {
-          // not fuse pre_run opnode
-          op_pattern = framework::kOpaque;
-          VLOG(3) << op_node->op()->name << " do pre_run and not fuse";
-        }
         *pattern = FusePattern(*pattern, op_pattern);
         count++;
       }
@@ -216,7 +195,8 @@ struct GroupNode {
 };
 class GraphPartition {
  public:
-  GraphPartition(const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict) : shape_dict_(shape_dict) {}
+  GraphPartition(const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict, const common::Target& target)
+      : shape_dict_(shape_dict), target_(target) {}
   std::vector<std::vector<Node*>> Partition(const std::vector<GraphNode*>& graph_nodes,
                                             const std::vector<DomNode*>& dom_nodes) {
     CHECK_EQ(graph_nodes.size(), dom_nodes.size());
@@ -236,8 +216,8 @@ class GraphPartition {
   std::vector<std::vector<Node*>> groups_;
   std::unordered_set<GraphNode*> visited_nodes_;
   const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict_;
+  common::Target target_;
   void InitGroups(const std::vector<GraphNode*>& graph_nodes) {
-    static auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
     for (int i = 0; i < graph_nodes.size(); i++) {
       GroupNode* group_node = new GroupNode();
       GraphNode* graph_node = graph_nodes[i];
@@ -246,12 +226,7 @@ class GraphPartition {
       group_node->ref_node = graph_node;
       group_node->index    = graph_node->get_index();
       if (op_node) {
-        auto pattern = op_pattern_dict[op_node->op()];
-        if (op_node->attrs.attr_store.count("pre_run") && absl::get<bool>(op_node->attrs.attr_store["pre_run"])) {
-          // not fuse pre_run opnode
-          pattern = framework::kOpaque;
-          VLOG(3) << op_node->op()->name << " do pre_run and not fuse";
-        }
+        auto pattern               = GetFusionPattern(op_node, target_);
         group_node->pattern        = pattern;
         group_node->op_nodes_count = 1;
         if (pattern == framework::kOutEWiseFusable) {
@@ -345,6 +320,11 @@ class GraphPartition {
     auto op_node                 = source->safe_as<Node>();
     visited_nodes_.clear();
     CHECK(source != sink);
+    // two groups with complex patterns can't be merged, e.g. conv2d and a pooling lowered to reductions on x86
+    if (GetRootPattern(source) > framework::kBroadcast && GetRootPattern(sink) > framework::kBroadcast) {
+      VLOG(2) << "no fuse between the complex groups of " << source->id() << " and " << sink->id();
+      return false;
+    }
     auto sink_op_node = sink->safe_as<Node>();
     if (sink_op_node && GetRootPattern(source) == framework::kOutEWiseFusable &&
         op_pattern_dict[sink_op_node->op()] >= framework::kBroadcast) {
@@ -514,11 +494,11 @@ void OpFusionPass(Graph* graph) {
   auto store_nodes = std::get<0>(graph->topological_order());
   int node_size    = store_nodes.size();
   // construct postdom tree, reverse topological_order
-  DomTree tree;
+  DomTree tree(graph->target_);
   auto& dom_nodes = tree.CreatePostDomTree(store_nodes);
   // graph partition
   auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
-  GraphPartition partition(shape_dict);
+  GraphPartition partition(shape_dict, graph->target_);
   graph->groups = partition.Partition(store_nodes, dom_nodes);
 }
 
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include "cinn/cinn.h"
@@ -562,5 +564,177 @@ TEST(conv_bn, conv_bn) {
   runtime_program->Execute();
 }
 
+// add+relu+pool2d
+TEST(fuse_add_relu_pool2d, fuse_add_relu_pool2d) {
+  Placeholder A(Float(32), {1, 64, 56, 56}, "A");
+  Placeholder B(Float(32), {1, 64, 56, 56}, "B");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["kernel_size"]    = std::vector<int>({56, 56});
+  attrs["stride_size"]    = std::vector<int>({1, 1});
+  attrs["padding_size"]   = std::vector<int>({0, 0});
+  attrs["pool_type"]      = std::string("avg");
+  attrs["global_pooling"] = true;
+  auto c                  = program.elementwise_add(A, B);
+  auto d                  = program.relu(c);
+  auto e                  = program.pool2d(d, attrs);
+
+  Target target = GetTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+#ifndef CINN_WITH_CUDA
+  // the activation is computed inline in the pooling
+  ASSERT_EQ(graph->groups.size(), 1U);
+#endif
+  auto scope = BuildScope(target, graph);
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  scope->Var<hlir::framework::Tensor>("A");
+  scope->Var<hlir::framework::Tensor>("B");
+
+  auto A1 = scope->GetTensor("A");
+  auto B1 = scope->GetTensor("B");
+  SetRandData(A1, target);
+  SetRandData(B1, target);
+
+  runtime_program->Execute();
+}
+
+// conv+relu+pool2d, the pooling keeps the shape of the convolution output
+TEST(conv_relu_pool2d, conv_relu_pool2d) {
+  Placeholder A(Float(32), {1, 16, 28, 28}, "A");
+  Placeholder B(Float(32), {16, 16, 3, 3}, "B");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]        = std::vector<int>({1, 1});
+  attrs["dilation"]      = std::vector<int>({1, 1});
+  attrs["padding"]       = std::vector<int>({1, 1});
+  std::string src_layout = "NCHW";
+  attrs["data_format"]   = src_layout;
+
+  absl::flat_hash_map<std::string, Program::attr_t> attrs2;
+  attrs2["kernel_size"]  = std::vector<int>({3, 3});
+  attrs2["stride_size"]  = std::vector<int>({1, 1});
+  attrs2["padding_size"] = std::vector<int>({1, 1, 1, 1});
+  attrs2["pool_type"]    = std::string("max");
+
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.relu(c);
+  auto e = program.pool2d(d, attrs2);
+
+  Target target = GetTarget();
+  program.SetInputs({A, B});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+#ifndef CINN_WITH_CUDA
+  // the relu is fused into the convolution, which can't be fused with the pooling further
+  ASSERT_EQ(graph->groups.size(), 2U);
+#endif
+  auto scope = BuildScope(target, graph);
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  scope->Var<hlir::framework::Tensor>("A");
+  scope->Var<hlir::framework::Tensor>("B");
+
+  auto A1 = scope->GetTensor("A");
+  auto B1 = scope->GetTensor("B");
+  SetRandData(A1, target);
+  SetRandData(B1, target);
+
+  runtime_program->Execute();
+}
+
+#ifndef CINN_WITH_CUDA
+// MobileNetV1 stride-2 depthwise conv with the folded batchnorm and relu6 fused after it, checked against a naive
+// reference since the NCHWc schedule computes the epilogue tile by tile
+TEST(depthwise_conv_bn_relu6, depthwise_conv_bn_relu6) {
+  const int c      = 32;
+  const int h      = 28;
+  const int w      = 28;
+  const int k      = 3;
+  const int stride = 2;
+  const int pad    = 1;
+  const int oh     = (h + 2 * pad - k) / stride + 1;
+  const int ow     = (w + 2 * pad - k) / stride + 1;
+  Placeholder A(Float(32), {1, c, h, w}, "A");
+  Placeholder B(Float(32), {c, 1, k, k}, "B");
+  Placeholder Scale(Float(32), {c}, "Scale");
+  Placeholder Bias(Float(32), {c}, "Bias");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({stride, stride});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({pad, pad});
+  attrs["data_format"] = std::string("NCHW");
+
+  auto conv = program.depthwise_conv2d(A, B, attrs);
+  auto mul  = program.elementwise_mul(conv, Scale, 1);
+  auto add  = program.elementwise_add(mul, Bias, 1);
+  auto out  = program.relu6(add);
+
+  Target target = GetTarget();
+  program.SetInputs({A, B, Scale, Bias});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = BuildScope(target, graph);
+
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  auto A1     = scope->GetTensor("A");
+  auto B1     = scope->GetTensor("B");
+  auto Scale1 = scope->GetTensor("Scale");
+  auto Bias1  = scope->GetTensor("Bias");
+  SetRandData(A1, target);
+  SetRandData(B1, target);
+  SetRandData(Scale1, target);
+  SetRandData(Bias1, target);
+  runtime_program->Execute();
+
+  const float* x     = A1->data<float>();
+  const float* wt    = B1->data<float>();
+  const float* scale = Scale1->data<float>();
+  const float* bias  = Bias1->data<float>();
+  const float* y     = scope->GetTensor(out->id)->data<float>();
+  for (int ci = 0; ci < c; ci++) {
+    for (int i = 0; i < oh; i++) {
+      for (int j = 0; j < ow; j++) {
+        float sum = 0.f;
+        for (int ki = 0; ki < k; ki++) {
+          for (int kj = 0; kj < k; kj++) {
+            int hi = i * stride + ki - pad;
+            int wj = j * stride + kj - pad;
+            if (hi < 0 || hi >= h || wj < 0 || wj >= w) continue;
+            sum += x[(ci * h + hi) * w + wj] * wt[(ci * k + ki) * k + kj];
+          }
+        }
+        float expect = std::min(std::max(sum * scale[ci] + bias[ci], 0.f), 6.f);
+        ASSERT_NEAR(y[(ci * oh + i) * ow + j], expect, 1e-4);
+      }
+    }
+  }
+}
+#endif
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,166 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+
+namespace {
+
+int Product(const framework::shape_t& shape, int begin, int end) {
+  int res = 1;
+  for (int i = begin; i < end; i++) res *= shape[i];
+  return res;
+}
+
+// The GEMM C[M, N] = alpha * op(A) * op(B) computed by a mul or 2-D matmul node, whose B is a constant
+struct ConstGemm {
+  int m{0};
+  int n{0};
+  int k{0};
+  bool trans_a{false};
+  bool trans_b{false};
+  float alpha{1.f};
+};
+
+bool MatchConstGemm(const Node* node, const ShapeDict& shape_dict, const TypeDict& type_dict, ConstGemm* gemm) {
+  auto& op_name = node->op()->name;
+  if ((op_name != "mul" && op_name != "matmul") || node->inlinks().size() != 2U) return false;
+  if (node->attrs.attr_store.count("pre_run")) return false;
+  auto* a = GetInput(node, 0);
+  auto* b = GetInput(node, 1);
+  if (!b->is_const() || a->is_const()) return false;
+  if (type_dict.at(a->id()) != Float(32) || type_dict.at(b->id()) != Float(32)) return false;
+  auto& a_shape = shape_dict.at(a->id());
+  auto& b_shape = shape_dict.at(b->id());
+
+  if (op_name == "mul") {
+    // mul flattens X to [M, K] and Y to [N, K]
+    int x_num_col_dims = GetAttr<int>(node, "x_num_col_dims", 1);
+    int y_num_col_dims = GetAttr<int>(node, "y_num_col_dims", 1);
+    gemm->m            = Product(a_shape, 0, x_num_col_dims);
+    gemm->k            = Product(a_shape, x_num_col_dims, a_shape.size());
+    gemm->n            = Product(b_shape, 0, y_num_col_dims);
+    gemm->trans_b      = true;
+    return gemm->k == Product(b_shape, y_num_col_dims, b_shape.size());
+  }
+  // the batched and the broadcast matmul are left to MKL
+  if (a_shape.size() != 2U || b_shape.size() != 2U) return false;
+  gemm->trans_a = GetAttr<bool>(node, "trans_a", false);
+  gemm->trans_b = GetAttr<bool>(node, "trans_b", false);
+  gemm->alpha   = GetAttr<float>(node, "alpha", 1.f);
+  gemm->m       = gemm->trans_a ? a_shape[1] : a_shape[0];
+  gemm->k       = gemm->trans_a ? a_shape[0] : a_shape[1];
+  gemm->n       = gemm->trans_b ? b_shape[0] : b_shape[1];
+  return gemm->k == (gemm->trans_b ? b_shape[1] : b_shape[0]);
+}
+
+// op(A, B) -> gemm_packed(A, gemm_pack_b(B)): the gemm_pack_b node only reads the constant B, so it is marked
+// pre_run like the nodes ConstPropagate marks, and the weights are packed once before running
+void PackWeights(Graph* graph, Node* node, const ConstGemm& gemm, ShapeDict* shape_dict, TypeDict* type_dict) {
+  auto* a = GetInput(node, 0);
+  auto* b = GetInput(node, 1);
+
+  auto* pack_node = new Node(Operator::Get("gemm_pack_b"), "gemm_pack_b", common::UniqName("gemm_pack_b"));
+  std::shared_ptr<Node> pack_node_ptr(pack_node);
+  pack_node->attrs.attr_store["m"]       = gemm.m;
+  pack_node->attrs.attr_store["n"]       = gemm.n;
+  pack_node->attrs.attr_store["k"]       = gemm.k;
+  pack_node->attrs.attr_store["trans_b"] = gemm.trans_b;
+  pack_node->attrs.attr_store["alpha"]   = gemm.alpha;
+  pack_node->attrs.attr_store["pre_run"] = true;
+  b->LinkTo(pack_node);
+  graph->RegisterNode(pack_node->id(), pack_node);
+  std::vector<NodeData*> pack_outputs;
+  for (int i = 0; i < 2; i++) {
+    auto* output = new NodeData(pack_node_ptr, i, 0, common::UniqName(pack_node->id() + "_out"), true);
+    pack_node->LinkTo(output);
+    graph->RegisterNode(output->id(), output);
+    pack_outputs.push_back(output);
+  }
+  InferOutputs(pack_node, shape_dict, type_dict);
+
+  b->UnLinkTo(node);
+  a->UnLinkTo(node);
+  a->LinkTo(node);
+  pack_outputs[0]->LinkTo(node);
+  node->attrs.op        = Operator::Get("gemm_packed");
+  node->attrs.node_name = "gemm_packed";
+  node->attrs.attr_store.clear();
+  node->attrs.attr_store["m"]       = gemm.m;
+  node->attrs.attr_store["n"]       = gemm.n;
+  node->attrs.attr_store["k"]       = gemm.k;
+  node->attrs.attr_store["trans_a"] = gemm.trans_a;
+  InferOutputs(node, shape_dict, type_dict);
+  VLOG(3) << "Pack the weight " << b->id() << " of " << node->id() << " into " << pack_outputs[0]->id();
+}
+
+}  // namespace
+
+void PackGemmWeightsPass(Graph* graph) {
+#ifdef CINN_WITH_MKL_CBLAS
+  if (graph->target_.arch != common::Target::Arch::X86) {
+    return;
+  }
+  auto& shape_dict = graph->GetMutableAttrs<ShapeDict>("infershape");
+  auto& type_dict  = graph->GetMutableAttrs<TypeDict>("inferdtype");
+  int packed_count = 0;
+  auto store_nodes = std::get<0>(graph->topological_order());
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    ConstGemm gemm;
+    if (node && MatchConstGemm(node, shape_dict, type_dict, &gemm)) {
+      PackWeights(graph, node, gemm, &shape_dict, &type_dict);
+      packed_count++;
+    }
+  }
+  VLOG(3) << "PackGemmWeights pass packed " << packed_count << " weights";
+#else
+  VLOG(3) << "PackGemmWeights pass is skipped since CINN is compiled without MKL";
+#endif
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(PackGemmWeights) {
+  CINN_REGISTER_PASS(PackGemmWeights)
+      .describe(
+          "This pass packs the constant weights of mul and 2-D matmul into the layout of MKL on X86. The packing op "
+          "is marked pre_run, so it runs once before running and the GEMM computes with the packed weights instead "
+          "of packing them in each call. It should be applied after ConstPropagate.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::PackGemmWeightsPass);
+  return true;
+}
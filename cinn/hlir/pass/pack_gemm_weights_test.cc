@@ -0,0 +1,93 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/test_helper.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+TEST(PackGemmWeights, mul_matmul) {
+  // mul: [2, 3, 32] * [64, 32]^T, matmul: 0.5 * [6, 64] * [48, 64]^T
+  Placeholder A(Float(32), {2, 3, 32}, "A");
+  Placeholder W(Float(32), {64, 32}, "W", true);
+  Placeholder V(Float(32), {48, 64}, "V", true);
+
+  Program program;
+  auto mul_out = program.mul(A, W, 2, 1);
+  auto out     = program.matmul(mul_out, V, false, true, 0.5f);
+  program.SetInputs({A});
+  program.Validate();
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  hlir::framework::ApplyPass(graph.get(), "PackGemmWeights");
+  ASSERT_EQ(CountOps(graph.get(), "gemm_pack_b"), 2);
+  ASSERT_EQ(CountOps(graph.get(), "gemm_packed"), 2);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  // the weights are packed by the instructions running before the others
+  ASSERT_EQ(runtime_program->GetPreRunInstructions().size(), 2UL);
+  ASSERT_EQ(runtime_program->size(), 2);
+
+  auto a = RandomData(6 * 32);
+  auto w = RandomData(64 * 32);
+  auto v = RandomData(48 * 64);
+  std::copy(a.begin(), a.end(), scope->GetTensor(std::string(A.id()))->mutable_data<float>(target));
+  std::copy(w.begin(), w.end(), scope->GetTensor(std::string(W.id()))->mutable_data<float>(target));
+  std::copy(v.begin(), v.end(), scope->GetTensor(std::string(V.id()))->mutable_data<float>(target));
+  runtime_program->PreRun();
+  // run twice to check the packed weights are kept
+  runtime_program->Execute();
+  runtime_program->Execute();
+
+  std::vector<float> mul_expect(6 * 64, 0.f);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 64; j++) {
+      for (int k = 0; k < 32; k++) {
+        mul_expect[i * 64 + j] += a[i * 32 + k] * w[j * 32 + k];
+      }
+    }
+  }
+  auto* output_data = scope->GetTensor(out->id)->data<float>();
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 48; j++) {
+      float expect = 0.f;
+      for (int k = 0; k < 64; k++) {
+        expect += mul_expect[i * 64 + k] * v[j * 64 + k];
+      }
+      ASSERT_NEAR(output_data[i * 48 + j], 0.5f * expect, 1e-4 * std::max(1.f, std::abs(expect)));
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
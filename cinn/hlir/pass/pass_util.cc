@@ -0,0 +1,142 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/pass/pass_util.h"
+
+#include <algorithm>
+
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::GraphNode;
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+
+NodeData* GetInput(const Node* node, int index) {
+  auto& inlinks = node->inlinks_in_order(true);
+  CHECK_LT(index, inlinks.size());
+  auto* data = inlinks[index]->source()->safe_as<NodeData>();
+  CHECK(data);
+  return data;
+}
+
+NodeData* GetOutput(const Node* node, int index) {
+  auto& outlinks = node->outlinks_in_order(true);
+  CHECK_LT(index, outlinks.size());
+  auto* data = outlinks[index]->sink()->safe_as<NodeData>();
+  CHECK(data);
+  return data;
+}
+
+Node* GetProducer(const NodeData* data) {
+  if (data->inlinks().empty()) return nullptr;
+  return (*data->inlinks().begin())->source()->safe_as<Node>();
+}
+
+std::vector<Node*> GetConsumers(const NodeData* data) {
+  std::vector<Node*> consumers;
+  for (auto& link : data->outlinks()) {
+    auto* consumer = link->sink()->safe_as<Node>();
+    CHECK(consumer);
+    consumers.push_back(consumer);
+  }
+  return consumers;
+}
+
+Node* GetOnlyConsumer(const NodeData* data) {
+  if (data->outlinks().size() != 1U) return nullptr;
+  return (*data->outlinks().begin())->sink()->safe_as<Node>();
+}
+
+bool IsGraphOutput(const Graph* graph, const NodeData* data) {
+  auto& outputs = graph->outputs;
+  return data->outlinks().empty() || std::find(outputs.begin(), outputs.end(), data) != outputs.end();
+}
+
+void ResetInputs(Node* node, const std::vector<NodeData*>& inputs) {
+  std::vector<GraphNode*> old_sources;
+  for (auto& link : node->inlinks_in_order(true)) {
+    old_sources.push_back(link->source());
+  }
+  for (auto* source : old_sources) {
+    source->UnLinkTo(node);
+  }
+  for (auto* input : inputs) {
+    input->LinkTo(node);
+  }
+  node->inlinks_in_order(true);
+}
+
+void ReplaceInput(Node* node, NodeData* old_data, NodeData* new_data) {
+  std::vector<NodeData*> inputs;
+  for (auto& link : node->inlinks_in_order(true)) {
+    auto* source = link->source()->safe_as<NodeData>();
+    CHECK(source);
+    inputs.push_back(source == old_data ? new_data : source);
+  }
+  ResetInputs(node, inputs);
+}
+
+void UnlinkNode(Node* node) {
+  std::vector<GraphNode*> sources;
+  std::vector<GraphNode*> sinks;
+  for (auto& link : node->inlinks()) {
+    sources.push_back(link->source());
+  }
+  for (auto& link : node->outlinks()) {
+    sinks.push_back(link->sink());
+  }
+  for (auto* source : sources) {
+    source->UnLinkTo(node);
+  }
+  for (auto* sink : sinks) {
+    node->UnLinkTo(sink);
+  }
+}
+
+void InferOutputs(const Node* node, ShapeDict* shape_dict, TypeDict* type_dict) {
+  static auto& op_infershape = Operator::GetAttrs<InferShapeFunc>("infershape");
+  static auto& op_inferdtype = Operator::GetAttrs<InferTypeFunc>("inferdtype");
+  std::vector<framework::shape_t> input_shapes;
+  std::vector<Type> input_types;
+  for (auto& link : node->inlinks_in_order(true)) {
+    auto* source = link->source();
+    CHECK(shape_dict->count(source->id())) << source->id() << " finds no infershape";
+    CHECK(type_dict->count(source->id())) << source->id() << " finds no infertype";
+    input_shapes.push_back(shape_dict->at(source->id()));
+    input_types.push_back(type_dict->at(source->id()));
+  }
+  auto out_shapes = op_infershape[node->op()](input_shapes, node->attrs.attr_store);
+  auto out_types  = op_inferdtype[node->op()](input_types, node->attrs.attr_store);
+  auto& outlinks  = node->outlinks_in_order(true);
+  CHECK_EQ(outlinks.size(), out_shapes.size());
+  CHECK_EQ(out_shapes.size(), out_types.size());
+  for (int i = 0; i < outlinks.size(); i++) {
+    auto* sink                = outlinks[i]->sink();
+    (*shape_dict)[sink->id()] = out_shapes[i];
+    (*type_dict)[sink->id()]  = out_types[i];
+    VLOG(3) << "Infershape: " << node->id() << "'s " << i << "-th outlink " << sink->id() << ": "
+            << utils::Join(out_shapes[i], ", ");
+  }
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,68 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using InferShapeFunc = std::function<std::vector<framework::shape_t>(const std::vector<framework::shape_t>&,
+                                                                    const framework::AttrMapType&)>;
+using InferTypeFunc =
+    std::function<std::vector<common::Type>(const std::vector<common::Type>&, const framework::AttrMapType&)>;
+using ShapeDict = absl::flat_hash_map<std::string, framework::shape_t>;
+using TypeDict  = absl::flat_hash_map<std::string, common::Type>;
+
+// the attribute key of node, or default_value if node has no such attribute
+template <typename T>
+T GetAttr(const framework::Node* node, const std::string& key, const T& default_value) {
+  auto& attr_store = node->attrs.attr_store;
+  return attr_store.count(key) ? absl::get<T>(attr_store.at(key)) : default_value;
+}
+
+// the index-th input and output of node in order
+framework::NodeData* GetInput(const framework::Node* node, int index);
+framework::NodeData* GetOutput(const framework::Node* node, int index);
+
+// the op node producing data, or null if data is an input of the graph
+framework::Node* GetProducer(const framework::NodeData* data);
+std::vector<framework::Node*> GetConsumers(const framework::NodeData* data);
+// the only consumer of data, or null
+framework::Node* GetOnlyConsumer(const framework::NodeData* data);
+
+// the outputs of the graph are fetched after running, so they can't be removed even if they have no consumers
+bool IsGraphOutput(const framework::Graph* graph, const framework::NodeData* data);
+
+// unlink all the inputs of node and link the new ones in order
+void ResetInputs(framework::Node* node, const std::vector<framework::NodeData*>& inputs);
+// replace the input old_data of node with new_data, keeping the order of the inputs
+void ReplaceInput(framework::Node* node, framework::NodeData* old_data, framework::NodeData* new_data);
+// unlink the node from its inputs and outputs, the unlinked nodes are cleared by Graph::ClearUnlinkedNodes finally
+void UnlinkNode(framework::Node* node);
+
+// infer the shapes and types of the outputs of node from its inputs, and record them in shape_dict and type_dict
+void InferOutputs(const framework::Node* node, ShapeDict* shape_dict, TypeDict* type_dict);
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,124 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Float;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Operator;
+
+namespace {
+
+// the conv2d computed by cinn_cpu_mkldnn_conv2d_nchw_fp32 on X86, see StrategyForConv2d, whose filter is constant
+bool IsConstMKLDNNConv(const Node* node, const TypeDict& type_dict) {
+  if (node->op()->name != "conv2d" || node->inlinks().size() != 2U) return false;
+  if (node->attrs.attr_store.count("pre_run")) return false;
+  if (GetAttr<std::string>(node, "data_format", "NCHW") != "NCHW" ||
+      GetAttr<std::string>(node, "conv_type", "forward") != "forward") {
+    return false;
+  }
+  if (GetAttr<int>(node, "groups", 1) == 1 && !GetAttr<bool>(node, "use_mkldnn", false)) return false;
+  auto* weight = GetInput(node, 1);
+  return weight->is_const() && type_dict.at(weight->id()) == Float(32);
+}
+
+// conv2d(x, W) -> conv2d(x, W, conv2d_mkldnn_reorder_weights(W)): the reorder node only reads the constant W, so it is
+// marked pre_run and writes the reordered filter into its own buffer once before running. W is kept as the input
+// giving the shape of the filter.
+void ReorderWeights(Graph* graph, Node* node, ShapeDict* shape_dict, TypeDict* type_dict) {
+  auto* x      = GetInput(node, 0);
+  auto* weight = GetInput(node, 1);
+
+  auto* reorder_node = new Node(Operator::Get("conv2d_mkldnn_reorder_weights"),
+                                "conv2d_mkldnn_reorder_weights",
+                                common::UniqName("conv2d_mkldnn_reorder_weights"));
+  std::shared_ptr<Node> reorder_node_ptr(reorder_node);
+  auto& x_shape = shape_dict->at(x->id());
+
+  reorder_node->attrs.attr_store["input_shape"] = std::vector<int>(x_shape.begin(), x_shape.end());
+  reorder_node->attrs.attr_store["padding"]     = GetAttr<std::vector<int>>(node, "padding", {0, 0});
+  reorder_node->attrs.attr_store["stride"]      = GetAttr<std::vector<int>>(node, "stride", {1, 1});
+  reorder_node->attrs.attr_store["dilation"]    = GetAttr<std::vector<int>>(node, "dilation", {1, 1});
+  reorder_node->attrs.attr_store["pre_run"]     = true;
+  weight->LinkTo(reorder_node);
+  graph->RegisterNode(reorder_node->id(), reorder_node);
+  std::vector<NodeData*> reorder_outputs;
+  for (int i = 0; i < 2; i++) {
+    auto* output = new NodeData(reorder_node_ptr, i, 0, common::UniqName(reorder_node->id() + "_out"), true);
+    reorder_node->LinkTo(output);
+    graph->RegisterNode(output->id(), output);
+    reorder_outputs.push_back(output);
+  }
+  InferOutputs(reorder_node, shape_dict, type_dict);
+
+  ResetInputs(node, {x, weight, reorder_outputs[0]});
+  VLOG(3) << "Reorder the filter " << weight->id() << " of " << node->id() << " into " << reorder_outputs[0]->id();
+}
+
+}  // namespace
+
+void ReorderConvWeightsPass(Graph* graph) {
+#ifdef CINN_WITH_MKLDNN
+  if (graph->target_.arch != common::Target::Arch::X86) {
+    return;
+  }
+  auto& shape_dict    = graph->GetMutableAttrs<ShapeDict>("infershape");
+  auto& type_dict     = graph->GetMutableAttrs<TypeDict>("inferdtype");
+  int reordered_count = 0;
+  auto store_nodes    = std::get<0>(graph->topological_order());
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    if (node && IsConstMKLDNNConv(node, type_dict)) {
+      ReorderWeights(graph, node, &shape_dict, &type_dict);
+      reordered_count++;
+    }
+  }
+  VLOG(3) << "ReorderConvWeights pass reordered " << reordered_count << " filters";
+#else
+  VLOG(3) << "ReorderConvWeights pass is skipped since CINN is compiled without MKLDNN";
+#endif
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(ReorderConvWeights) {
+  CINN_REGISTER_PASS(ReorderConvWeights)
+      .describe(
+          "This pass reorders the constant filters of the conv2d computed by oneDNN on X86 into the blocked layout of "
+          "their primitives. The reorder op is marked pre_run, so it runs once before running and writes a buffer "
+          "owned by the program, which the convolution reads instead of reordering the filter in each call. It should "
+          "be applied after ConstPropagate.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::ReorderConvWeightsPass);
+  return true;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/test_helper.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace frontend {
+
+// run the grouped conv2d: [1, 8, 14, 14] * [16, 4, 3, 3] with or without reordering its constant filter
+std::vector<float> RunConv(bool reorder, const std::vector<float>& x, const std::vector<float>& w) {
+  Placeholder X(Float(32), {1, 8, 14, 14}, "X");
+  Placeholder W(Float(32), {16, 4, 3, 3}, "W", true);
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]      = std::vector<int>({1, 1});
+  attrs["dilation"]    = std::vector<int>({1, 1});
+  attrs["padding"]     = std::vector<int>({1, 1});
+  attrs["groups"]      = 2;
+  attrs["data_format"] = std::string("NCHW");
+  auto out             = program.conv2d(X, W, attrs);
+  program.SetInputs({X});
+  program.Validate();
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "ConstPropagate");
+  if (reorder) {
+    hlir::framework::ApplyPass(graph.get(), "ReorderConvWeights");
+    EXPECT_EQ(CountOps(graph.get(), "conv2d_mkldnn_reorder_weights"), 1);
+  }
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  // the filter is reordered by the instruction running before the others
+  EXPECT_EQ(runtime_program->GetPreRunInstructions().size(), reorder ? 1UL : 0UL);
+
+  SetData(scope->GetTensor(std::string(X.id())), x, target);
+  SetData(scope->GetTensor(std::string(W.id())), w, target);
+  runtime_program->PreRun();
+  // run twice to check the reordered filter is kept
+  runtime_program->Execute();
+  runtime_program->Execute();
+  return GetData(scope->GetTensor(out->id));
+}
+
+TEST(ReorderConvWeights, grouped_conv) {
+  auto x = RandomData(1 * 8 * 14 * 14);
+  auto w = RandomData(16 * 4 * 3 * 3);
+
+  auto expect = RunConv(false, x, w);
+  auto actual = RunConv(true, x, w);
+  ASSERT_EQ(actual.size(), expect.size());
+  for (int i = 0; i < expect.size(); i++) {
+    ASSERT_NEAR(actual[i], expect[i], 1e-4 * std::max(1.f, std::abs(expect[i])));
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,79 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/tensor.h"
+
+namespace cinn::frontend {
+
+Target GetTarget() {
+#ifdef CINN_WITH_CUDA
+  return common::DefaultNVGPUTarget();
+#else
+  return common::DefaultHostTarget();
+#endif
+}
+
+// the number of op_name nodes in the graph
+int CountOps(hlir::framework::Graph* graph, const std::string& op_name) {
+  int count = 0;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == op_name) {
+      count++;
+    }
+  }
+  return count;
+}
+
+std::vector<float> RandomData(int size, float low = -1.f, float high = 1.f) {
+  std::vector<float> data(size);
+  for (auto& v : data) {
+    v = low + (high - low) * rand() / RAND_MAX;
+  }
+  return data;
+}
+
+void SetData(const hlir::framework::Tensor& tensor, const std::vector<float>& values, Target target) {
+  auto* data = tensor->mutable_data<float>(target);
+  CHECK_EQ(tensor->shape().numel(), values.size());
+#ifdef CINN_WITH_CUDA
+  CUDA_CALL(cudaMemcpy(data, values.data(), values.size() * sizeof(float), cudaMemcpyHostToDevice));
+#else
+  std::copy(values.begin(), values.end(), data);
+#endif
+}
+
+std::vector<float> GetData(const hlir::framework::Tensor& tensor) {
+  std::vector<float> values(tensor->shape().numel());
+#ifdef CINN_WITH_CUDA
+  CUDA_CALL(cudaMemcpy(values.data(), tensor->data<float>(), values.size() * sizeof(float), cudaMemcpyDeviceToHost));
+#else
+  std::copy(tensor->data<float>(), tensor->data<float>() + values.size(), values.begin());
+#endif
+  return values;
+}
+
+}  // namespace cinn::frontend
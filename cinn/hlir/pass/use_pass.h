@@ -20,3 +20,8 @@ CINN_USE_REGISTER(InferShape)
 CINN_USE_REGISTER(OpFusion)
 CINN_USE_REGISTER(AlterLayout)
 CINN_USE_REGISTER(ConstPropagate)
+CINN_USE_REGISTER(LayoutFolding)
+CINN_USE_REGISTER(FoldBatchNorm)
+CINN_USE_REGISTER(FoldSoftmaxScale)
+CINN_USE_REGISTER(PackGemmWeights)
+CINN_USE_REGISTER(ReorderConvWeights)
@@ -16,6 +16,7 @@
 
 #include <string>
 
+#include "cinn/common/ir_util.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/lang/builtin.h"
 
@@ -102,6 +103,25 @@ HLIR_IMP_UNARY_PE(Sign);
 HLIR_IMP_UNARY_PE(Abs);
 HLIR_IMP_UNARY_PE(Rsqrt);
 
+std::vector<ir::Tensor> Gelu(const Tensor& A, bool approximate, const std::string& output_name) {
+  return {Compute(
+      A->shape,
+      [=](const std::vector<Expr>& indice) {
+        Expr x    = A(indice);
+        auto half = common::make_const(x->type(), 0.5);
+        auto one  = common::make_const(x->type(), 1);
+        if (approximate) {
+          // 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+          auto inner = common::make_const(x->type(), 0.7978845608028654) *
+                       (x + common::make_const(x->type(), 0.044715) * x * x * x);
+          return half * x * (one + lang::Tanh(inner));
+        }
+        // 0.5 * x * (1 + erf(x / sqrt(2)))
+        return half * x * (one + lang::Erf(x * common::make_const(x->type(), 0.7071067811865476)));
+      },
+      output_name)};
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -76,6 +76,17 @@ HLIR_DCL_UNARY_PE(ElementwiseSum);
 HLIR_DCL_UNARY_PE(Full);
 HLIR_DCL_UNARY_PE(FullLike);
 
+/**
+ * @brief GELU activation, x * Phi(x), where Phi is the CDF of the standard normal distribution.
+ *
+ * @param A The input Tensor
+ * @param approximate Whether to approximate Phi with tanh instead of erf
+ * @param output_name The name of the output Tensor
+ *
+ * @return The result Tensor.
+ */
+std::vector<ir::Tensor> Gelu(const ir::Tensor& A, bool approximate, const std::string& output_name = "T_Gelu_out");
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
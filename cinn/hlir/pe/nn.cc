@@ -478,6 +478,7 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                            int stride_w,
                                            int dilation_h,
                                            int dilation_w,
+                                           const ir::Tensor &reordered_weights,
                                            const std::string &output_name) {
   CHECK_EQ(input->shape.size(), 4U) << "Input's dimension of Conv2d_NCHW op is not 4! Please check.";
   CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of Conv2d_NCHW op is not 4! Please check.";
@@ -487,15 +488,61 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
   int group = input->shape[1].as_int32() / weights->shape[1].as_int32();
   CHECK_EQ(input->shape[1].as_int32(), weights->shape[1].as_int32() * group)
       << "input channel should be divisible by filter channel";
-  auto call = Compute(
+  // the reordered weights are read instead of the weights, which only give the shape of the filter
+  bool use_reordered = reordered_weights.defined();
+  auto call          = Compute(
       {Expr(1)},
       [=]() -> Expr {
         return lang::CallExtern("cinn_cpu_mkldnn_conv2d_nchw_fp32",
                                 {
-                                    Expr(input->shape[0]),    // batch_size
-                                    Expr(input->shape[1]),    // c_in
-                                    Expr(input->shape[2]),    // input_h
-                                    Expr(input->shape[3]),    // input_w
+                                    Expr(input->shape[0]),                       // batch_size
+                                    Expr(input->shape[1]),                       // c_in
+                                    Expr(input->shape[2]),                       // input_h
+                                    Expr(input->shape[3]),                       // input_w
+                                    Expr(weights->shape[0]),                     // c_out
+                                    Expr(group),                                 // group
+                                    Expr(weights->shape[2]),                     // filter_h
+                                    Expr(weights->shape[3]),                     // filter_w
+                                    Expr(pad_h),                                 // pad_h
+                                    Expr(pad_w),                                 // pad_w
+                                    Expr(stride_h),                              // stride_h
+                                    Expr(stride_w),                              // stride_w
+                                    Expr(dilation_h),                            // dilation_h
+                                    Expr(dilation_w),                            // dilation_w
+                                    Expr(use_reordered ? 1 : 0),                 // reordered_weights
+                                    input,                                       // input
+                                    use_reordered ? reordered_weights : weights  // weights
+                                });
+      },
+      UniqName("conv2d_nchw_mkldnn_out"));
+  auto out = call->TupleGet(0);
+  out->WithBuffer(input->type());
+  return {out, call};
+}
+
+std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN_ReorderWeights(const ir::Tensor &weights,
+                                                          const std::vector<int> &input_shape,
+                                                          int pad_h,
+                                                          int pad_w,
+                                                          int stride_h,
+                                                          int stride_w,
+                                                          int dilation_h,
+                                                          int dilation_w,
+                                                          const std::string &output_name) {
+  CHECK_EQ(input_shape.size(), 4U) << "Input's dimension of Conv2d_NCHW op is not 4! Please check.";
+  CHECK_EQ(weights->shape.size(), 4U) << "Weight's dimension of Conv2d_NCHW op is not 4! Please check.";
+  int group = input_shape[1] / weights->shape[1].as_int32();
+  CHECK_EQ(input_shape[1], weights->shape[1].as_int32() * group)
+      << "input channel should be divisible by filter channel";
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_mkldnn_conv2d_reorder_weights_fp32",
+                                {
+                                    Expr(input_shape[0]),     // batch_size
+                                    Expr(input_shape[1]),     // c_in
+                                    Expr(input_shape[2]),     // input_h
+                                    Expr(input_shape[3]),     // input_w
                                     Expr(weights->shape[0]),  // c_out
                                     Expr(group),              // group
                                     Expr(weights->shape[2]),  // filter_h
@@ -506,13 +553,12 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                     Expr(stride_w),           // stride_w
                                     Expr(dilation_h),         // dilation_h
                                     Expr(dilation_w),         // dilation_w
-                                    input,                    // input
                                     weights                   // weights
                                 });
       },
-      UniqName("conv2d_nchw_mkldnn_out"));
+      UniqName("conv2d_mkldnn_reorder_weights_out"));
   auto out = call->TupleGet(0);
-  out->WithBuffer(input->type());
+  out->WithBuffer(weights->type());
   return {out, call};
 }
 #endif
@@ -714,10 +760,13 @@ ir::Tensor BatchNorm_NCHWc(const ir::Tensor &input,
  * This operator implements the softmax layer.
  * @param A The input tensor.
  * @param axis The axis parameter.
+ * @param scale The scale multiplied to the input before softmax.
+ * @param use_log Whether to compute the log-softmax.
  * @param output_name The name of output tensor.
  * @return The calculated output tensor.
  */
-std::vector<ir::Tensor> Softmax(const ir::Tensor &A, int axis, const std::string &output_name) {
+std::vector<ir::Tensor> Softmax(
+    const ir::Tensor &A, int axis, float scale, bool use_log, const std::string &output_name) {
   if (axis == -1) {
     axis = A->shape.size() - 1;
   }
@@ -740,7 +789,8 @@ std::vector<ir::Tensor> Softmax(const ir::Tensor &A, int axis, const std::string
             new_indice.push_back(reduce_axis);
           }
         }
-        return lang::ReduceSum(lang::Exp(A(new_indice)), {reduce_axis});
+        Expr x = scale == 1.f ? A(new_indice) : A(new_indice) * Expr(scale);
+        return lang::ReduceSum(lang::Exp(x), {reduce_axis});
       },
       UniqName("softmax_temp_out"));
 
@@ -753,12 +803,160 @@ std::vector<ir::Tensor> Softmax(const ir::Tensor &A, int axis, const std::string
             new_indice.push_back(indice[i]);
           }
         }
-        return lang::Exp(A(indice)) / temp(new_indice);
+        Expr x = scale == 1.f ? A(indice) : A(indice) * Expr(scale);
+        if (use_log) {
+          return x - lang::Log(temp(new_indice));
+        }
+        return lang::Exp(x) / temp(new_indice);
       },
       UniqName("softmax_out"));
   return {out, temp};
 }
 
+std::vector<ir::Tensor> LayerNorm(const ir::Tensor &x,
+                                  const ir::Tensor &scale,
+                                  const ir::Tensor &bias,
+                                  int begin_norm_axis,
+                                  float epsilon,
+                                  const std::string &output_name) {
+  int rank = x->shape.size();
+  CHECK(begin_norm_axis >= 1 && begin_norm_axis < rank) << "begin_norm_axis should be in [1, " << rank << ")";
+  std::vector<Expr> row_shape(x->shape.begin(), x->shape.begin() + begin_norm_axis);
+  int row_size = 1;
+  for (int i = begin_norm_axis; i < rank; i++) {
+    row_size *= x->shape[i].as_int32();
+  }
+  Expr inv_size = common::make_const(x->type(), 1.f / row_size);
+
+  // mean of f(row, x) over the normalized axes
+  auto row_mean = [=](const std::function<Expr(const std::vector<Expr> &, Expr)> &f, const std::string &name) {
+    std::vector<Var> reduce_axes;
+    for (int i = begin_norm_axis; i < rank; i++) {
+      reduce_axes.push_back(Var(x->shape[i], UniqName("reduce_k")));
+    }
+    return Compute(
+        row_shape,
+        [=](const std::vector<Expr> &indice) {
+          std::vector<Expr> x_indice(indice.begin(), indice.end());
+          x_indice.insert(x_indice.end(), reduce_axes.begin(), reduce_axes.end());
+          return lang::ReduceSum(f(indice, x(x_indice)) * inv_size, reduce_axes);
+        },
+        UniqName(name));
+  };
+  auto mean = row_mean([](const std::vector<Expr> &row_indice, Expr v) { return v; }, output_name + "_mean");
+  // the variance is centered by the mean instead of E[x^2] - E[x]^2, which cancels catastrophically for the rows of
+  // large means
+  auto variance = row_mean(
+      [=](const std::vector<Expr> &row_indice, Expr v) {
+        Expr centered = v - mean(row_indice);
+        return centered * centered;
+      },
+      output_name + "_variance");
+
+  auto out = Compute(
+      x->shape,
+      [=](const std::vector<Expr> &indice) {
+        std::vector<Expr> row_indice(indice.begin(), indice.begin() + begin_norm_axis);
+        Expr var = ir::Max::Make(variance(row_indice), common::make_const(x->type(), 0.f));
+        Expr res = (x(indice) - mean(row_indice)) * lang::Rsqrt(var + common::make_const(x->type(), epsilon));
+        // the scale and bias are flattened over the normalized axes
+        Expr flat_index = indice[begin_norm_axis];
+        for (int i = begin_norm_axis + 1; i < rank; i++) {
+          flat_index = flat_index * x->shape[i] + indice[i];
+        }
+        if (scale.defined()) {
+          res = res * scale(flat_index);
+        }
+        if (bias.defined()) {
+          res = res + bias(flat_index);
+        }
+        return res;
+      },
+      output_name);
+  return {out, mean, variance};
+}
+
+std::vector<ir::Tensor> SoftmaxFused(
+    const ir::Tensor &A, int axis, float scale, bool use_log, const std::string &output_name) {
+  if (axis == -1) {
+    axis = A->shape.size() - 1;
+  }
+  CHECK_GE(axis, 0);
+  CHECK_LT(axis, A->shape.size());
+  Expr outer(1);
+  Expr inner(1);
+  for (int i = 0; i < axis; i++) {
+    outer = outer * A->shape[i];
+  }
+  for (int i = axis + 1; i < A->shape.size(); i++) {
+    inner = inner * A->shape[i];
+  }
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_softmax_fp32",
+                                {
+                                    common::AutoSimplify(outer),  // outer
+                                    A->shape[axis],               // axis_size
+                                    common::AutoSimplify(inner),  // inner
+                                    Expr(scale),                  // scale
+                                    common::make_bool(use_log),   // use_log
+                                    A,                            // x
+                                });
+      },
+      output_name);
+  auto out = call->TupleGet(0);
+  out->WithBuffer(A->type());
+  return {out, call};
+}
+
+std::vector<ir::Tensor> BatchNormStatsCPU(const ir::Tensor &x,
+                                          const std::string &data_layout,
+                                          const std::string &output_name) {
+  // x is viewed as [n, c / c_block, spatial, c_block]
+  Expr channel;
+  Expr spatial;
+  Expr c_block;
+  if (data_layout == "NCHW") {
+    CHECK_EQ(x->shape.size(), 4U) << "The input of NCHW batch norm should be 4-D";
+    channel = x->shape[1];
+    spatial = x->shape[2] * x->shape[3];
+    c_block = Expr(1);
+  } else if (data_layout == "NHWC") {
+    CHECK_EQ(x->shape.size(), 4U) << "The input of NHWC batch norm should be 4-D";
+    channel = x->shape[3];
+    spatial = x->shape[1] * x->shape[2];
+    c_block = x->shape[3];
+  } else if (data_layout == "NCHWc") {
+    CHECK_EQ(x->shape.size(), 5U) << "The input of NCHWc batch norm should be 5-D";
+    channel = x->shape[1] * x->shape[4];
+    spatial = x->shape[2] * x->shape[3];
+    c_block = x->shape[4];
+  } else {
+    LOG(FATAL) << "batch norm statistics don't support the data layout " << data_layout;
+  }
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_batch_norm_stats_fp32",
+                                {
+                                    x->shape[0],                    // n
+                                    common::AutoSimplify(channel),  // c
+                                    common::AutoSimplify(spatial),  // spatial
+                                    c_block,                        // c_block
+                                    x,                              // x
+                                });
+      },
+      output_name);
+  auto mean     = call->TupleGet(0);
+  auto variance = call->TupleGet(1);
+  mean->WithBuffer(x->type());
+  variance->WithBuffer(x->type());
+  return {mean, variance, call};
+}
+
 #ifdef CINN_WITH_MKLDNN
 std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A, int axis, const std::string &output_name) {
   CHECK_LE(A->shape.size(), 4U) << "Input's dimension of mkldnn softmax op is less than 4! Please check.";
@@ -1162,6 +1360,71 @@ std::vector<Tensor> GlobalPool2d(const Tensor &tensor, const std::string &pool_t
   }
 }
 
+std::vector<Tensor> GlobalPool2dCPU(const Tensor &tensor,
+                                    const std::string &pool_type,
+                                    int lanes,
+                                    const std::string &output_name) {
+  CHECK(pool_type == "max" || pool_type == "avg") << "Unrecognized pool_type: " << pool_type;
+  int rank = tensor->shape.size();
+  CHECK(rank == 4 || rank == 5) << "GlobalPool2dCPU requires tensor's shape_size to be 4 or 5\n";
+  auto type      = tensor->type();
+  Expr min_value = lang::min_value(type);
+  Expr h         = tensor->shape[2];
+  Expr w         = tensor->shape[3];
+  // avg pooling multiplies the sum once instead of dividing every element
+  Expr factor = make_const(type, 1.f / (h.as_int32() * w.as_int32()));
+
+  auto reduce_fn = [=](Expr value, const std::vector<Var> &axes) -> Expr {
+    return pool_type == "max" ? lang::ReduceMax(value, axes, min_value) : lang::ReduceSum(value, axes);
+  };
+  auto finish_fn = [=](Expr value) -> Expr { return pool_type == "max" ? value : value * factor; };
+
+  Var rh(h, UniqName("rh"));
+  if (rank == 5) {
+    Var rw(w, UniqName("rw"));
+    auto reduce = Compute(
+        {tensor->shape[0], tensor->shape[1], tensor->shape[4]},
+        [=](Expr n, Expr co, Expr ci) { return reduce_fn(tensor(n, co, rh, rw, ci), {rh, rw}); },
+        UniqName(output_name + "_reduce"));
+    auto out = Compute(
+        {tensor->shape[0], tensor->shape[1], Expr(1), Expr(1), tensor->shape[4]},
+        [=](Expr n, Expr co, Expr i, Expr j, Expr ci) { return finish_fn(reduce(n, co, ci)); },
+        output_name);
+    return {out, reduce};
+  }
+
+  int width = w.as_int32();
+  if (lanes > 1 && width > lanes && width % lanes == 0) {
+    Expr vec(lanes);
+    Var rj(Expr(width / lanes), UniqName("rj"));
+    auto reduce_first = Compute(
+        {tensor->shape[0], tensor->shape[1], vec},
+        [=](Expr n, Expr c, Expr k) { return reduce_fn(tensor(n, c, rh, rj * vec + k), {rh, rj}); },
+        UniqName(output_name + "_reduce_first"));
+    Var rk(vec, UniqName("rk"));
+    auto reduce = Compute(
+        {tensor->shape[0], tensor->shape[1]},
+        [=](Expr n, Expr c) { return reduce_fn(reduce_first(n, c, rk), {rk}); },
+        UniqName(output_name + "_reduce"));
+    auto out = Compute(
+        {tensor->shape[0], tensor->shape[1], Expr(1), Expr(1)},
+        [=](Expr n, Expr c, Expr i, Expr j) { return finish_fn(reduce(n, c)); },
+        output_name);
+    return {out, reduce, reduce_first};
+  }
+
+  Var rw(w, UniqName("rw"));
+  auto reduce = Compute(
+      {tensor->shape[0], tensor->shape[1]},
+      [=](Expr n, Expr c) { return reduce_fn(tensor(n, c, rh, rw), {rh, rw}); },
+      UniqName(output_name + "_reduce"));
+  auto out = Compute(
+      {tensor->shape[0], tensor->shape[1], Expr(1), Expr(1)},
+      [=](Expr n, Expr c, Expr i, Expr j) { return finish_fn(reduce(n, c)); },
+      output_name);
+  return {out, reduce};
+}
+
 std::vector<Tensor> Pool2d(const Tensor &tensor,
                            const std::vector<int> &kernel_size,
                            const std::vector<int> &stride_size,
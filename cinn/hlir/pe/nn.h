@@ -188,7 +188,29 @@ std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN(const ir::Tensor &input,
                                            int stride_w,
                                            int dilation_h,
                                            int dilation_w,
-                                           const std::string &output_name = UniqName("T_Conv2d_NCHW_out"));
+                                           const ir::Tensor &reordered_weights = ir::Tensor(),
+                                           const std::string &output_name      = UniqName("T_Conv2d_NCHW_out"));
+
+/**
+ * @brief Reorder the weights of a oneDNN convolution to the blocked layout of its primitive by
+ * cinn_cpu_mkldnn_conv2d_reorder_weights_fp32. It is computed once for the constant weights, and the result is passed
+ * to Conv2d_NCHW_MKLDNN as the reordered weights.
+ *
+ * @param weights The filter of the convolution, [C_out, C_in/group, filter_h, filter_w]
+ * @param input_shape The shape of the input of the convolution, [N, C_in, H, W]
+ *
+ * @return the reordered weights and the extern call
+ */
+std::vector<ir::Tensor> Conv2d_NCHW_MKLDNN_ReorderWeights(
+    const ir::Tensor &weights,
+    const std::vector<int> &input_shape,
+    int pad_h,
+    int pad_w,
+    int stride_h,
+    int stride_w,
+    int dilation_h,
+    int dilation_w,
+    const std::string &output_name = UniqName("T_Conv2d_NCHW_MKLDNN_ReorderWeights_out"));
 #endif
 
 /**
@@ -314,14 +336,55 @@ ir::Tensor Pad(const ir::Tensor &tensor,
 
 std::vector<ir::Tensor> Softmax(const ir::Tensor &A,
                                 int axis                       = -1,
+                                float scale                    = 1.f,
+                                bool use_log                   = false,
                                 const std::string &output_name = UniqName("T_softmax_out"));
 
+/**
+ * Softmax (or log-softmax) of `A * scale` computed by a single extern call on CPU, which finds the max and the
+ * exp-sum of each row in one online pass and writes the output once. Any axis is supported without a transpose.
+ * @return The output tensor and the extern call tensor.
+ */
+std::vector<ir::Tensor> SoftmaxFused(const ir::Tensor &A,
+                                     int axis                       = -1,
+                                     float scale                    = 1.f,
+                                     bool use_log                   = false,
+                                     const std::string &output_name = UniqName("T_softmax_out"));
+
+/**
+ * The per-channel mean and biased variance of x for the batch norm training, computed by a single extern call on CPU
+ * which accumulates them with Welford's algorithm in one parallel pass over x.
+ * @param data_layout NCHW, NHWC or NCHWc, where x of NCHWc is [N, C / c_block, H, W, c_block].
+ * @return The mean, the variance and the extern call tensor.
+ */
+std::vector<ir::Tensor> BatchNormStatsCPU(const ir::Tensor &x,
+                                          const std::string &data_layout = "NCHW",
+                                          const std::string &output_name = UniqName("T_bn_stats_out"));
+
 #ifdef CINN_WITH_MKLDNN
 std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A,
                                       int axis                       = -1,
                                       const std::string &output_name = UniqName("T_softmax_out"));
 #endif
 
+/**
+ * This operator implements the layer normalization over the axes from begin_norm_axis to the last one.
+ * The variance of each row is centered by its mean and clamped at 0 before adding epsilon.
+ * @param x The input tensor.
+ * @param scale The scale tensor of shape [prod(x.shape[begin_norm_axis:])], may be undefined.
+ * @param bias The bias tensor of shape [prod(x.shape[begin_norm_axis:])], may be undefined.
+ * @param begin_norm_axis The first normalized axis.
+ * @param epsilon The value added to the variance.
+ * @param output_name The name of output tensor.
+ * @return The output tensor, the mean and the variance of each row.
+ */
+std::vector<ir::Tensor> LayerNorm(const ir::Tensor &x,
+                                  const ir::Tensor &scale,
+                                  const ir::Tensor &bias,
+                                  int begin_norm_axis,
+                                  float epsilon,
+                                  const std::string &output_name = UniqName("T_LayerNorm_out"));
+
 ir::Tensor Slice(const ir::Tensor &A,
                  const std::vector<int> &starts,
                  const std::vector<int> &axes,
@@ -383,6 +446,24 @@ std::vector<ir::Tensor> Pool2d(const ir::Tensor &tensor,
 std::vector<ir::Tensor> GlobalPool2d(const ir::Tensor &tensor,
                                      const std::string &pool_type,
                                      const std::string &output_name);
+
+/**
+ * @brief Global pooling over the height and width of a NCHW or NCHWc tensor on CPU.
+ * The NCHWc input is reduced with vector loads along the inner channel block. The NCHW input, when its width is a
+ * multiple of lanes, is reduced into lanes partial results first so that the contiguous width is loaded with vectors.
+ *
+ * @param tensor The input tensor with shape of {N, C, H, W} or {N, C_outer, H, W, C_inner}
+ * @param pool_type "max" or "avg"
+ * @param lanes The vector width in elements
+ * @param output_name the name of the output tensor
+ *
+ * @return {output, reduce} or {output, reduce, partial reduce}, the output is of shape {N, C, 1, 1} or
+ * {N, C_outer, 1, 1, C_inner}.
+ */
+std::vector<ir::Tensor> GlobalPool2dCPU(const ir::Tensor &tensor,
+                                        const std::string &pool_type,
+                                        int lanes,
+                                        const std::string &output_name = UniqName("T_GlobalPool2d_out"));
 /**
  * @brief Perform pooling on the depth, height and width dimension of the tensor.
  *        Depth, height and width axis is determined by the data_format string in which 'D' means depth, 'H' means
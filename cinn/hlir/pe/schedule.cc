@@ -163,6 +163,54 @@ void ScheduleInjectiveCPU1(poly::Stage *stage,
   }
 }
 
+void TransposeScheduleCPU(poly::Stage *stage,
+                          const std::vector<int> &output_shape,
+                          int src_inner_axis,
+                          const common::Target &target) {
+  int dims = output_shape.size();
+  CHECK_EQ(stage->n_out_dims(), dims) << "The origin stage out dims should be same with output_shape sizes";
+  CHECK(src_inner_axis >= 0 && src_inner_axis < dims) << "src_inner_axis should be among [0, dims)";
+  // both the reads and writes of the innermost axis are contiguous already
+  if (src_inner_axis == dims - 1) {
+    ScheduleInjectiveCPU(stage, output_shape, target);
+    return;
+  }
+  int basic_factor = GetBasicFactor(stage->tensor()->type(), target);
+  int row_factor   = GetVectorizeFactor(output_shape[src_inner_axis], basic_factor);
+  int col_factor   = GetVectorizeFactor(output_shape[dims - 1], basic_factor);
+  if (row_factor == 1 || col_factor == 1) {
+    ScheduleInjectiveCPU(stage, output_shape, target);
+    return;
+  }
+  VLOG(3) << "transpose tile: [" << row_factor << ", " << col_factor << "]";
+
+  // [..., row, ..., col] -> [..., row_outer, row_inner, ..., col_outer, col_inner]
+  poly::Iterator row_outer, row_inner, col_outer, col_inner;
+  std::tie(row_outer, row_inner, col_outer, col_inner) =
+      stage->Tile(stage->axis(src_inner_axis), stage->axis(dims - 1), row_factor, col_factor);
+  // -> [..., row_outer, ..., col_outer, row_inner, col_inner]
+  std::vector<poly::Iterator> order;
+  for (int i = src_inner_axis + 2; i <= dims; i++) {
+    order.push_back(stage->axis(i));
+  }
+  order.push_back(row_inner);
+  stage->Reorder(order);
+
+  // parallel over all the axes outside the tile rows
+  if (src_inner_axis > 0) {
+    std::vector<int> levels;
+    for (int i = 0; i <= src_inner_axis; i++) {
+      levels.push_back(i);
+    }
+    stage->Fuse(levels);
+  }
+  stage->Parallel(0);
+
+  int out_dims = stage->n_out_dims();
+  stage->Unroll(out_dims - 2);
+  stage->Vectorize(out_dims - 1, col_factor);
+}
+
 int GetArrayPackingFactor(int shape, const Type &type, const common::Target &target) {
   int split_base   = GetBasicFactor(type, target);
   int split_factor = 1;
@@ -403,6 +451,25 @@ void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir
   stage[temp]->ComputeAt(stage[output], 0);
 }
 
+void LayerNormSchedule(poly::StageMap stages,
+                       const ir::Tensor &output,
+                       const ir::Tensor &mean,
+                       const ir::Tensor &variance,
+                       int begin_norm_axis,
+                       const common::Target &target) {
+  for (int i = 1; i < begin_norm_axis; i++) {
+    stages[output]->Fuse(0, 1);
+  }
+  if (target.arch == Target::Arch::NVGPU) {
+    stages[output]->Bind(0, "blockIdx.x");
+  } else {
+    stages[output]->Parallel(0);
+  }
+  // the statistics of a row are computed right before normalizing it, so the row is read from cache again
+  stages[mean]->ComputeAt(stages[output], 0);
+  stages[variance]->ComputeAt(stages[output], 0);
+}
+
 void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target) {
   auto &out    = output[0];
   auto &reduce = output[1];
@@ -414,6 +481,46 @@ void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor>
   stages[reduce]->SetBuffer("local");
   stages[reduce]->Bind(2, "threadIdx.x");
 }
+void GlobalPoolScheduleCPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target) {
+  CHECK(output.size() == 2U || output.size() == 3U) << "GlobalPoolScheduleCPU expects {out, reduce[, reduce_first]}";
+  auto &out    = output[0];
+  auto &reduce = output[1];
+  if (out->shape.size() == 5U) {
+    // reduce: [n, c_outer, c_inner, rh, rw] -> [n_c_outer_fused, rh, rw, c_inner]
+    int c_inner = reduce->shape.back().as_int32();
+    auto ci     = stages[reduce]->axis(2);
+    auto rh     = stages[reduce]->axis(3);
+    auto rw     = stages[reduce]->axis(4);
+    stages[reduce]->Reorder({rh, rw, ci});
+    stages[reduce]->Fuse({0, 1});
+    stages[reduce]->Parallel(0);
+    stages[reduce]->Vectorize(stages[reduce]->n_out_dims() - 1, c_inner);
+    auto reduce_init = reduce->GetInitTensor(stages, target);
+    stages[reduce_init]->Vectorize(stages[reduce_init]->n_out_dims() - 1, c_inner);
+    stages[out]->Fuse({0, 1, 2, 3});
+    stages[out]->Vectorize(stages[out]->n_out_dims() - 1, c_inner);
+    return;
+  }
+  stages[reduce]->Fuse({0, 1});
+  stages[reduce]->Parallel(0);
+  if (output.size() == 3U) {
+    // reduce_first: [n, c, lane, rh, rj] -> [n_c_fused, rh, rj, lane]
+    auto &reduce_first = output[2];
+    int lanes          = reduce_first->shape.back().as_int32();
+    auto lane          = stages[reduce_first]->axis(2);
+    auto rh            = stages[reduce_first]->axis(3);
+    auto rj            = stages[reduce_first]->axis(4);
+    stages[reduce_first]->Reorder({rh, rj, lane});
+    stages[reduce_first]->Fuse({0, 1});
+    stages[reduce_first]->Vectorize(stages[reduce_first]->n_out_dims() - 1, lanes);
+    auto reduce_first_init = reduce_first->GetInitTensor(stages, target);
+    stages[reduce_first_init]->Vectorize(stages[reduce_first_init]->n_out_dims() - 1, lanes);
+    // the lanes partial results of a channel are summed up right after they are computed
+    stages[reduce_first]->ComputeAt2(stages[reduce], 0);
+  }
+  stages[out]->Fuse({0, 1, 2, 3});
+}
+
 void PoolScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target) {
   CHECK_GE(stages[output]->n_out_dims(), 2);
   stages[output]->Fuse({0, 1});
@@ -1106,96 +1213,99 @@ void Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
   }
 }
 
-void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
-                                                const ir::Tensor &res,
-                                                ir::Tensor &packed_out,
-                                                const ir::Tensor &input_pad,
-                                                const ir::Tensor &weights_dilation,
-                                                const ir::Tensor &data,
-                                                const common::Target &target,
-                                                bool do_padding) {
-  CHECK(target.arch == Target::Arch::X86) << "Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse schedule only used in x86";
+void Depthwise_Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
+                                         const ir::Tensor &res,
+                                         ir::Tensor &packed_out,
+                                         const ir::Tensor &input_pad,
+                                         const ir::Tensor &weights_dilation,
+                                         const ir::Tensor &data,
+                                         const common::Target &target,
+                                         const std::string &key,
+                                         bool do_padding) {
+  CHECK(target.arch == Target::Arch::X86) << "Depthwise_Conv2d_NCHWc_Schedule_CPU schedule only used in x86";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
   auto type = packed_out->type();
-  absl::flat_hash_map<std::string, int> conv2d_factors;
   CHECK_EQ(packed_out->shape.size(), 5U) << "packed_out's shape size should be 5";
-  Expr w_out             = common::AutoSimplify(packed_out->shape[3]);
-  int ow                 = w_out.as_int32();
-  int basic_split_factor = GetBasicFactor(type, target);
-  GetConv2dFactors(&conv2d_factors, -1, -1, -1, -1, ow, type, target);
-  int ow_bn_size = conv2d_factors["ow_bn"];
-
-  auto input_shape = input_pad->shape;
-  int shape_size   = input_shape.size();
-  CHECK_EQ(shape_size, 5U) << "input shape size should be 5";
+  Expr w_out = common::AutoSimplify(packed_out->shape[3]);
+  int ow     = w_out.as_int32();
+  CHECK_EQ(input_pad->shape.size(), 5U) << "input shape size should be 5";
   Expr oc_bn     = common::AutoSimplify(packed_out->shape.back());
-  Expr ic_bn     = common::AutoSimplify(input_shape.back());
   int oc_bn_size = oc_bn.as_int32();
-  int ic_bn_size = ic_bn.as_int32();
+
+  absl::flat_hash_map<std::string, int> conv2d_factors;
+  GetConv2dFactors(&conv2d_factors, -1, -1, -1, -1, ow, type, target, key);
+  int ow_bn_size = conv2d_factors["ow_bn"];
+  int unroll_kw  = 0;
+  if (conv2d_factors.count("unroll_kw")) {
+    unroll_kw = conv2d_factors["unroll_kw"];
+  }
   VLOG(3) << "ow_bn_size " << ow_bn_size;
   VLOG(3) << "oc_bn_size " << oc_bn_size;
-  VLOG(3) << "ic_bn_size " << ic_bn_size;
+  VLOG(3) << "unroll_kw " << unroll_kw;
 
   // data
   if (data.defined()) {
     stages[data]->ComputeInline();
   }
   // input_pad
-  if (!do_padding) {
+  if (do_padding) {
+    CHECK_GE(stages[input_pad]->n_out_dims(), 3U) << "input_pad's out_dims should be more than 3";
+    stages[input_pad]->Fuse({0, 1, 2});
+    stages[input_pad]->Parallel(0);
+    stages[input_pad]->Vectorize(stages[input_pad]->n_out_dims() - 1, input_pad->shape.back().as_int32());
+  } else {
     stages[input_pad]->ComputeInline();
   }
   // weights
   if (weights_dilation.defined()) {
     CHECK_GE(stages[weights_dilation]->n_out_dims(), 3U) << "weights_dilation's out_dims should be more than 3";
-    // Reorder: [oc_outer, ic_outer, oh, ow, ic_inner, oc_inner] ->
-    // [oc_outer, oh, ic_outer, ow, ic_inner, oc_inner]
+    // Reorder: [oc_outer, fc_outer, kh, kw, fc_inner, oc_inner] ->
+    // [oc_outer, kh, fc_outer, kw, fc_inner, oc_inner]
     stages[weights_dilation]->Reorder({2, 1});
   }
 
-  // packed_out
-  auto CC = stages[packed_out]->CacheWrite("global", stages, packed_out);
-  VLOG(3) << "stages[packed_out]->transformed_domain()" << stages[packed_out]->transformed_domain();
-  VLOG(3) << "stages[CC]->transformed_domain()" << stages[CC]->transformed_domain();
-  // packed_out: [batch, oc_outer, oh, ow, oc_inner]
-  // split ow
+  // packed_out: [batch, oc_outer, oh, ow, oc_inner, fc, kh, kw] ->
+  // [batch_oc_outer_oh_fused, ow_outer, fc, kh, kw, ow_inner, oc_inner]
   stages[packed_out]->Split(3, ow_bn_size);
-  stages[packed_out]->Vectorize(stages[packed_out]->n_out_dims() - 1, packed_out->shape.back().as_int32());
-
-  // CC: [batch, oc_outer, oh, ow, oc_inner]
-  // packed_out: [batch, oc_outer, oh, ow_outer, ow_inner, oc_inner]
-  stages[CC]->ComputeAt2(stages[packed_out], 3);
+  stages[packed_out]->Fuse({0, 1, 2});
+  auto ow_inner = stages[packed_out]->axis(2);
+  auto oc_inner = stages[packed_out]->axis(3);
+  auto fc       = stages[packed_out]->axis(4);
+  auto kh       = stages[packed_out]->axis(5);
+  auto kw       = stages[packed_out]->axis(6);
+  // the ow_inner x oc_inner accumulators stay in vector registers while sliding over the kernel window, and every
+  // kernel vector is loaded once for the whole tile
+  stages[packed_out]->Reorder({fc, kh, kw, ow_inner, oc_inner});
+  stages[packed_out]->Vectorize(stages[packed_out]->n_out_dims() - 1, oc_bn_size);
+  stages[packed_out]->Unroll(stages[packed_out]->n_out_dims() - 2);
+  if (unroll_kw) {
+    stages[packed_out]->Unroll(kw);
+  }
   VLOG(3) << "stages[packed_out]->transformed_domain()" << stages[packed_out]->transformed_domain();
-  VLOG(3) << "stages[CC]->transformed_domain()" << stages[CC]->transformed_domain();
 
-  // CC: [batch, oc_outer, oh, ow_outer, ow_inner, oc_inner, fc, kh, kw]
-  // batch, oc_outer, oh, ow_outer, kh, kw, ow_inner, oc_inner
-  auto CC_ow_inner = stages[CC]->axis(4);
-  auto CC_oc_inner = stages[CC]->axis(5);
-  auto CC_fc       = stages[CC]->axis(6);
-  auto CC_kh       = stages[CC]->axis(7);
-  auto CC_kw       = stages[CC]->axis(8);
-  stages[CC]->Reorder({CC_fc, CC_kh, CC_kw, CC_ow_inner, CC_oc_inner});
-  stages[CC]->Vectorize(stages[CC]->n_out_dims() - 1, CC->shape.back().as_int32());
-  VLOG(3) << "stages[CC]->transformed_domain()" << stages[CC]->transformed_domain();
-  // CC_init
-  auto CC_init = CC->GetInitTensor(stages, target);
-  stages[CC_init]->Vectorize(stages[CC_init]->n_out_dims() - 1, CC_init->shape.back().as_int32());
-
-  // res
-  // n, oc, oh, ow
+  // res: [n, oc, oh, ow] -> [n_oc_outer_oh_fused, ow_outer, ow_inner, oc_inner]
   if (res.defined()) {
     stages[res]->Split(1, oc_bn_size);
     stages[res]->Split(4, ow_bn_size);
-    // Reorder: [n, oc_outer, oc_inner, oh, ow_outer, ow_inner] ->
-    // [n, oc_outer, oh, ow_outer, ow_inner, oc_inner]
     auto oc_inner1 = stages[res]->axis(2);
     auto oh1       = stages[res]->axis(3);
     auto ow_outer1 = stages[res]->axis(4);
     auto ow_inner1 = stages[res]->axis(5);
     stages[res]->Reorder({oh1, ow_outer1, ow_inner1, oc_inner1});
+    stages[res]->Fuse({0, 1, 2});
+    stages[res]->Parallel(0);
     VLOG(3) << "stages[res]->transformed_domain()" << stages[res]->transformed_domain();
+    // compute every NCHWc tile right before it is converted back to NCHW, the ops fused after the conv copy the
+    // transform of res and inherit this compute_at
+    stages[packed_out]->ComputeAt2(stages[res], 1);
+  } else {
+    stages[packed_out]->Parallel(0);
   }
+  // packed_out init
+  auto packed_out_init = packed_out->GetInitTensor(stages, target);
+  stages[packed_out_init]->Vectorize(stages[packed_out_init]->n_out_dims() - 1, oc_bn_size);
+  stages[packed_out_init]->Unroll(stages[packed_out_init]->n_out_dims() - 2);
 }
 
 void CudaScheduleMul(poly::StageMap stages,
@@ -72,6 +72,21 @@ void ScheduleInjectiveCPU1(poly::Stage *stage,
                            const common::Target &target,
                            bool vectorizable = true);
 
+/**
+ * @brief Tiled schedule for data movement ops(transpose, layout_transform) whose innermost output axis doesn't walk the
+ * innermost axis of the input. The two axes are blocked into a [vector_width, vector_width] tile so that both the
+ * strided reads and the contiguous writes of one tile stay in L1, the tile rows are unrolled and the tile columns are
+ * vectorized, which lets LLVM lower the tile into in-register shuffles.
+ * @param stage The stage of the output tensor
+ * @param output_shape The shape of the output tensor
+ * @param src_inner_axis The output axis which walks the innermost axis of the input
+ * @param target The target
+ */
+void TransposeScheduleCPU(poly::Stage *stage,
+                          const std::vector<int> &output_shape,
+                          int src_inner_axis,
+                          const common::Target &target);
+
 void MatmulScheduleCPU(poly::StageMap stage,
                        const ir::Tensor &output,
                        const ir::Tensor &packedB,
@@ -84,6 +99,13 @@ void MulScheduleCPU(poly::StageMap stage,
 
 void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis = -1);
 
+void LayerNormSchedule(poly::StageMap stages,
+                       const ir::Tensor &output,
+                       const ir::Tensor &mean,
+                       const ir::Tensor &variance,
+                       int begin_norm_axis,
+                       const common::Target &target);
+
 void GetConv2dFactors(absl::flat_hash_map<std::string, int> *factors,
                       int oc,
                       int ic,
@@ -113,6 +135,7 @@ void Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
                                const std::string &key,
                                bool do_padding);
 void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target);
+void GlobalPoolScheduleCPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target);
 void PoolScheduleCPU(poly::StageMap stages, const ir::Tensor &output, const common::Target &target);
 void PoolScheduleGPU(poly::StageMap stages, ir::Tensor &output, const common::Target &target);
 
@@ -142,14 +165,20 @@ void Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse(poly::StageMap stages,
                                           const ir::Tensor &data,
                                           const common::Target &target);
 
-void Depthwise_Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
-                                                const ir::Tensor &res,
-                                                ir::Tensor &packed_out,
-                                                const ir::Tensor &input_pad,
-                                                const ir::Tensor &weights_dilation,
-                                                const ir::Tensor &data,
-                                                const common::Target &target,
-                                                bool do_padding);
+/**
+ * Schedule the NCHWc depthwise convolution tile by tile: every [ow_bn, oc_bn] output tile is accumulated in vector
+ * registers over the kernel window, and converted back to NCHW right away, so that the elementwise ops fused after it
+ * (e.g. batchnorm and relu6) are applied to the tile while it is still in cache.
+ */
+void Depthwise_Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
+                                         const ir::Tensor &res,
+                                         ir::Tensor &packed_out,
+                                         const ir::Tensor &input_pad,
+                                         const ir::Tensor &weights_dilation,
+                                         const ir::Tensor &data,
+                                         const common::Target &target,
+                                         const std::string &key,
+                                         bool do_padding);
 
 void CudaScheduleMul(poly::StageMap stages,
                      ir::Tensor output,
@@ -491,6 +491,70 @@ std::vector<Tensor> MulMKL(const Tensor& A, const Tensor& B, const std::string&
   return {out, call};
 }
 
+std::vector<Tensor> PackBMKL(const Tensor& B,
+                             int M,
+                             int N,
+                             int K,
+                             bool trans_b,
+                             float alpha,
+                             const std::string& name,
+                             const common::Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "mkl should be used in the cpu environment";
+  CHECK_EQ(B->shape.size(), 2U) << "tensor_B's shape size should be two while current shape size is "
+                                << B->shape.size();
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_mkl_gemm_pack_b_fp32",
+                                {
+                                    Expr(alpha),                 // alpha
+                                    Expr(M),                     // M
+                                    Expr(N),                     // N
+                                    Expr(K),                     // K
+                                    common::make_bool(trans_b),  // tb
+                                    B->shape.back(),             // ldb
+                                    B,                           // B
+                                });
+      },
+      UniqName("pack_b_mkl_out"));
+  auto out = call->TupleGet(0);
+  out->WithBuffer(B->type());
+  return {out, call};
+}
+
+std::vector<Tensor> MatmulPackedMKL(const Tensor& A,
+                                    const Tensor& packed_B,
+                                    int M,
+                                    int N,
+                                    int K,
+                                    bool trans_a,
+                                    const std::string& name,
+                                    const common::Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "mkl should be used in the cpu environment";
+  CHECK_EQ(A->shape.size(), 2U) << "tensor_A's shape size should be two while current shape size is "
+                                << A->shape.size();
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_mkl_gemm_compute_fp32",
+                                {
+                                    Expr(M),                     // M
+                                    Expr(N),                     // N
+                                    Expr(K),                     // K
+                                    common::make_bool(trans_a),  // ta
+                                    A->shape.back(),             // lda
+                                    Expr(N),                     // ldc
+                                    common::make_zero<float>(),  // beta
+                                    A,                           // A
+                                    packed_B,                    // packed_B
+                                });
+      },
+      UniqName("matmul_packed_mkl_out"));
+  auto out = call->TupleGet(0);
+  out->WithBuffer(A->type());
+  return {out, call};
+}
+
 std::vector<ir::Tensor> MulBias(const Tensor& A,
                                 const Tensor& B,
                                 const Tensor& C,
@@ -651,6 +715,29 @@ ir::Tensor LayoutTransform(const Tensor& input,
   return {res};
 }
 
+int GetLayoutTransformInnerAxis(const std::string& src_layout, const std::string& dst_layout) {
+  ir::Layout old_layout(src_layout);
+  ir::Layout new_layout(dst_layout);
+  const std::string& src_names = old_layout.axis_names();
+  const std::string& dst_names = new_layout.axis_names();
+  CHECK(!src_names.empty());
+  char inner_name = src_names.back();
+  char sub_name   = inner_name;
+  char prim_name  = inner_name;
+  if (inner_name >= 'A' && inner_name <= 'Z') {
+    sub_name += 'a' - 'A';
+  } else {
+    prim_name += 'A' - 'a';
+  }
+  // if the destination also splits this axis, its sub-axis walks the innermost elements of the input
+  int index = dst_names.find(sub_name);
+  if (index == dst_names.npos) {
+    index = dst_names.find(prim_name);
+  }
+  CHECK(index != dst_names.npos) << "can't find axis " << prim_name << " of " << src_layout << " in " << dst_layout;
+  return index;
+}
+
 ir::Tensor Reverse(const ir::Tensor& input, const std::vector<int>& axis, const std::string& output_name) {
   for (auto& val : axis) {
     CHECK(val >= 0 && val < input->shape.size()) << "axis should be [0,n_dim)";
@@ -706,6 +793,34 @@ ir::Tensor Transpose(const ir::Tensor& input, const std::vector<int>& axis, cons
       output_name);
 }
 
+ir::Tensor Gather(
+    const ir::Tensor& input, const ir::Tensor& index, int axis, int padding_idx, const std::string& output_name) {
+  CHECK(axis >= 0 && axis < input->shape.size()) << "axis should be [0,n_dim)";
+  CHECK(index->type().is_int(32) || index->type().is_int(64))
+      << "The index of gather should be int32 or int64, but get " << index->type();
+  int index_dims = index->shape.size();
+  std::vector<Expr> output_shape(input->shape.begin(), input->shape.begin() + axis);
+  output_shape.insert(output_shape.end(), index->shape.begin(), index->shape.end());
+  output_shape.insert(output_shape.end(), input->shape.begin() + axis + 1, input->shape.end());
+
+  return lang::Compute(
+      output_shape,
+      [=](const std::vector<Expr>& indice) {
+        std::vector<Expr> index_indice(indice.begin() + axis, indice.begin() + axis + index_dims);
+        // the int64 ids of paddle are narrowed to the int32 indices of the tensor
+        Expr picked = index->type().is_int(32) ? index(index_indice) : ir::Cast::Make(Int(32), index(index_indice));
+        std::vector<Expr> indexs(indice.begin(), indice.begin() + axis);
+        indexs.push_back(picked);
+        indexs.insert(indexs.end(), indice.begin() + axis + index_dims, indice.end());
+        if (padding_idx < 0) {
+          return input(indexs);
+        }
+        return ir::Select::Make(
+            ir::EQ::Make(picked, Expr(padding_idx)), common::make_const(input->type(), 0), input(indexs));
+      },
+      output_name);
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -111,6 +111,41 @@ std::vector<ir::Tensor> MulMKL(const ir::Tensor& A,
                                const std::string& name      = UniqName("T_Transform_MulMKL_out"),
                                const common::Target& target = common::DefaultHostTarget());
 
+/**
+ * @brief Pack the matrix B of a GEMM [M, K] * [K, N] into the internal layout of MKL by cinn_cpu_mkl_gemm_pack_b_fp32,
+ * it is computed once for the constant weights and consumed by MatmulPackedMKL.
+ *
+ * @param B The matrix B, [K, N] or [N, K] if \p trans_b
+ * @param alpha The scaling factor of the product, multiplied into the packed B
+ *
+ * @return the packed B and the extern call
+ */
+std::vector<ir::Tensor> PackBMKL(const ir::Tensor& B,
+                                 int M,
+                                 int N,
+                                 int K,
+                                 bool trans_b                 = false,
+                                 float alpha                  = 1,
+                                 const std::string& name      = UniqName("T_Transform_PackBMKL_out"),
+                                 const common::Target& target = common::DefaultHostTarget());
+
+/**
+ * @brief The matrix multiplication of A and B packed by PackBMKL with the same M, N and K.
+ *
+ * @param A The matrix A, [M, K] or [K, M] if \p trans_a
+ * @param packed_B The packed matrix B
+ *
+ * @return the output [M, N] and the extern call
+ */
+std::vector<ir::Tensor> MatmulPackedMKL(const ir::Tensor& A,
+                                        const ir::Tensor& packed_B,
+                                        int M,
+                                        int N,
+                                        int K,
+                                        bool trans_a                 = false,
+                                        const std::string& name      = UniqName("T_Transform_MatmulPackedMKL_out"),
+                                        const common::Target& target = common::DefaultHostTarget());
+
 std::vector<ir::Tensor> MulBias(const ir::Tensor& A,
                                 const ir::Tensor& B,
                                 const ir::Tensor& C,
@@ -129,6 +164,14 @@ std::vector<ir::Expr> InferShapeLayoutTransform(const std::vector<Expr>& input_s
                                                 const ir::Layout& new_layout,
                                                 absl::flat_hash_map<int, std::vector<int>>* split_index_map);
 
+/**
+ * @brief Get the output axis of a layout transform that walks the innermost (contiguous) axis of its input.
+ * e.g. NCHW -> NCHW16c returns 3 (W) and NCHW16c -> NCHW returns 1 (C).
+ * @param src_layout The source layout
+ * @param dst_layout The destination layout
+ */
+int GetLayoutTransformInnerAxis(const std::string& src_layout, const std::string& dst_layout);
+
 /**
  * @brief Perform meta op Reverse
  * @param input The input tensor
@@ -149,6 +192,21 @@ ir::Tensor Transpose(const ir::Tensor& input,
                      const std::vector<int>& axis,
                      const std::string& output_name = UniqName("T_Transpose_out"));
 
+/**
+ * @brief Perform meta op Gather, which picks the slices of input along axis by index.
+ * The output shape is input.shape[:axis] + index.shape + input.shape[axis+1:].
+ * @param input The input tensor
+ * @param index The int32 or int64 index tensor
+ * @param axis gather axis
+ * @param padding_idx the slices picked by padding_idx are zeros, -1 means no padding, used by embedding lookup
+ * @param output_name the name of the output tensor
+ */
+ir::Tensor Gather(const ir::Tensor& input,
+                  const ir::Tensor& index,
+                  int axis,
+                  int padding_idx                = -1,
+                  const std::string& output_name = UniqName("T_Gather_out"));
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
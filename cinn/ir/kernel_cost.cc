@@ -0,0 +1,101 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/kernel_cost.h"
+
+#include "cinn/ir/ir_mutator.h"
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+double ConstantExtent(const Expr& extent) {
+  if (extent.defined() && extent.is_constant()) {
+    return static_cast<double>(extent.get_constant());
+  }
+  VLOG(3) << "The loop extent " << extent << " is not constant, count the loop body once";
+  return 1.;
+}
+
+struct FlopCounter : public ir::IRMutator<const Expr*> {
+  double flops{0.};
+
+  void operator()(const Expr* expr) { ir::IRMutator<const Expr*>::Visit(expr, expr); }
+
+ private:
+  // the number of the times the visited node runs
+  double trip_count_{1.};
+
+  void Count(const Type& type) {
+    if (type.is_float()) flops += trip_count_ * type.lanes();
+  }
+
+  void VisitBody(double extent, const Expr* body) {
+    if (extent <= 0.) return;
+    trip_count_ *= extent;
+    ir::IRMutator<const Expr*>::Visit(body, body);
+    trip_count_ /= extent;
+  }
+
+  void Visit(const For* op, const Expr* expr) override { VisitBody(ConstantExtent(op->extent), &op->body); }
+
+  void Visit(const PolyFor* op, const Expr* expr) override {
+    VisitBody(ConstantExtent(op->ExtractExtent()), &op->body);
+  }
+
+  void Visit(const Call* op, const Expr* expr) override {
+    if (op->is_extern_call()) Count(op->type());
+    ir::IRMutator<const Expr*>::Visit(op, expr);
+  }
+
+#define __(op__)                                          \
+  void Visit(const op__* op, const Expr* expr) override { \
+    Count(op->type());                                    \
+    ir::IRMutator<const Expr*>::Visit(op, expr);          \
+  }
+  __(Add)
+  __(Sub)
+  __(Mul)
+  __(Div)
+  __(Min)
+  __(Max)
+#undef __
+};
+
+}  // namespace
+
+KernelCost EstimateKernelCost(const LoweredFunc& func) {
+  KernelCost cost;
+  FlopCounter counter;
+  counter(&func->body);
+  cost.flops = counter.flops;
+
+  for (auto& arg : func->args) {
+    if (!arg.is_buffer()) continue;
+    double numel = 1.;
+    for (auto& dim : arg.buffer_arg()->shape) {
+      if (!dim.is_constant()) {
+        numel = 0.;
+        break;
+      }
+      numel *= dim.get_constant();
+    }
+    cost.bytes += numel * arg.buffer_arg()->dtype.bits() / 8;
+  }
+  return cost;
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,49 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "cinn/ir/lowered_func.h"
+
+namespace cinn {
+namespace ir {
+
+/**
+ * The static cost of a kernel, used to place the kernel on the roofline of the machine.
+ */
+struct KernelCost {
+  //! The floating point operations of one run.
+  double flops{0.};
+  //! The bytes of the buffer arguments, it is the memory traffic of one run when the buffers are read or written once.
+  double bytes{0.};
+
+  double arithmetic_intensity() const { return bytes > 0. ? flops / bytes : 0.; }
+
+  KernelCost& operator+=(const KernelCost& other) {
+    flops += other.flops;
+    bytes += other.bytes;
+    return *this;
+  }
+};
+
+/**
+ * Estimate the cost of the lowered function. Each floating point add, sub, mul, div, min, max and extern math call is
+ * an operation of every lane, multiplied by the constant extents of the loops around it; a loop of unknown extent is
+ * counted once. The bytes are the footprints of the buffer arguments of constant shapes. The operations inside the
+ * external library calls (such as the MKL gemm) are not seen.
+ */
+KernelCost EstimateKernelCost(const LoweredFunc& func);
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,65 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/kernel_cost.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+
+namespace cinn {
+namespace ir {
+
+TEST(KernelCost, elementwise) {
+  Expr M(100);
+  Expr N(200);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+
+  auto C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * B(i, j) + 1.f; }, "C");
+
+  auto stages = CreateStages({C});
+  auto fn     = Lower("fn", stages, {A, B, C});
+
+  auto cost = EstimateKernelCost(fn);
+  ASSERT_EQ(cost.flops, 2. * 100 * 200);
+  ASSERT_EQ(cost.bytes, 3. * 100 * 200 * 4);
+}
+
+TEST(KernelCost, matmul) {
+  Expr M(32);
+  Expr K(16);
+  Expr N(8);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+
+  Var k(K.as_int32(), "k0");
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return lang::ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+  auto stages = CreateStages({C});
+  stages[C]->Split("i", 8);
+  auto fn = Lower("matmul", stages, {A, B, C});
+  LOG(INFO) << "fn:\n" << fn;
+
+  // the index arithmetic of the split loop is not counted
+  auto cost = EstimateKernelCost(fn);
+  ASSERT_EQ(cost.flops, 2. * 32 * 16 * 8);
+  ASSERT_EQ(cost.bytes, (32. * 16 + 16 * 8 + 32 * 8) * 4);
+  ASSERT_EQ(cost.arithmetic_intensity(), cost.flops / cost.bytes);
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -14,67 +14,163 @@
 
 #include "cinn/optim/eliminate_broadcast_in_forloop.h"
 
+#include <algorithm>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_visitor.h"
 #include "cinn/optim/ir_replace.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace optim {
 
 namespace detail {
 
+//! Collect the broadcasts of loaded values which are evaluated unconditionally, the operands of a select or a call
+//! may be guarded and are skipped.
+struct BroadcastLoadCollector : public ir::IRMutator<Expr*> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::Broadcast* op, Expr* expr) override {
+    auto loads = ir::CollectIRNodes(op->value, [](const Expr* x) { return x->As<ir::Load>(); });
+    auto calls = ir::CollectIRNodes(op->value, [](const Expr* x) { return x->As<ir::Call>(); });
+    if (!loads.empty() && calls.empty()) {
+      broadcasts.push_back(*expr);
+    }
+  }
+
+  void Visit(const ir::Select* op, Expr* expr) override {}
+  void Visit(const ir::Call* op, Expr* expr) override {}
+
+  std::vector<Expr> broadcasts;
+};
+
+/**
+ * Hoist the broadcasts of loop-invariant loads out of the forloops.
+ *
+ * The vectorized elementwise kernels splat every operand that is not indexed by the vectorized axis, such as the bias
+ * in `C[n, c, h, w] = A[n, c, h, w] + B[c]`, and the load and the splat are redone for each vector. Each of them is
+ * computed once by a Let placed right before the outermost forloop it is invariant to, that is, the loop variable
+ * and the Let variables it references are defined outside the forloop and the buffers it loads are not written in it.
+ */
 struct EliminateBroadcastInForloop : public ir::IRMutator<Expr*> {
   void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
 
-  void Visit(const ir::Store* op, Expr* expr) {
-    // TODO(Superjom) Support single one level of forloop.
-    if (forloop_stack.size() < 2) return;
+  void Visit(const ir::Store* op, Expr* expr) override {
+    if (forloop_stack.empty()) return;
 
     auto* node = expr->As<ir::Store>();
 
-    auto broadcasts = ir::CollectIRNodes(node->value, [&](const Expr* expr) { return expr->As<ir::Broadcast>(); });
-    std::vector<Expr> let_exprs;
+    BroadcastLoadCollector collector;
+    Expr value = node->value;
+    collector(&value);
 
-    Var tmp;
-    Expr let_expr;
+    for (Expr broadcast : collector.broadcasts) {
+      int level = GetHoistLevel(broadcast);
+      if (level >= static_cast<int>(forloop_stack.size())) continue;
+      VLOG(4) << "eliminating " << broadcast << " out of the forloop of level " << level;
+      Var tmp = GetHoistedVar(broadcast, &hoisted_lets[level]);
+
+      optim::IrReplace(&node->value, broadcast, tmp);
+    }
+  }
+
+  void Visit(const ir::Let* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* symbol = op->symbol.As<ir::_Var_>();
+    if (symbol) let_levels[symbol->name] = forloop_stack.size();
+  }
+
+  void Visit(const ir::IfThenElse* op, Expr* expr) override {
+    // nothing is hoisted out of a condition
+    guard_levels.push_back(forloop_stack.size());
+    ir::IRMutator<>::Visit(op, expr);
+    guard_levels.pop_back();
+  }
+
+  void Visit(const ir::For* op, Expr* expr) override { VisitForloop(op, expr); }
+
+  void Visit(const ir::PolyFor* op, Expr* expr) override { VisitForloop(op, expr); }
 
-    Var cur_level_loop_var = forloop_stack.back()->As<ir::For>() ? forloop_stack.back()->As<ir::For>()->loop_var
-                                                                 : forloop_stack.back()->As<ir::PolyFor>()->iterator;
-    for (Expr broadcast : broadcasts) {
-      if (ContainsLoopVar(broadcast, cur_level_loop_var)) continue;
-      VLOG(4) << "eliminating " << broadcast;
-      std::tie(let_expr, tmp) = CreateTmpLet(broadcast);
-      let_exprs.push_back(let_expr);
+ private:
+  template <typename T>
+  void VisitForloop(const T* op, Expr* expr) {
+    forloop_stack.push_back(expr);
+    hoisted_lets.emplace_back();
+    ir::IRMutator<>::Visit(op, expr);
+    auto lets = std::move(hoisted_lets.back());
+    hoisted_lets.pop_back();
+    forloop_stack.pop_back();
 
-      optim::IrReplace(expr, broadcast, tmp);
+    // insert the let expressions right before the forloop.
+    if (!lets.empty()) {
+      lets.push_back(*expr);
+      *expr = ir::Block::Make(lets);
     }
+  }
 
-    // insert the let expressions to the outer forloop.
+  Var GetLoopVar(Expr* forloop) {
+    return forloop->As<ir::For>() ? forloop->As<ir::For>()->loop_var : forloop->As<ir::PolyFor>()->iterator;
+  }
 
-    Expr* outer_forloop = forloop_stack[forloop_stack.size() - 2];
+  //! The buffer a tensor reads from or writes to.
+  std::string GetBufferName(const Expr& tensor) {
+    auto* node = tensor.As<ir::_Tensor_>();
+    CHECK(node);
+    return node->buffer.defined() ? node->buffer->name : node->name;
+  }
 
-    auto& outer_forloop_body =
-        outer_forloop->As<ir::For>() ? outer_forloop->As<ir::For>()->body : outer_forloop->As<ir::PolyFor>()->body;
+  bool WriteInForloop(Expr* forloop, const std::string& buffer_name) {
+    auto writes = ir::CollectIRNodes(*forloop, [&](const Expr* x) {
+      if (x->As<ir::Store>()) return GetBufferName(x->As<ir::Store>()->tensor) == buffer_name;
+      // be conservative with the calls writing arguments
+      return x->As<ir::Call>() && !x->As<ir::Call>()->write_args.empty();
+    });
+    return !writes.empty();
+  }
 
-    auto* outer_forloop_body_block = outer_forloop_body.As<ir::Block>();
-    if (outer_forloop_body_block) {
-      outer_forloop_body_block->stmts.insert(
-          std::begin(outer_forloop_body_block->stmts), let_exprs.begin(), let_exprs.end());
+  //! Get the level of the outermost forloop \p expr is invariant to, the size of forloop_stack if none.
+  int GetHoistLevel(Expr expr) {
+    int level = guard_levels.empty() ? 0 : guard_levels.back();
+
+    auto vars = ir::CollectIRNodes(expr, [](const Expr* x) { return x->As<ir::_Var_>(); });
+    for (auto& var : vars) {
+      auto& name = var.As<ir::_Var_>()->name;
+      for (int i = 0; i < forloop_stack.size(); i++) {
+        if (GetLoopVar(forloop_stack[i])->name == name) level = std::max(level, i + 1);
+      }
+      if (let_levels.count(name)) level = std::max(level, let_levels.at(name));
+    }
 
-    } else {
-      let_exprs.push_back(outer_forloop_body);
-      outer_forloop_body = ir::Block::Make(let_exprs);
+    auto loads = ir::CollectIRNodes(expr, [](const Expr* x) { return x->As<ir::Load>(); });
+    for (auto& load : loads) {
+      auto buffer_name = GetBufferName(load.As<ir::Load>()->tensor);
+      for (int i = level; i < forloop_stack.size(); i++) {
+        if (WriteInForloop(forloop_stack[i], buffer_name)) {
+          level = i + 1;
+          break;
+        }
+      }
     }
+    return level;
   }
 
-  bool ContainsLoopVar(Expr expr, Var loop_var) {
-    return !ir::CollectIRNodes(expr, [&](const Expr* e) -> bool {
-              return e->As<ir::_Var_>() && e->As<ir::_Var_>()->name == loop_var->name;
-            }).empty();
+  //! Get the variable holding \p body, reusing the let expression of the same value hoisted by the former stores.
+  Var GetHoistedVar(Expr body, std::vector<Expr>* lets) {
+    auto repr = utils::GetStreamCnt(body);
+    for (auto& let : *lets) {
+      if (utils::GetStreamCnt(let.As<ir::Let>()->body) == repr) return let.As<ir::Let>()->symbol.as_var_ref();
+    }
+    Var tmp;
+    Expr let_expr;
+    std::tie(let_expr, tmp) = CreateTmpLet(body);
+    lets->push_back(let_expr);
+    return tmp;
   }
 
   std::tuple<Expr, Var> CreateTmpLet(Expr body) {
@@ -85,19 +181,13 @@ struct EliminateBroadcastInForloop : public ir::IRMutator<Expr*> {
     return std::make_tuple(let_expr, tmp);
   }
 
-  void Visit(const ir::For* op, Expr* expr) {
-    forloop_stack.push_back(expr);
-    ir::IRMutator<>::Visit(op, expr);
-    forloop_stack.pop_back();
-  }
-
-  void Visit(const ir::PolyFor* op, Expr* expr) {
-    forloop_stack.push_back(expr);
-    ir::IRMutator<>::Visit(op, expr);
-    forloop_stack.pop_back();
-  }
-
   std::vector<Expr*> forloop_stack;
+  //! The let expressions to insert right before each forloop in forloop_stack.
+  std::vector<std::vector<Expr>> hoisted_lets;
+  //! The sizes of forloop_stack at the conditions enclosing the current statement.
+  std::vector<int> guard_levels;
+  //! The sizes of forloop_stack at the definitions of the Let variables.
+  std::unordered_map<std::string, int> let_levels;
 };
 
 }  // namespace detail
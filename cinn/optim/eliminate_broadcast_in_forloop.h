@@ -18,6 +18,10 @@
 namespace cinn {
 namespace optim {
 
+/**
+ * Hoist the broadcasts of loop-invariant loads, the scalar operands splatted by the vectorization, out of the
+ * forloops they are invariant to.
+ */
 void EliminateBroadcastInForloop(Expr* expr);
 
 }  // namespace optim
@@ -0,0 +1,97 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/eliminate_broadcast_in_forloop.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace optim {
+
+bool IsBroadcastLoad(const Expr* x) {
+  auto* broadcast = x->As<ir::Broadcast>();
+  return broadcast && broadcast->value.As<ir::Load>();
+}
+
+TEST(EliminateBroadcastInForloop, hoist_bias) {
+  Placeholder<float> A("A", {32, 64});
+  Placeholder<float> B("B", {32});
+
+  // C[i, j] = A[i, j] + B[i], where B[i] is splatted to the vector lanes of j
+  auto C      = Compute({Expr(32), Expr(64)}, [&](Var i, Var j) { return A(i, j) + B(i); }, "C");
+  auto stages = CreateStages({C});
+  stages[C]->Vectorize(1, 16);
+
+  auto func = Lower("add_bias", stages, {A, B, C});
+  LOG(INFO) << "func:\n" << func;
+
+  // the splat of B[i] is computed once before the loop over j
+  auto lets = ir::CollectIRNodes(func->body, [](const Expr* x) {
+    auto* let = x->As<ir::Let>();
+    return let && let->body.As<ir::Broadcast>() && let->body.As<ir::Broadcast>()->value.As<ir::Load>();
+  });
+  ASSERT_EQ(lets.size(), 1UL);
+
+  auto stores = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::Store>(); });
+  for (auto& store : stores) {
+    auto broadcasts = ir::CollectIRNodes(store.As<ir::Store>()->value, IsBroadcastLoad);
+    ASSERT_TRUE(broadcasts.empty()) << store;
+  }
+
+  auto forloops = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::For>(); });
+  for (auto& forloop : forloops) {
+    if (forloop.As<ir::For>()->loop_var->name == "i") continue;
+    ASSERT_TRUE(ir::CollectIRNodes(forloop, [](const Expr* x) { return x->As<ir::Let>(); }).empty()) << forloop;
+  }
+}
+
+TEST(EliminateBroadcastInForloop, keep_written_operand) {
+  Placeholder<float> A("A", std::vector<int>{{32, 64}});
+  Placeholder<float> B("B", std::vector<int>{{32}});
+
+  Var i("i");
+  Var j("j");
+
+  // A[i, 16 * j : 16 * j + 16] += B[i]; B[i] += 1, the splat of B[i] must stay in the loop over j
+  auto row    = ir::Broadcast::Make(Expr(i), 16);
+  auto col    = ir::Ramp::Make(Expr(j) * 16, Expr(1), 16);
+  auto splat  = ir::Broadcast::Make(ir::Load::Make(ir::Tensor(B), {Expr(i)}), 16);
+  auto store  = ir::Store::Make(ir::Tensor(A), ir::Load::Make(ir::Tensor(A), {row, col}) + splat, {row, col});
+  auto update = ir::Store::Make(ir::Tensor(B), ir::Load::Make(ir::Tensor(B), {Expr(i)}) + 1.f, {Expr(i)});
+
+  Expr body = ir::For::Make(j,
+                            common::make_const(0),
+                            common::make_const(4),
+                            ir::ForType::Serial,
+                            ir::DeviceAPI::Host,
+                            ir::Block::Make({store, update}));
+  body      = ir::For::Make(i,
+                       common::make_const(0),
+                       common::make_const(32),
+                       ir::ForType::Serial,
+                       ir::DeviceAPI::Host,
+                       ir::Block::Make({body}));
+
+  EliminateBroadcastInForloop(&body);
+  LOG(INFO) << "body:\n" << body;
+
+  ASSERT_TRUE(ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::Let>(); }).empty());
+  ASSERT_EQ(ir::CollectIRNodes(body, IsBroadcastLoad).size(), 1UL);
+}
+
+}  // namespace optim
+}  // namespace cinn
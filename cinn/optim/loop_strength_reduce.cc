@@ -0,0 +1,207 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_strength_reduce.h"
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+namespace cinn::optim {
+
+namespace {
+
+//! The digits of a loop variable v between the places div and mod, that is `(v % mod) / div`.
+struct IndexField {
+  int64_t div;
+  int64_t mod;
+};
+
+//! Match \p expr to a field of the loop variable \p var_name ranging in [0, extent).
+bool MatchIndexField(const Expr& expr, const std::string& var_name, int64_t extent, IndexField* field) {
+  if (expr.As<ir::_Var_>()) {
+    if (expr.As<ir::_Var_>()->name != var_name) return false;
+    *field = IndexField{1, extent};
+    return true;
+  }
+
+  auto* div = expr.As<ir::Div>();
+  auto* mod = expr.As<ir::Mod>();
+  if (!div && !mod) return false;
+  Expr a = div ? div->a() : mod->a();
+  Expr b = div ? div->b() : mod->b();
+  if (!b.As<ir::IntImm>() || b.As<ir::IntImm>()->value <= 0) return false;
+
+  IndexField operand;
+  if (!MatchIndexField(a, var_name, extent, &operand)) return false;
+  int64_t place = operand.div * b.As<ir::IntImm>()->value;
+  if (div) {
+    // (v % m) / d / c = (v % m) / (d * c)
+    if (operand.mod % place != 0) return false;
+    *field = IndexField{place, operand.mod};
+  } else if (operand.mod % place == 0) {
+    // (v % m) / d % c = (v % (d * c)) / d
+    *field = IndexField{operand.div, place};
+  } else if (operand.mod <= place) {
+    // (v % m) / d is less than c already
+    *field = operand;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+//! Replace the fields of a loop variable with the results of \p rewrite, from the outermost ones.
+struct IndexFieldMutator : public ir::IRMutator<> {
+  using rewrite_t = std::function<Expr(const IndexField&, const Expr&)>;
+
+  IndexFieldMutator(const std::string& var_name, int64_t extent, rewrite_t rewrite)
+      : var_name_(var_name), extent_(extent), rewrite_(rewrite) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::_Var_* op, Expr* expr) override { Rewrite(expr); }
+
+  void Visit(const ir::Div* op, Expr* expr) override {
+    if (!Rewrite(expr)) ir::IRMutator<>::Visit(op, expr);
+  }
+
+  void Visit(const ir::Mod* op, Expr* expr) override {
+    if (!Rewrite(expr)) ir::IRMutator<>::Visit(op, expr);
+  }
+
+ private:
+  bool Rewrite(Expr* expr) {
+    IndexField field;
+    if (!MatchIndexField(*expr, var_name_, extent_, &field)) return false;
+    *expr = rewrite_(field, *expr);
+    return true;
+  }
+
+  std::string var_name_;
+  int64_t extent_;
+  rewrite_t rewrite_;
+};
+
+struct LoopStrengthReduceMutator : public ir::IRMutator<> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    // reduce the inner loops first
+    ir::IRMutator<>::Visit(op, expr);
+
+    auto* node = expr->As<ir::For>();
+    if (!node->min.As<ir::IntImm>() || node->min.As<ir::IntImm>()->value != 0) return;
+    if (!node->extent.As<ir::IntImm>()) return;
+    int64_t extent = node->extent.As<ir::IntImm>()->value;
+
+    if (node->is_serial() && SplitForloop(expr, extent)) return;
+    if (node->is_serial() || node->is_parallel()) HoistIndexFields(expr, extent);
+  }
+
+ private:
+  //! Split a serial forloop to the loops over the digits between the places of the fields of its variable.
+  bool SplitForloop(Expr* expr, int64_t extent) {
+    auto* node           = expr->As<ir::For>();
+    std::string var_name = node->loop_var->name;
+
+    std::set<int64_t> places{1, extent};
+    Expr body = optim::IRCopy(node->body);
+    IndexFieldMutator collector(var_name, extent, [&](const IndexField& field, const Expr& e) {
+      places.insert(field.div);
+      places.insert(field.mod);
+      return e;
+    });
+    collector(&body);
+    if (places.size() <= 2) return false;
+
+    // each place should divide the higher one
+    std::vector<int64_t> bounds(places.begin(), places.end());
+    for (int i = 1; i < bounds.size(); i++) {
+      if (bounds[i] % bounds[i - 1] != 0) return false;
+    }
+
+    auto type = node->loop_var->type();
+    std::vector<Var> digits;
+    for (int i = 0; i + 1 < bounds.size(); i++) {
+      digits.emplace_back(common::UniqName(var_name + "_"), type);
+    }
+    IndexFieldMutator rewriter(var_name, extent, [&](const IndexField& field, const Expr& e) {
+      Expr res;
+      for (int i = 0; i < digits.size(); i++) {
+        if (bounds[i] < field.div || bounds[i] >= field.mod) continue;
+        Expr term = Expr(digits[i]);
+        if (bounds[i] != field.div) term = ir::Mul::Make(term, common::make_const(type, bounds[i] / field.div));
+        res = res.defined() ? ir::Add::Make(res, term) : term;
+      }
+      return res.defined() ? res : common::make_const(type, 0);
+    });
+    rewriter(&body);
+
+    for (int i = 0; i < digits.size(); i++) {
+      if (i > 0) body = ir::Block::Make({body});
+      body = ir::For::Make(digits[i],
+                           common::make_const(type, 0),
+                           common::make_const(type, bounds[i + 1] / bounds[i]),
+                           ir::ForType::Serial,
+                           node->device_api,
+                           body);
+    }
+    VLOG(3) << "split forloop " << var_name << " by the places " << utils::Join(bounds, ", ");
+    *expr = body;
+    return true;
+  }
+
+  //! Compute the fields of the variable of a forloop with inner loops once at the beginning of its body.
+  void HoistIndexFields(Expr* expr, int64_t extent) {
+    auto* node = expr->As<ir::For>();
+    if (ir::CollectIRNodes(node->body, [](const Expr* x) { return x->As<ir::For>(); }).empty()) return;
+
+    std::string var_name = node->loop_var->name;
+    std::vector<Expr> lets;
+    std::map<std::string, Var> hoisted;
+    IndexFieldMutator rewriter(var_name, extent, [&](const IndexField& field, const Expr& e) -> Expr {
+      if (e.As<ir::_Var_>()) return e;
+      auto key = utils::GetStreamCnt(e);
+      if (!hoisted.count(key)) {
+        Var tmp(common::UniqName(var_name + "_idx"), e.type());
+        lets.push_back(ir::Let::Make(tmp, e));
+        hoisted.emplace(key, tmp);
+      }
+      return Expr(hoisted.at(key));
+    });
+    rewriter(&node->body);
+    if (lets.empty()) return;
+
+    VLOG(3) << "hoist " << lets.size() << " index fields of forloop " << var_name;
+    lets.push_back(node->body);
+    node->body = ir::Block::Make(lets);
+  }
+};
+
+}  // namespace
+
+void LoopStrengthReduce(Expr* e) { LoopStrengthReduceMutator()(e); }
+
+}  // namespace cinn::optim
@@ -0,0 +1,40 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+/** Remove the div/mod of the loop variables from the loop bodies.
+ *
+ * A fused loop accesses the original dims by the div/mod of its variable, a serial loop is split to the nested loops
+ * over the digits of the variable instead, for example
+ * \code
+ * for (i_j_fused, 0, 12)
+ *   B[i_j_fused / 3, i_j_fused % 3] = A[i_j_fused % 3]
+ * \endcode
+ * is turned to
+ * \code
+ * for (i_j_fused_1, 0, 4)
+ *   for (i_j_fused_0, 0, 3)
+ *     B[i_j_fused_1, i_j_fused_0] = A[i_j_fused_0]
+ * \endcode
+ *
+ * A parallel loop, or a loop whose divisors do not divide each other, keeps its variable and computes each div/mod
+ * once at the beginning of its body instead of in every iteration of its inner loops.
+ */
+namespace cinn::optim {
+
+void LoopStrengthReduce(Expr* e);
+
+}  // namespace cinn::optim
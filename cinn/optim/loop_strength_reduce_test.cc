@@ -0,0 +1,97 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_strength_reduce.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace optim {
+
+std::vector<int> GetForloopExtents(Expr expr) {
+  std::vector<int> extents;
+  auto* node = expr.As<ir::For>();
+  while (node) {
+    extents.push_back(node->extent.as_int32());
+    auto* block = node->body.As<ir::Block>();
+    expr        = block && block->stmts.size() == 1 ? block->stmts[0] : node->body;
+    node        = expr.As<ir::For>();
+  }
+  return extents;
+}
+
+int CountDivMod(Expr expr) {
+  return ir::CollectIRNodes(expr, [](const Expr* x) { return x->As<ir::Div>() || x->As<ir::Mod>(); }).size();
+}
+
+TEST(LoopStrengthReduce, split_fused_loop) {
+  Placeholder<float> A("A", std::vector<int>{{2, 3, 4}});
+  Placeholder<float> B("B", std::vector<int>{{4}});
+
+  auto C      = Compute({Expr(2), Expr(3), Expr(4)}, [&](Var i, Var j, Var k) { return A(i, j, k) + B(k); }, "C");
+  auto stages = CreateStages({C});
+  stages[C]->Fuse({0, 1, 2});
+
+  auto func = Lower("add_fused", stages, {A, B, C});
+  Expr body = func->body;
+  LOG(INFO) << "before:\n" << body;
+  ASSERT_GT(CountDivMod(body), 0);
+
+  LoopStrengthReduce(&body);
+  LOG(INFO) << "after:\n" << body;
+  ASSERT_EQ(CountDivMod(body), 0);
+
+  auto forloops = ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::For>(); });
+  ASSERT_EQ(forloops.size(), 3UL);
+}
+
+TEST(LoopStrengthReduce, hoist_parallel_loop) {
+  Placeholder<float> A("A", std::vector<int>{{12, 16}});
+  Placeholder<float> B("B", std::vector<int>{{3}});
+
+  Var i("i");
+  Var j("j");
+
+  // A[i, j] = A[i, j] + B[i % 3] in a parallel loop over i, i % 3 is computed once for the loop over j
+  auto inner = ir::For::Make(j,
+                             common::make_const(0),
+                             common::make_const(16),
+                             ir::ForType::Serial,
+                             ir::DeviceAPI::Host,
+                             ir::Block::Make({ir::Store::Make(ir::Tensor(A),
+                                                              ir::Load::Make(ir::Tensor(A), {Expr(i), Expr(j)}) +
+                                                                  ir::Load::Make(ir::Tensor(B), {Expr(i) % 3}),
+                                                              {Expr(i), Expr(j)})}));
+  Expr body  = ir::For::Make(i,
+                            common::make_const(0),
+                            common::make_const(12),
+                            ir::ForType::Parallel,
+                            ir::DeviceAPI::Host,
+                            ir::Block::Make({inner}));
+
+  LoopStrengthReduce(&body);
+  LOG(INFO) << "after:\n" << body;
+
+  ASSERT_EQ(GetForloopExtents(body), std::vector<int>({12}));
+  auto lets = ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::Let>(); });
+  ASSERT_EQ(lets.size(), 1UL);
+  ASSERT_EQ(CountDivMod(body), 1);
+  ASSERT_TRUE(ir::CollectIRNodes(inner, [](const Expr* x) { return x->As<ir::Mod>(); }).empty());
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -53,6 +53,9 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
   RemoveGpuForloopsAxis(&copied);
   CudaSyncThreadsDropIfThenElse(&copied);
 #endif
+  if (target.arch == Target::Arch::X86) {
+    EliminateBroadcastInForloop(&copied);
+  }
 
   RemoveNestedBlock(&copied);
 
@@ -429,7 +429,29 @@ void BindFrontend(pybind11::module *m) {
            py::arg("groups")            = 1,
            py::arg("data_format")       = "NCHW",
            py::arg("padding_algorithm") = "EXPLICIT")
-      .def("sum", &NetBuilder::sum, py::arg("inputs"));
+      .def("sum", &NetBuilder::sum, py::arg("inputs"))
+      .def("concat", &NetBuilder::concat, py::arg("inputs"), py::arg("axis") = 0)
+      .def("sgd", &NetBuilder::sgd, py::arg("param"), py::arg("grad"), py::arg("learning_rate"))
+      .def("momentum",
+           &NetBuilder::momentum,
+           py::arg("param"),
+           py::arg("grad"),
+           py::arg("velocity"),
+           py::arg("learning_rate"),
+           py::arg("mu")           = 0.9f,
+           py::arg("use_nesterov") = false)
+      .def("adam",
+           &NetBuilder::adam,
+           py::arg("param"),
+           py::arg("grad"),
+           py::arg("learning_rate"),
+           py::arg("moment1"),
+           py::arg("moment2"),
+           py::arg("beta1_pow"),
+           py::arg("beta2_pow"),
+           py::arg("beta1")   = 0.9f,
+           py::arg("beta2")   = 0.999f,
+           py::arg("epsilon") = 1e-8f);
 
   py::class_<CinnBuilder, BaseBuilder>(*m, "CinnBuilder")
       .def(py::init<const std::string &>(), py::arg("name") = "")
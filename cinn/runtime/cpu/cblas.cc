@@ -100,6 +100,51 @@ void cinn_cpu_mkl_gemm_batch_fp32(float alpha,
                     &batch_size);
 }
 
+int cinn_cpu_mkl_gemm_packed_b_size_fp32(int M, int N, int K) {
+  size_t bytes = cblas_sgemm_pack_get_size(CblasBMatrix, M, N, K);
+  return (bytes + sizeof(float) - 1) / sizeof(float);
+}
+
+void cinn_cpu_mkl_gemm_pack_b_fp32(
+    float alpha, int M, int N, int K, bool tb, int ldb, cinn_buffer_t* B, cinn_buffer_t* packed_B) {
+  cblas_sgemm_pack(CblasRowMajor,
+                   CblasBMatrix,
+                   ToCblasTranspose(tb),
+                   M,
+                   N,
+                   K,
+                   alpha,
+                   reinterpret_cast<float*>(B->memory),
+                   ldb,
+                   reinterpret_cast<float*>(packed_B->memory));
+}
+
+void cinn_cpu_mkl_gemm_compute_fp32(int M,
+                                    int N,
+                                    int K,
+                                    bool ta,
+                                    int lda,
+                                    int ldc,
+                                    float beta,
+                                    cinn_buffer_t* A,
+                                    cinn_buffer_t* packed_B,
+                                    cinn_buffer_t* C) {
+  // ldb is ignored for the packed B
+  cblas_sgemm_compute(CblasRowMajor,
+                      ToCblasTranspose(ta),
+                      CblasPacked,
+                      M,
+                      N,
+                      K,
+                      reinterpret_cast<float*>(A->memory),
+                      lda,
+                      reinterpret_cast<float*>(packed_B->memory),
+                      N,
+                      beta,
+                      reinterpret_cast<float*>(C->memory),
+                      ldc);
+}
+
 CINN_REGISTER_HELPER(cinn_cpu_mkl) {
   using namespace cinn;  // NOLINT
   using backends::FunctionProto;
@@ -143,6 +188,23 @@ CINN_REGISTER_HELPER(cinn_cpu_mkl) {
     return shape;
   };
 
+  FunctionProto::shape_inference_t inference_shape_gemm_pack_b = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 7UL) << "Wrong number of arguments passed in";
+    int M = common::AutoSimplify(args[1]).as_int32();
+    int N = common::AutoSimplify(args[2]).as_int32();
+    int K = common::AutoSimplify(args[3]).as_int32();
+    return std::vector<Expr>({Expr(cinn_cpu_mkl_gemm_packed_b_size_fp32(M, N, K))});
+  };
+
+  FunctionProto::shape_inference_t inference_shape_gemm_compute = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 9UL) << "Wrong number of arguments passed in";
+    auto M = common::AutoSimplify(args[0]);
+    auto N = common::AutoSimplify(args[1]);
+    return std::vector<Expr>({M, N});
+  };
+
   REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_fp32, host_target)
       .SetRetType<void>()
       .AddInputType<float>()            // alpha
@@ -183,5 +245,33 @@ CINN_REGISTER_HELPER(cinn_cpu_mkl) {
       .SetShapeInference(inference_shape_gemm_batch)
       .End();
 
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_pack_b_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // ldb
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // packed_B
+      .SetShapeInference(inference_shape_gemm_pack_b)
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_compute_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldc
+      .AddInputType<float>()            // beta
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // packed_B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm_compute)
+      .End();
+
   return true;
 }
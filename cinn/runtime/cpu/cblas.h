@@ -96,4 +96,48 @@ void cinn_cpu_mkl_gemm_batch_fp32(float alpha,
                                   cinn_buffer_t* A,
                                   cinn_buffer_t* B,
                                   cinn_buffer_t* C);
+
+/**
+ * \brief The number of floats to hold the matrix B of a GEMM packed by cinn_cpu_mkl_gemm_pack_b_fp32.
+ */
+int cinn_cpu_mkl_gemm_packed_b_size_fp32(int M, int N, int K);
+
+/**
+ * \brief Pack the matrix B of a GEMM into the internal layout of MKL, the product of A and B is then computed by
+ * cinn_cpu_mkl_gemm_compute_fp32 without packing B in each call. It is used to pack the constant weights once.
+ * @param alpha The scaling factor of the product of A and B, which is multiplied into the packed B
+ * @param M Number of the rows of A
+ * @param N the number of the columns in both B and C
+ * @param K the number of columns of A
+ * @param tb whether to transpose B
+ * @param ldb The size of the first dimension of B
+ * @param B The matrix B
+ * @param packed_B The packed matrix B, of cinn_cpu_mkl_gemm_packed_b_size_fp32(M, N, K) floats
+ */
+void cinn_cpu_mkl_gemm_pack_b_fp32(
+    float alpha, int M, int N, int K, bool tb, int ldb, cinn_buffer_t* B, cinn_buffer_t* packed_B);
+
+/**
+ * \brief Do GEMM on buffer A and the packed B and write result to buffer C.
+ * @param M Number of the rows of A
+ * @param N the number of the columns in both B and C
+ * @param K the number of columns of A
+ * @param ta whether to transpose A
+ * @param lda The size of the first dimension of A
+ * @param ldc The size of the first dimension of C
+ * @param beta The scaling factor of C
+ * @param A The matrix A
+ * @param packed_B The matrix B packed by cinn_cpu_mkl_gemm_pack_b_fp32 with the same M, N and K
+ * @param C The output matrix
+ */
+void cinn_cpu_mkl_gemm_compute_fp32(int M,
+                                    int N,
+                                    int K,
+                                    bool ta,
+                                    int lda,
+                                    int ldc,
+                                    float beta,
+                                    cinn_buffer_t* A,
+                                    cinn_buffer_t* packed_B,
+                                    cinn_buffer_t* C);
 }  // extern "C"
@@ -17,8 +17,19 @@
 #include <glog/logging.h>
 #include <math.h>
 
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/function_prototype.h"
+#include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/thread_backend.h"
 
 #ifdef CINN_WITH_MKL_CBLAS
 #include "cinn/runtime/cpu/mkl_math.h"
@@ -37,6 +48,329 @@ void __cinn_host_tanh_v(const cinn_buffer_t* x, cinn_buffer_t* out) {
 }
 }
 
+namespace {
+
+// the number of elements of a contiguous row whose max is taken before accumulating their exps
+constexpr int kSoftmaxChunk = 256;
+// the number of inner positions reduced together when the softmax axis is not the innermost one
+constexpr int kSoftmaxInnerBlock = 256;
+// the number of rows along the strided softmax axis whose max is taken before accumulating their exps
+constexpr int kSoftmaxAxisBlock = 16;
+
+// exp(x) = 2^n * exp(r) with x = n * ln2 + r, exp(r) is the polynomial of cephes' expf
+constexpr float kExpMax   = 88.3762626647949f;
+constexpr float kExpMin   = -88.3762626647949f;
+constexpr float kLog2e    = 1.44269504088896341f;
+constexpr float kExpLn2Hi = 0.693359375f;
+constexpr float kExpLn2Lo = -2.12194440e-4f;
+constexpr float kExpP0    = 1.9875691500E-4f;
+constexpr float kExpP1    = 1.3981999507E-3f;
+constexpr float kExpP2    = 8.3334519073E-3f;
+constexpr float kExpP3    = 4.1665795894E-2f;
+constexpr float kExpP4    = 1.6666665459E-1f;
+constexpr float kExpP5    = 5.0000001201E-1f;
+
+inline float ExpScalar(float x) {
+  x       = std::min(std::max(x, kExpMin), kExpMax);
+  float n = floorf(x * kLog2e + 0.5f);
+  float r = x - n * kExpLn2Hi - n * kExpLn2Lo;
+  float p = kExpP0;
+  p       = p * r + kExpP1;
+  p       = p * r + kExpP2;
+  p       = p * r + kExpP3;
+  p       = p * r + kExpP4;
+  p       = p * r + kExpP5;
+  p       = p * r * r + r + 1.f;
+  return ldexpf(p, static_cast<int>(n));
+}
+
+#ifdef __AVX__
+inline __m256 Exp8(__m256 x) {
+  x        = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(kExpMin)), _mm256_set1_ps(kExpMax));
+  __m256 n = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(kLog2e)), _mm256_set1_ps(0.5f)));
+  __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(kExpLn2Hi)));
+  r        = _mm256_sub_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(kExpLn2Lo)));
+  __m256 p = _mm256_set1_ps(kExpP0);
+  p        = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP1));
+  p        = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP2));
+  p        = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP3));
+  p        = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP4));
+  p        = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(kExpP5));
+  p        = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, r), r), r), _mm256_set1_ps(1.f));
+
+  // 2^n is built from the exponent bits, on the 128-bit halves as AVX has no 256-bit integer ops
+  __m256i ni = _mm256_cvtps_epi32(n);
+  __m128i lo = _mm_slli_epi32(_mm_add_epi32(_mm256_castsi256_si128(ni), _mm_set1_epi32(127)), 23);
+  __m128i hi = _mm_slli_epi32(_mm_add_epi32(_mm256_extractf128_si256(ni, 1), _mm_set1_epi32(127)), 23);
+  return _mm256_mul_ps(p, _mm256_castsi256_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1)));
+}
+#endif
+
+// v[j] = exp(v[j]) for j in [0, len), returns the sum of them
+inline float ExpInplace(float* v, int len) {
+  int j     = 0;
+  float sum = 0.f;
+#ifdef __AVX__
+  __m256 acc = _mm256_setzero_ps();
+  for (; j + 8 <= len; j += 8) {
+    __m256 e = Exp8(_mm256_loadu_ps(v + j));
+    _mm256_storeu_ps(v + j, e);
+    acc = _mm256_add_ps(acc, e);
+  }
+  float lanes[8];
+  _mm256_storeu_ps(lanes, acc);
+  for (int l = 0; l < 8; l++) sum += lanes[l];
+#endif
+  for (; j < len; j++) {
+    v[j] = ExpScalar(v[j]);
+    sum += v[j];
+  }
+  return sum;
+}
+
+// softmax of a contiguous row, the running max is updated once per chunk so that each element takes one exp
+void SoftmaxRow(const float* x, float* out, int n, float scale, bool use_log) {
+  float m = -FLT_MAX;
+  float s = 0.f;
+  float shifted[kSoftmaxChunk];
+  for (int begin = 0; begin < n; begin += kSoftmaxChunk) {
+    int len            = std::min(kSoftmaxChunk, n - begin);
+    const float* chunk = x + begin;
+    float chunk_m      = m;
+    for (int j = 0; j < len; j++) {
+      chunk_m = std::max(chunk_m, chunk[j] * scale);
+    }
+    // the running sum is rescaled once per chunk instead of once per element
+    s = s * ExpScalar(m - chunk_m);
+    m = chunk_m;
+    for (int j = 0; j < len; j++) {
+      shifted[j] = chunk[j] * scale - m;
+    }
+    s += ExpInplace(shifted, len);
+  }
+
+  for (int j = 0; j < n; j++) {
+    out[j] = x[j] * scale - m;
+  }
+  if (use_log) {
+    float log_s = logf(s);
+    for (int j = 0; j < n; j++) {
+      out[j] -= log_s;
+    }
+  } else {
+    float inv_s = 1.f / s;
+    ExpInplace(out, n);
+    for (int j = 0; j < n; j++) {
+      out[j] *= inv_s;
+    }
+  }
+}
+
+// softmax along the strided axis of x[axis_size][inner], for the inner positions in [begin, end), the running max
+// of each position is updated once per block of rows
+void SoftmaxStrided(
+    const float* x, float* out, int axis_size, int inner, int begin, int end, float scale, bool use_log) {
+  float m[kSoftmaxInnerBlock];
+  float s[kSoftmaxInnerBlock];
+  float shifted[kSoftmaxInnerBlock];
+  int len = end - begin;
+  std::fill(m, m + len, -FLT_MAX);
+  std::fill(s, s + len, 0.f);
+  for (int k0 = 0; k0 < axis_size; k0 += kSoftmaxAxisBlock) {
+    int k1 = std::min(k0 + kSoftmaxAxisBlock, axis_size);
+    float block_m[kSoftmaxInnerBlock];
+    std::copy(m, m + len, block_m);
+    for (int k = k0; k < k1; k++) {
+      const float* row = x + k * inner + begin;
+      for (int j = 0; j < len; j++) {
+        block_m[j] = std::max(block_m[j], row[j] * scale);
+      }
+    }
+    for (int j = 0; j < len; j++) {
+      shifted[j] = m[j] - block_m[j];
+    }
+    ExpInplace(shifted, len);
+    for (int j = 0; j < len; j++) {
+      s[j] = s[j] * shifted[j];
+      m[j] = block_m[j];
+    }
+    for (int k = k0; k < k1; k++) {
+      const float* row = x + k * inner + begin;
+      for (int j = 0; j < len; j++) {
+        shifted[j] = row[j] * scale - m[j];
+      }
+      ExpInplace(shifted, len);
+      for (int j = 0; j < len; j++) {
+        s[j] += shifted[j];
+      }
+    }
+  }
+
+  // s holds log(s) for log softmax and 1 / s for softmax
+  for (int j = 0; j < len; j++) {
+    s[j] = use_log ? logf(s[j]) : 1.f / s[j];
+  }
+  for (int k = 0; k < axis_size; k++) {
+    const float* row = x + k * inner + begin;
+    float* out_row   = out + k * inner + begin;
+    for (int j = 0; j < len; j++) {
+      out_row[j] = row[j] * scale - m[j];
+    }
+    if (use_log) {
+      for (int j = 0; j < len; j++) {
+        out_row[j] -= s[j];
+      }
+    } else {
+      ExpInplace(out_row, len);
+      for (int j = 0; j < len; j++) {
+        out_row[j] *= s[j];
+      }
+    }
+  }
+}
+
+// the number of independent Welford states kept for a contiguous NCHW row, so that the update vectorizes
+constexpr int kWelfordLanes = 8;
+
+// The running statistics of Welford's algorithm: the count, the mean and the sum of squared deviations.
+struct WelfordState {
+  int64_t count{0};
+  float mean{0.f};
+  float m2{0.f};
+};
+
+// Merges the state other into state by Chan's parallel formula.
+inline void WelfordMerge(const WelfordState& other, WelfordState* state) {
+  int64_t count = state->count + other.count;
+  if (other.count == 0) {
+    return;
+  }
+  float delta = other.mean - state->mean;
+  float ratio = static_cast<float>(other.count) / count;
+  state->mean += delta * ratio;
+  state->m2 += other.m2 + delta * delta * state->count * ratio;
+  state->count = count;
+}
+
+// Accumulates the contiguous segment x[len][width] into the states of the width channels, which share one count.
+void WelfordSegment(const float* x, int len, int width, int64_t* count, float* mean, float* m2) {
+  for (int s = 0; s < len; s++) {
+    *count += 1;
+    float inv_count  = 1.f / *count;
+    const float* row = x + s * width;
+    for (int j = 0; j < width; j++) {
+      float delta = row[j] - mean[j];
+      mean[j] += delta * inv_count;
+      m2[j] += delta * (row[j] - mean[j]);
+    }
+  }
+}
+
+// The statistics of the channel block b over the batches in [begin, end), written to states[c_block].
+void WelfordChannelBlock(const float* x,
+                         int num_blocks,
+                         int spatial,
+                         int c_block,
+                         int b,
+                         int begin,
+                         int end,
+                         WelfordState* states) {
+  if (c_block == 1) {
+    // the row of a NCHW channel is split into lanes, the tail shorter than the lanes is kept in its own state
+    int64_t count = 0;
+    float mean[kWelfordLanes];
+    float m2[kWelfordLanes];
+    std::fill(mean, mean + kWelfordLanes, 0.f);
+    std::fill(m2, m2 + kWelfordLanes, 0.f);
+    int64_t tail_count = 0;
+    float tail_mean    = 0.f;
+    float tail_m2      = 0.f;
+    int body           = spatial / kWelfordLanes;
+    for (int i = begin; i < end; i++) {
+      const float* row = x + static_cast<int64_t>(i * num_blocks + b) * spatial;
+      WelfordSegment(row, body, kWelfordLanes, &count, mean, m2);
+      WelfordSegment(row + body * kWelfordLanes, spatial - body * kWelfordLanes, 1, &tail_count, &tail_mean, &tail_m2);
+    }
+    WelfordState state{tail_count, tail_mean, tail_m2};
+    for (int l = 0; l < kWelfordLanes; l++) {
+      WelfordMerge(WelfordState{count, mean[l], m2[l]}, &state);
+    }
+    states[0] = state;
+  } else {
+    int64_t count = 0;
+    std::vector<float> mean(c_block, 0.f);
+    std::vector<float> m2(c_block, 0.f);
+    for (int i = begin; i < end; i++) {
+      const float* segment = x + static_cast<int64_t>(i * num_blocks + b) * spatial * c_block;
+      WelfordSegment(segment, spatial, c_block, &count, mean.data(), m2.data());
+    }
+    for (int j = 0; j < c_block; j++) {
+      states[j] = WelfordState{count, mean[j], m2[j]};
+    }
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+void cinn_cpu_softmax_fp32(
+    int outer, int axis_size, int inner, float scale, bool use_log, const cinn_buffer_t* x, cinn_buffer_t* out) {
+  CINN_CHECK_EQ(x->num_elements(), out->num_elements());
+  CINN_CHECK_EQ(x->num_elements(), outer * axis_size * inner);
+  auto* x_data   = reinterpret_cast<const float*>(x->memory);
+  auto* out_data = reinterpret_cast<float*>(out->memory);
+  int row_size   = axis_size * inner;
+  if (inner == 1) {
+#pragma omp parallel for num_threads(max_concurrency())
+    for (int i = 0; i < outer; i++) {
+      SoftmaxRow(x_data + i * row_size, out_data + i * row_size, axis_size, scale, use_log);
+    }
+  } else {
+    int num_blocks = (inner + kSoftmaxInnerBlock - 1) / kSoftmaxInnerBlock;
+#pragma omp parallel for num_threads(max_concurrency())
+    for (int t = 0; t < outer * num_blocks; t++) {
+      int i     = t / num_blocks;
+      int begin = (t % num_blocks) * kSoftmaxInnerBlock;
+      int end   = std::min(begin + kSoftmaxInnerBlock, inner);
+      SoftmaxStrided(x_data + i * row_size, out_data + i * row_size, axis_size, inner, begin, end, scale, use_log);
+    }
+  }
+}
+
+void cinn_cpu_batch_norm_stats_fp32(
+    int n, int c, int spatial, int c_block, const cinn_buffer_t* x, cinn_buffer_t* mean, cinn_buffer_t* variance) {
+  CINN_CHECK_EQ(c % c_block, 0);
+  CINN_CHECK_EQ(x->num_elements(), n * c * spatial);
+  CINN_CHECK_EQ(mean->num_elements(), c);
+  CINN_CHECK_EQ(variance->num_elements(), c);
+  auto* x_data        = reinterpret_cast<const float*>(x->memory);
+  auto* mean_data     = reinterpret_cast<float*>(mean->memory);
+  auto* variance_data = reinterpret_cast<float*>(variance->memory);
+  int num_blocks      = c / c_block;
+  // the batches are split into chunks when there are fewer channel blocks than threads, e.g. for NHWC
+  int num_chunks = std::max(1, std::min(n, (max_concurrency() + num_blocks - 1) / num_blocks));
+  std::vector<WelfordState> partial(static_cast<size_t>(num_chunks) * c);
+#pragma omp parallel for num_threads(max_concurrency())
+  for (int t = 0; t < num_blocks * num_chunks; t++) {
+    int b                = t / num_chunks;
+    int chunk            = t % num_chunks;
+    int begin            = static_cast<int64_t>(n) * chunk / num_chunks;
+    int end              = static_cast<int64_t>(n) * (chunk + 1) / num_chunks;
+    WelfordState* states = partial.data() + static_cast<size_t>(chunk) * c + b * c_block;
+    WelfordChannelBlock(x_data, num_blocks, spatial, c_block, b, begin, end, states);
+  }
+  for (int j = 0; j < c; j++) {
+    WelfordState state;
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+      WelfordMerge(partial[static_cast<size_t>(chunk) * c + j], &state);
+    }
+    mean_data[j]     = state.mean;
+    variance_data[j] = state.count > 0 ? state.m2 / state.count : 0.f;
+  }
+}
+}
+
 CINN_REGISTER_HELPER(host_intrinsics) {
   auto host_target = cinn::common::DefaultHostTarget();
   using cinn::backends::FunctionProto;
@@ -54,5 +388,35 @@ CINN_REGISTER_HELPER(host_intrinsics) {
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(atanf);
   REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(atanhf);
 
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_softmax_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // outer
+      .AddInputType<int>()              // axis_size
+      .AddInputType<int>()              // inner
+      .AddInputType<float>()            // scale
+      .AddInputType<bool>()             // use_log
+      .AddInputType<cinn_buffer_t*>()   // x
+      .AddOutputType<cinn_buffer_t*>()  // out
+      .SetShapeInference(FunctionProto::ShapeFollowNthArgument(5))
+      .End();
+
+  // both the mean and the variance have the shape [c]
+  FunctionProto::shape_inference_t inference_shape_bn_stats = [](const std::vector<cinn::Expr>& args, int offset) {
+    CHECK_LT(offset, 2) << "The batch norm statistics have only two outputs";
+    return std::vector<cinn::Expr>{cinn::common::AutoSimplify(args[1])};
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_batch_norm_stats_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // n
+      .AddInputType<int>()              // c
+      .AddInputType<int>()              // spatial
+      .AddInputType<int>()              // c_block
+      .AddInputType<cinn_buffer_t*>()   // x
+      .AddOutputType<cinn_buffer_t*>()  // mean
+      .AddOutputType<cinn_buffer_t*>()  // variance
+      .SetShapeInference(inference_shape_bn_stats)
+      .End();
+
   return true;
 }
@@ -24,4 +24,20 @@ extern "C" {
 //@{
 void __cinn_host_tanh_v(const cinn_buffer_t* x, cinn_buffer_t* out);
 //@}
+
+/**
+ * Softmax (or log-softmax) of `x * scale` along an axis, where x is viewed as [outer, axis_size, inner].
+ * The max and the exp-sum of each row are computed in a single online pass, and the output is written once.
+ */
+void cinn_cpu_softmax_fp32(
+    int outer, int axis_size, int inner, float scale, bool use_log, const cinn_buffer_t* x, cinn_buffer_t* out);
+
+/**
+ * The per-channel mean and biased variance of x for the batch norm training, where x is viewed as
+ * [n, c / c_block, spatial, c_block]: c_block is 1 for NCHW, c for NHWC and the inner channel block for NCHWc.
+ * The statistics are accumulated by Welford's algorithm in a single parallel pass, so they are stable for the inputs
+ * whose mean is large compared to their deviation, unlike E(x^2) - E(x)^2.
+ */
+void cinn_cpu_batch_norm_stats_fp32(
+    int n, int c, int spatial, int c_block, const cinn_buffer_t* x, cinn_buffer_t* mean, cinn_buffer_t* variance);
 }
@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/llvm/execution_engine.h"
 #include "cinn/backends/llvm/simple_jit.h"
@@ -65,6 +68,155 @@ TEST(tanh, basic) {
   }
 }
 
+void TestSoftmax(int outer, int axis_size, int inner, float scale, bool use_log) {
+  Placeholder<float> x("x", {Expr(outer), Expr(axis_size), Expr(inner)});
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_softmax_fp32",
+                                {
+                                    Expr(outer),                 // outer
+                                    Expr(axis_size),             // axis_size
+                                    Expr(inner),                 // inner
+                                    Expr(scale),                 // scale
+                                    common::make_bool(use_log),  // use_log
+                                    x.tensor(),                  // x
+                                });
+      },
+      "cinn_cpu_softmax_fp32");
+  auto out = call->TupleGet(0);
+  out->WithBuffer(Float(32));
+
+  auto stages = CreateStages({call, out});
+  ir::Module::Builder builder("module_softmax", common::DefaultHostTarget());
+  auto fn = Lower("fn", stages, {x, out, call});
+  builder.AddFunction(fn);
+
+  auto jit = backends::SimpleJIT::Create();
+  jit->Link(builder.Build());
+  auto fnp = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn"));
+  ASSERT_TRUE(fnp);
+
+  auto* x_buf   = common::BufferBuilder(Float(32), {outer, axis_size, inner}).set_random().Build();
+  auto* out_buf = common::BufferBuilder(Float(32), {outer, axis_size, inner}).set_zero().Build();
+  auto args     = common::ArgsBuilder().Add(x_buf).Add(out_buf).Build();
+  fnp(args.data(), args.size());
+
+  auto* x_data   = reinterpret_cast<float*>(x_buf->memory);
+  auto* out_data = reinterpret_cast<float*>(out_buf->memory);
+  for (int i = 0; i < outer; i++) {
+    for (int j = 0; j < inner; j++) {
+      auto index = [&](int k) { return (i * axis_size + k) * inner + j; };
+      float max  = x_data[index(0)] * scale;
+      for (int k = 1; k < axis_size; k++) {
+        max = std::max(max, x_data[index(k)] * scale);
+      }
+      float sum = 0.f;
+      for (int k = 0; k < axis_size; k++) {
+        sum += std::exp(x_data[index(k)] * scale - max);
+      }
+      for (int k = 0; k < axis_size; k++) {
+        float expect = x_data[index(k)] * scale - max - std::log(sum);
+        ASSERT_NEAR(out_data[index(k)], use_log ? expect : std::exp(expect), 1e-5);
+      }
+    }
+  }
+  cinn_buffer_free(nullptr, x_buf);
+  cinn_buffer_free(nullptr, out_buf);
+}
+
+TEST(cinn_cpu_softmax_fp32, basic) {
+  // the innermost axis, with a tail shorter than the vector lanes
+  TestSoftmax(16, 1003, 1, 1.f, false);
+  TestSoftmax(16, 1003, 1, 0.125f, true);
+  // a strided axis, with a partial inner block
+  TestSoftmax(3, 17, 300, 2.f, false);
+  TestSoftmax(3, 17, 300, 1.f, true);
+}
+
+// x is [n, c / c_block, spatial, c_block], shifted by offset to check the stability of the variance
+void TestBatchNormStats(int n, int c, int spatial, int c_block, float offset) {
+  int num_blocks = c / c_block;
+  Placeholder<float> x("x", {Expr(n), Expr(num_blocks), Expr(spatial), Expr(c_block)});
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_batch_norm_stats_fp32",
+                                {
+                                    Expr(n),        // n
+                                    Expr(c),        // c
+                                    Expr(spatial),  // spatial
+                                    Expr(c_block),  // c_block
+                                    x.tensor(),     // x
+                                });
+      },
+      "cinn_cpu_batch_norm_stats_fp32");
+  auto mean     = call->TupleGet(0);
+  auto variance = call->TupleGet(1);
+  mean->WithBuffer(Float(32));
+  variance->WithBuffer(Float(32));
+
+  auto stages = CreateStages({call, mean, variance});
+  ir::Module::Builder builder("module_batch_norm_stats", common::DefaultHostTarget());
+  auto fn = Lower("fn", stages, {x, mean, variance, call});
+  builder.AddFunction(fn);
+
+  auto jit = backends::SimpleJIT::Create();
+  jit->Link(builder.Build());
+  auto fnp = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn"));
+  ASSERT_TRUE(fnp);
+
+  auto* x_buf        = common::BufferBuilder(Float(32), {n, num_blocks, spatial, c_block}).set_random().Build();
+  auto* mean_buf     = common::BufferBuilder(Float(32), {c}).set_zero().Build();
+  auto* variance_buf = common::BufferBuilder(Float(32), {c}).set_zero().Build();
+  auto* x_data       = reinterpret_cast<float*>(x_buf->memory);
+  for (int i = 0; i < x_buf->num_elements(); i++) {
+    x_data[i] += offset;
+  }
+  auto args = common::ArgsBuilder().Add(x_buf).Add(mean_buf).Add(variance_buf).Build();
+  fnp(args.data(), args.size());
+
+  auto* mean_data     = reinterpret_cast<float*>(mean_buf->memory);
+  auto* variance_data = reinterpret_cast<float*>(variance_buf->memory);
+  for (int j = 0; j < c; j++) {
+    auto value = [&](int i, int s) {
+      return static_cast<double>(x_data[((i * num_blocks + j / c_block) * spatial + s) * c_block + j % c_block]);
+    };
+    // the two-pass reference in double precision
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+      for (int s = 0; s < spatial; s++) {
+        sum += value(i, s);
+      }
+    }
+    double expect_mean = sum / (n * spatial);
+    double square_sum  = 0.0;
+    for (int i = 0; i < n; i++) {
+      for (int s = 0; s < spatial; s++) {
+        square_sum += (value(i, s) - expect_mean) * (value(i, s) - expect_mean);
+      }
+    }
+    double expect_variance = square_sum / (n * spatial);
+    ASSERT_NEAR(mean_data[j], expect_mean, 1e-5 * std::max(1.0, std::abs(expect_mean)));
+    ASSERT_NEAR(variance_data[j], expect_variance, 1e-3 * expect_variance);
+  }
+  cinn_buffer_free(nullptr, x_buf);
+  cinn_buffer_free(nullptr, mean_buf);
+  cinn_buffer_free(nullptr, variance_buf);
+}
+
+TEST(cinn_cpu_batch_norm_stats_fp32, basic) {
+  // NCHW, with a spatial tail shorter than the lanes
+  TestBatchNormStats(4, 32, 7 * 7, 1, 0.f);
+  // NHWC, whose only channel block is split by the batches
+  TestBatchNormStats(8, 16, 14 * 14, 16, 0.f);
+  // NCHWc
+  TestBatchNormStats(2, 64, 8 * 8, 16, 0.f);
+  // a large mean, for which E(x^2) - E(x)^2 in float loses all the digits of the variance
+  TestBatchNormStats(4, 32, 7 * 7, 1, 1000.f);
+  TestBatchNormStats(2, 64, 8 * 8, 16, 1000.f);
+}
+
 }  // namespace cpu
 }  // namespace runtime
 }  // namespace cinn
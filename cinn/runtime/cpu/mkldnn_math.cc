@@ -14,6 +14,9 @@
 
 #include "cinn/runtime/cpu/mkldnn_math.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "cinn/backends/extern_func_jit_register.h"
@@ -24,42 +27,228 @@ using mkldnn::memory;
 using tag = memory::format_tag;
 using dt  = memory::data_type;
 
+namespace {
+
+// Creating an engine and a primitive costs milliseconds while most of the convolutions run in microseconds, so the
+// engine is shared by the process and the primitives are created once for each shape and cached.
+mkldnn::engine& CpuEngine() {
+  static mkldnn::engine engine(mkldnn::engine::kind::cpu, 0);
+  return engine;
+}
+
+// A stream is bound to the thread using it.
+mkldnn::stream& CpuStream() {
+  thread_local mkldnn::stream stream(CpuEngine());
+  return stream;
+}
+
+struct SoftmaxPrimitive {
+  memory::desc src_md;
+  mkldnn::softmax_forward prim;
+};
+
+struct ConvPrimitive {
+  mkldnn::convolution_forward::primitive_desc prim_desc;
+  mkldnn::convolution_forward prim;
+  memory::desc user_src_md;
+  memory::desc user_weights_md;
+  memory::desc user_dst_md;
+};
+
+// The primitives keyed by the attributes they are created with. Only the primitives are cached, the constant weights
+// reordered to the blocked layout of a convolution live in the buffers written by
+// cinn_cpu_mkldnn_conv2d_reorder_weights_fp32, which are owned by the program running it.
+struct PrimitiveCache {
+  std::mutex mutex;
+  std::map<std::vector<int>, std::shared_ptr<SoftmaxPrimitive>> softmax;
+  std::map<std::vector<int>, std::shared_ptr<ConvPrimitive>> conv;
+
+  static PrimitiveCache& Global() {
+    static PrimitiveCache cache;
+    return cache;
+  }
+};
+
+std::shared_ptr<ConvPrimitive> GetConvPrimitive(int batch_size,
+                                                int c_in,
+                                                int input_h,
+                                                int input_w,
+                                                int c_out,
+                                                int group,
+                                                int filter_h,
+                                                int filter_w,
+                                                int pad_h,
+                                                int pad_w,
+                                                int stride_h,
+                                                int stride_w,
+                                                int dilation_h,
+                                                int dilation_w) {
+  std::vector<int> key = {batch_size, c_in, input_h, input_w, c_out, group, filter_h, filter_w, pad_h, pad_w, stride_h,
+                          stride_w, dilation_h, dilation_w};
+  auto& cache          = PrimitiveCache::Global();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto& cached = cache.conv[key];
+  if (!cached) {
+    memory::dims conv_src_tz     = {batch_size, c_in, input_h, input_w};
+    memory::dims conv_weights_tz = {c_out, c_in, filter_h, filter_w};
+    if (group > 1) {
+      conv_weights_tz = {group, c_out / group, c_in / group, filter_h, filter_w};
+    }
+    int out_h                   = (input_h - ((filter_h - 1) * dilation_h + 1) + 2 * pad_h) / stride_h + 1;
+    int out_w                   = (input_w - ((filter_w - 1) * dilation_w + 1) + 2 * pad_w) / stride_w + 1;
+    memory::dims conv_dst_tz    = {batch_size, c_out, out_h, out_w};
+    memory::dims conv_strides   = {stride_h, stride_w};
+    memory::dims conv_paddings  = {pad_h, pad_w};
+    memory::dims conv_dilations = {dilation_h - 1, dilation_w - 1};
+
+    auto conv_src_md     = memory::desc({conv_src_tz}, dt::f32, tag::any);
+    auto conv_weights_md = memory::desc({conv_weights_tz}, dt::f32, tag::any);
+    auto conv_dst_md     = memory::desc({conv_dst_tz}, dt::f32, tag::nchw);
+
+    auto conv_desc = mkldnn::convolution_forward::desc(mkldnn::prop_kind::forward_inference,
+                                                       mkldnn::algorithm::convolution_direct,
+                                                       conv_src_md,
+                                                       conv_weights_md,
+                                                       conv_dst_md,
+                                                       conv_strides,
+                                                       conv_dilations,
+                                                       conv_paddings,
+                                                       conv_paddings);
+
+    auto conv_prim_desc = mkldnn::convolution_forward::primitive_desc(conv_desc, CpuEngine());
+    cached.reset(new ConvPrimitive{conv_prim_desc,
+                                   mkldnn::convolution_forward(conv_prim_desc),
+                                   memory::desc({conv_src_tz}, dt::f32, tag::nchw),
+                                   memory::desc({conv_weights_tz}, dt::f32, group > 1 ? tag::goihw : tag::oihw),
+                                   memory::desc({conv_dst_tz}, dt::f32, tag::nchw)});
+  }
+  return cached;
+}
+
+}  // namespace
+
+void cinn_cpu_mkldnn_clear_cache() {
+  auto& cache = PrimitiveCache::Global();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.softmax.clear();
+  cache.conv.clear();
+}
+
 void cinn_cpu_mkldnn_softmax_fp32(
     int batch, int channel, int h, int w, int axis, cinn_buffer_t* inputs, cinn_buffer_t* out) {
-  auto engine = mkldnn::engine(mkldnn::engine::kind::cpu, 0);
-  mkldnn::stream engine_stream(engine);
-
-  memory::dims src_dims = {batch, channel};
-  if (h != 1) src_dims.push_back(h);
-  if (w != 1) src_dims.push_back(w);
-  int size        = src_dims.size();
-  auto format_tag = tag::nc;
-  switch (size) {
-    case 2:
-      format_tag = tag::ab;
-      break;
-    case 3:
-      format_tag = tag::abc;
-      break;
-    case 4:
-      format_tag = tag::abcd;
-      break;
-    default:
-      LOG(FATAL) << "wrong dim: " << size;
-      break;
-  }
+  std::vector<int> key = {batch, channel, h, w, axis};
+  auto& cache          = PrimitiveCache::Global();
+  std::shared_ptr<SoftmaxPrimitive> softmax;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto& cached = cache.softmax[key];
+    if (!cached) {
+      memory::dims src_dims = {batch, channel};
+      if (h != 1) src_dims.push_back(h);
+      if (w != 1) src_dims.push_back(w);
+      int size        = src_dims.size();
+      auto format_tag = tag::nc;
+      switch (size) {
+        case 2:
+          format_tag = tag::ab;
+          break;
+        case 3:
+          format_tag = tag::abc;
+          break;
+        case 4:
+          format_tag = tag::abcd;
+          break;
+        default:
+          LOG(FATAL) << "wrong dim: " << size;
+          break;
+      }
 
-  auto src_md       = memory::desc(src_dims, dt::f32, format_tag);
-  auto src_mem      = memory(src_md, engine, reinterpret_cast<float*>(inputs->memory));
-  auto dst_mem      = memory(src_md, engine, reinterpret_cast<float*>(out->memory));
-  auto softmax_d    = mkldnn::softmax_forward::desc(mkldnn::prop_kind::forward_inference, src_md, axis);
-  auto softmax_pd   = mkldnn::softmax_forward::primitive_desc(softmax_d, engine);
-  auto softmax_prim = mkldnn::softmax_forward(softmax_pd);
+      auto src_md     = memory::desc(src_dims, dt::f32, format_tag);
+      auto softmax_d  = mkldnn::softmax_forward::desc(mkldnn::prop_kind::forward_inference, src_md, axis);
+      auto softmax_pd = mkldnn::softmax_forward::primitive_desc(softmax_d, CpuEngine());
+      cached.reset(new SoftmaxPrimitive{src_md, mkldnn::softmax_forward(softmax_pd)});
+    }
+    softmax = cached;
+  }
 
-  softmax_prim.execute(engine_stream, {{DNNL_ARG_SRC, src_mem}, {DNNL_ARG_DST, dst_mem}});
+  auto& engine_stream = CpuStream();
+  auto src_mem        = memory(softmax->src_md, CpuEngine(), reinterpret_cast<float*>(inputs->memory));
+  auto dst_mem        = memory(softmax->src_md, CpuEngine(), reinterpret_cast<float*>(out->memory));
+  softmax->prim.execute(engine_stream, {{DNNL_ARG_SRC, src_mem}, {DNNL_ARG_DST, dst_mem}});
   engine_stream.wait();
 }
 
+int cinn_cpu_mkldnn_conv2d_reordered_weights_size_fp32(int batch_size,
+                                                        int c_in,
+                                                        int input_h,
+                                                        int input_w,
+                                                        int c_out,
+                                                        int group,
+                                                        int filter_h,
+                                                        int filter_w,
+                                                        int pad_h,
+                                                        int pad_w,
+                                                        int stride_h,
+                                                        int stride_w,
+                                                        int dilation_h,
+                                                        int dilation_w) {
+  auto conv = GetConvPrimitive(batch_size,
+                               c_in,
+                               input_h,
+                               input_w,
+                               c_out,
+                               group,
+                               filter_h,
+                               filter_w,
+                               pad_h,
+                               pad_w,
+                               stride_h,
+                               stride_w,
+                               dilation_h,
+                               dilation_w);
+  size_t bytes = conv->prim_desc.weights_desc().get_size();
+  return (bytes + sizeof(float) - 1) / sizeof(float);
+}
+
+void cinn_cpu_mkldnn_conv2d_reorder_weights_fp32(int batch_size,
+                                                 int c_in,
+                                                 int input_h,
+                                                 int input_w,
+                                                 int c_out,
+                                                 int group,
+                                                 int filter_h,
+                                                 int filter_w,
+                                                 int pad_h,
+                                                 int pad_w,
+                                                 int stride_h,
+                                                 int stride_w,
+                                                 int dilation_h,
+                                                 int dilation_w,
+                                                 cinn_buffer_t* weights,
+                                                 cinn_buffer_t* reordered_weights) {
+  auto conv = GetConvPrimitive(batch_size,
+                               c_in,
+                               input_h,
+                               input_w,
+                               c_out,
+                               group,
+                               filter_h,
+                               filter_w,
+                               pad_h,
+                               pad_w,
+                               stride_h,
+                               stride_w,
+                               dilation_h,
+                               dilation_w);
+  auto& cpu_engine              = CpuEngine();
+  auto& cpu_stream              = CpuStream();
+  auto conv_user_weights_memory = memory(conv->user_weights_md, cpu_engine, weights->memory);
+  auto conv_weights_memory      = memory(conv->prim_desc.weights_desc(), cpu_engine, reordered_weights->memory);
+  mkldnn::reorder(conv_user_weights_memory, conv_weights_memory)
+      .execute(cpu_stream, conv_user_weights_memory, conv_weights_memory);
+  cpu_stream.wait();
+}
+
 void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
                                       int c_in,
                                       int input_h,
@@ -74,63 +263,58 @@ void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
                                       int stride_w,
                                       int dilation_h,
                                       int dilation_w,
+                                      int reordered_weights,
                                       cinn_buffer_t* inputs,
                                       cinn_buffer_t* weights,
                                       cinn_buffer_t* out) {
-  auto cpu_engine = mkldnn::engine(mkldnn::engine::kind::cpu, 0);
-  mkldnn::stream cpu_stream(cpu_engine);
+  auto conv = GetConvPrimitive(batch_size,
+                               c_in,
+                               input_h,
+                               input_w,
+                               c_out,
+                               group,
+                               filter_h,
+                               filter_w,
+                               pad_h,
+                               pad_w,
+                               stride_h,
+                               stride_w,
+                               dilation_h,
+                               dilation_w);
+
+  auto& cpu_engine = CpuEngine();
+  auto& cpu_stream = CpuStream();
+  memory conv_weights_memory;
+  if (reordered_weights) {
+    // the weights are reordered to the layout of the primitive by cinn_cpu_mkldnn_conv2d_reorder_weights_fp32
+    conv_weights_memory = memory(conv->prim_desc.weights_desc(), cpu_engine, weights->memory);
+  } else {
+    auto conv_user_weights_memory = memory(conv->user_weights_md, cpu_engine, weights->memory);
+    conv_weights_memory           = conv_user_weights_memory;
+    if (conv->prim_desc.weights_desc() != conv->user_weights_md) {
+      conv_weights_memory = memory(conv->prim_desc.weights_desc(), cpu_engine);
+      mkldnn::reorder(conv_user_weights_memory, conv_weights_memory)
+          .execute(cpu_stream, conv_user_weights_memory, conv_weights_memory);
+    }
+  }
+  auto conv_user_src_memory = memory(conv->user_src_md, cpu_engine, inputs->memory);
+  auto conv_user_dst_memory = memory(conv->user_dst_md, cpu_engine, out->memory);
 
-  memory::dims conv_src_tz     = {batch_size, c_in, input_h, input_w};
-  memory::dims conv_weights_tz = {c_out, c_in, filter_h, filter_w};
-  if (group > 1) {
-    conv_weights_tz = {group, c_out / group, c_in / group, filter_h, filter_w};
+  auto conv_src_memory = conv_user_src_memory;
+  auto conv_dst_memory = conv_user_dst_memory;
+  if (conv->prim_desc.src_desc() != conv->user_src_md) {
+    conv_src_memory = memory(conv->prim_desc.src_desc(), cpu_engine);
+    mkldnn::reorder(conv_user_src_memory, conv_src_memory).execute(cpu_stream, conv_user_src_memory, conv_src_memory);
   }
-  int out_h                   = (input_h - ((filter_h - 1) * dilation_h + 1) + 2 * pad_h) / stride_h + 1;
-  int out_w                   = (input_w - ((filter_w - 1) * dilation_w + 1) + 2 * pad_w) / stride_w + 1;
-  memory::dims conv_dst_tz    = {batch_size, c_out, out_h, out_w};
-  memory::dims conv_strides   = {stride_h, stride_w};
-  memory::dims conv_paddings  = {pad_h, pad_w};
-  memory::dims conv_dilations = {dilation_h - 1, dilation_w - 1};
-
-  auto conv_user_src_memory =
-      memory({{conv_src_tz}, dt::f32, tag::nchw}, cpu_engine, reinterpret_cast<float*>(inputs->memory));
-  auto conv_user_weights_memory = memory({{conv_weights_tz}, dt::f32, group > 1 ? tag::goihw : tag::oihw},
-                                         cpu_engine,
-                                         reinterpret_cast<float*>(weights->memory));
-  auto conv_user_dst_memory =
-      memory({{conv_dst_tz}, dt::f32, tag::nchw}, cpu_engine, reinterpret_cast<float*>(out->memory));
-
-  auto conv_src_md     = memory::desc({conv_src_tz}, dt::f32, tag::any);
-  auto conv_weights_md = memory::desc({conv_weights_tz}, dt::f32, tag::any);
-  auto conv_dst_md     = memory::desc({conv_dst_tz}, dt::f32, tag::nchw);
-
-  auto conv_desc = mkldnn::convolution_forward::desc(mkldnn::prop_kind::forward_inference,
-                                                     mkldnn::algorithm::convolution_direct,
-                                                     conv_src_md,
-                                                     conv_weights_md,
-                                                     conv_dst_md,
-                                                     conv_strides,
-                                                     conv_dilations,
-                                                     conv_paddings,
-                                                     conv_paddings);
-
-  auto conv_prim_desc = mkldnn::convolution_forward::primitive_desc(conv_desc, cpu_engine);
-
-  auto conv_src_memory     = conv_user_src_memory;
-  auto conv_weights_memory = conv_user_weights_memory;
-  auto conv_dst_memory     = conv_user_dst_memory;
-  if (conv_prim_desc.dst_desc() != conv_user_dst_memory.get_desc()) {
-    conv_dst_memory = memory(conv_prim_desc.dst_desc(), cpu_engine);
+  if (conv->prim_desc.dst_desc() != conv->user_dst_md) {
+    conv_dst_memory = memory(conv->prim_desc.dst_desc(), cpu_engine);
   }
-  auto conv = mkldnn::convolution_forward(conv_prim_desc);
-  conv.execute(cpu_stream,
-               {{MKLDNN_ARG_SRC, conv_src_memory},
-                {MKLDNN_ARG_WEIGHTS, conv_weights_memory},
-                {MKLDNN_ARG_DST, conv_dst_memory}});
-  if (conv_prim_desc.dst_desc() != conv_user_dst_memory.get_desc()) {
+  conv->prim.execute(cpu_stream,
+                     {{MKLDNN_ARG_SRC, conv_src_memory},
+                      {MKLDNN_ARG_WEIGHTS, conv_weights_memory},
+                      {MKLDNN_ARG_DST, conv_dst_memory}});
+  if (conv->prim_desc.dst_desc() != conv->user_dst_md) {
     mkldnn::reorder(conv_dst_memory, conv_user_dst_memory).execute(cpu_stream, conv_dst_memory, conv_user_dst_memory);
-  } else {
-    conv_user_dst_memory = conv_dst_memory;
   }
 
   cpu_stream.wait();
@@ -142,7 +326,7 @@ CINN_REGISTER_HELPER(cinn_cpu_mkldnn) {
   auto host_target = common::DefaultHostTarget();
 
   FunctionProto::shape_inference_t inference_shape_conv2d_nchw = [](const std::vector<Expr>& args, int offset) {
-    CHECK_EQ(args.size(), 16UL) << "Wrong number of arguments passed in";
+    CHECK_EQ(args.size(), 17UL) << "Wrong number of arguments passed in";
     auto N         = common::AutoSimplify(args[0]);
     int input_h    = common::AutoSimplify(args[2]).as_int32();
     int input_w    = common::AutoSimplify(args[3]).as_int32();
@@ -182,12 +366,59 @@ CINN_REGISTER_HELPER(cinn_cpu_mkldnn) {
       .AddInputType<int>()              // stride_w
       .AddInputType<int>()              // dilation_h
       .AddInputType<int>()              // dilation_w
+      .AddInputType<int>()              // reordered_weights
       .AddInputType<cinn_buffer_t*>()   // inputs
       .AddInputType<cinn_buffer_t*>()   // weights
       .AddOutputType<cinn_buffer_t*>()  // out
       .SetShapeInference(inference_shape_conv2d_nchw)
       .End();
 
+  FunctionProto::shape_inference_t inference_shape_conv2d_reorder_weights = [](const std::vector<Expr>& args,
+                                                                               int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 15UL) << "Wrong number of arguments passed in";
+    std::vector<int> conv_args;
+    for (int i = 0; i < 14; i++) {
+      conv_args.push_back(common::AutoSimplify(args[i]).as_int32());
+    }
+    int size = cinn_cpu_mkldnn_conv2d_reordered_weights_size_fp32(conv_args[0],
+                                                                  conv_args[1],
+                                                                  conv_args[2],
+                                                                  conv_args[3],
+                                                                  conv_args[4],
+                                                                  conv_args[5],
+                                                                  conv_args[6],
+                                                                  conv_args[7],
+                                                                  conv_args[8],
+                                                                  conv_args[9],
+                                                                  conv_args[10],
+                                                                  conv_args[11],
+                                                                  conv_args[12],
+                                                                  conv_args[13]);
+    return std::vector<Expr>({Expr(size)});
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_conv2d_reorder_weights_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // batch_size
+      .AddInputType<int>()              // c_in
+      .AddInputType<int>()              // input_h
+      .AddInputType<int>()              // input_w
+      .AddInputType<int>()              // c_out
+      .AddInputType<int>()              // group
+      .AddInputType<int>()              // filter_h
+      .AddInputType<int>()              // filter_w
+      .AddInputType<int>()              // pad_h
+      .AddInputType<int>()              // pad_w
+      .AddInputType<int>()              // stride_h
+      .AddInputType<int>()              // stride_w
+      .AddInputType<int>()              // dilation_h
+      .AddInputType<int>()              // dilation_w
+      .AddInputType<cinn_buffer_t*>()   // weights
+      .AddOutputType<cinn_buffer_t*>()  // reordered_weights
+      .SetShapeInference(inference_shape_conv2d_reorder_weights)
+      .End();
+
   REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_softmax_fp32, host_target)
       .SetRetType<void>()
       .AddInputType<int>()              // batch_size
@@ -24,6 +24,50 @@ extern "C" {
 void cinn_cpu_mkldnn_softmax_fp32(
     int batch, int channel, int h, int w, int axis, cinn_buffer_t* inputs, cinn_buffer_t* out);
 
+/**
+ * \brief The number of floats to hold the weights of the convolution reordered by
+ * cinn_cpu_mkldnn_conv2d_reorder_weights_fp32, the blocked layout may pad the channels.
+ */
+int cinn_cpu_mkldnn_conv2d_reordered_weights_size_fp32(int batch_size,
+                                                        int c_in,
+                                                        int input_h,
+                                                        int input_w,
+                                                        int c_out,
+                                                        int group,
+                                                        int filter_h,
+                                                        int filter_w,
+                                                        int pad_h,
+                                                        int pad_w,
+                                                        int stride_h,
+                                                        int stride_w,
+                                                        int dilation_h,
+                                                        int dilation_w);
+
+/**
+ * \brief Reorder the weights of the convolution to the blocked layout preferred by its primitive. It is used to
+ * reorder the constant weights once before running, and the convolution then reads them with reordered_weights set.
+ * @param weights The weights in OIHW layout
+ * @param reordered_weights The reordered weights, of cinn_cpu_mkldnn_conv2d_reordered_weights_size_fp32 floats
+ */
+void cinn_cpu_mkldnn_conv2d_reorder_weights_fp32(int batch_size,
+                                                 int c_in,
+                                                 int input_h,
+                                                 int input_w,
+                                                 int c_out,
+                                                 int group,
+                                                 int filter_h,
+                                                 int filter_w,
+                                                 int pad_h,
+                                                 int pad_w,
+                                                 int stride_h,
+                                                 int stride_w,
+                                                 int dilation_h,
+                                                 int dilation_w,
+                                                 cinn_buffer_t* weights,
+                                                 cinn_buffer_t* reordered_weights);
+
+// The weights are in OIHW layout, or reordered by cinn_cpu_mkldnn_conv2d_reorder_weights_fp32 if reordered_weights is
+// set, otherwise they are reordered in each call.
 void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
                                       int c_in,
                                       int input_h,
@@ -38,8 +82,12 @@ void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
                                       int stride_w,
                                       int dilation_h,
                                       int dilation_w,
+                                      int reordered_weights,
                                       cinn_buffer_t* inputs,
                                       cinn_buffer_t* weights,
                                       cinn_buffer_t* out);
 
+// Drop the cached primitives.
+void cinn_cpu_mkldnn_clear_cache();
+
 }  // extern "C"
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/llvm/execution_engine.h"
@@ -23,6 +25,7 @@
 #include "cinn/common/target.h"
 #include "cinn/common/test_helper.h"
 #include "cinn/runtime/cpu/host_intrinsics.h"
+#include "cinn/runtime/cpu/mkldnn_math.h"
 #include "cinn/runtime/cpu/use_extern_funcs.h"
 
 namespace cinn {
@@ -75,6 +78,7 @@ TEST(cinn_cpu_mkldnn_conv2d_nchw_fp32, test) {
                                     Expr(stride_w),    // stride_w
                                     Expr(dilation_h),  // dilation_h
                                     Expr(dilation_w),  // dilation_w
+                                    Expr(0),           // reordered_weights
                                     input.tensor(),    // input
                                     weights.tensor()   // weights
                                 });
@@ -118,6 +122,84 @@ TEST(cinn_cpu_mkldnn_conv2d_nchw_fp32, test) {
   cinn_buffer_free(nullptr, C_buf);
 }
 
+TEST(cinn_cpu_mkldnn_conv2d_nchw_fp32, cached_primitive) {
+  int n(2), c_in(16), i_h(14), i_w(14), c_out(32), k_h(3), k_w(3);
+  int o_h     = i_h - k_h + 3;
+  int o_w     = i_w - k_w + 3;
+  auto *A_buf = common::BufferBuilder(Float(32), {n, c_in, i_h, i_w}).set_random().Build();
+  auto *B_buf = common::BufferBuilder(Float(32), {c_out, c_in, k_h, k_w}).set_random().Build();
+  auto *C_buf = common::BufferBuilder(Float(32), {n, c_out, o_h, o_w}).set_zero().Build();
+
+  int size =
+      cinn_cpu_mkldnn_conv2d_reordered_weights_size_fp32(n, c_in, i_h, i_w, c_out, 1, k_h, k_w, 2, 2, 1, 1, 1, 1);
+  ASSERT_GE(size, c_out * c_in * k_h * k_w);
+  auto *R_buf = common::BufferBuilder(Float(32), {size}).set_zero().Build();
+
+  auto reorder = [&] {
+    cinn_cpu_mkldnn_conv2d_reorder_weights_fp32(n, c_in, i_h, i_w, c_out, 1, k_h, k_w, 2, 2, 1, 1, 1, 1, B_buf, R_buf);
+  };
+  auto conv = [&](int reordered_weights) {
+    auto *W_buf = reordered_weights ? R_buf : B_buf;
+    cinn_cpu_mkldnn_conv2d_nchw_fp32(
+        n, c_in, i_h, i_w, c_out, 1, k_h, k_w, 2, 2, 1, 1, 1, 1, reordered_weights, A_buf, W_buf, C_buf);
+  };
+  auto *A = reinterpret_cast<float *>(A_buf->memory);
+  auto *B = reinterpret_cast<float *>(B_buf->memory);
+  auto *C = reinterpret_cast<float *>(C_buf->memory);
+
+  auto expect = [&](int b, int oc, int oh, int ow) {
+    float sum = 0.f;
+    for (int ic = 0; ic < c_in; ic++) {
+      for (int kh = 0; kh < k_h; kh++) {
+        for (int kw = 0; kw < k_w; kw++) {
+          int ih = oh + kh - 2;
+          int iw = ow + kw - 2;
+          if (ih < 0 || ih >= i_h || iw < 0 || iw >= i_w) continue;
+          sum += A[((b * c_in + ic) * i_h + ih) * i_w + iw] * B[((oc * c_in + ic) * k_h + kh) * k_w + kw];
+        }
+      }
+    }
+    return sum;
+  };
+  auto check = [&] {
+    for (int b = 0; b < n; b++) {
+      for (int oc = 0; oc < c_out; oc++) {
+        for (int oh = 0; oh < o_h; oh++) {
+          for (int ow = 0; ow < o_w; ow++) {
+            ASSERT_NEAR(C[((b * c_out + oc) * o_h + oh) * o_w + ow], expect(b, oc, oh, ow), 1e-3);
+          }
+        }
+      }
+    }
+  };
+
+  // the weights reordered once are read by the following runs, which reuse the cached primitive
+  reorder();
+  for (int i = 0; i < 2; i++) {
+    std::fill(C, C + n * c_out * o_h * o_w, 0.f);
+    conv(1);
+    check();
+  }
+
+  // the weights not reordered are reordered in each call, so the updates in place are seen
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < c_out * c_in * k_h * k_w; j++) B[j] -= 0.5f;
+    conv(0);
+    check();
+  }
+
+  // the reordered copy only changes when it is reordered again, the cached primitives don't hold any weights
+  reorder();
+  cinn_cpu_mkldnn_clear_cache();
+  conv(1);
+  check();
+
+  cinn_buffer_free(nullptr, A_buf);
+  cinn_buffer_free(nullptr, B_buf);
+  cinn_buffer_free(nullptr, C_buf);
+  cinn_buffer_free(nullptr, R_buf);
+}
+
 }  // namespace cpu
 }  // namespace runtime
 }  // namespace cinn
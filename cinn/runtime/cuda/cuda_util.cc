@@ -482,12 +482,14 @@ void cinn_gpu_cudnn_softmax(const std::vector<int> &attrs,
                             cinn_buffer_t *input,
                             cinn_buffer_t *output,
                             const cudaStream_t &stream) {
+  // attrs: input shape, axis, use_log
   std::vector<int> shape;
-  int rank = attrs.size() - 1;
+  int rank = attrs.size() - 2;
   for (int i = 0; i < rank; i++) {
     shape.push_back(attrs[i]);
   }
-  int axis      = attrs.back();
+  int axis      = attrs[rank];
+  bool use_log  = attrs[rank + 1];
   axis          = axis < 0 ? rank + axis : axis;
   int inner_num = 1;
   int outer_num = 1;
@@ -517,8 +519,15 @@ void cinn_gpu_cudnn_softmax(const std::vector<int> &attrs,
   float alpha = 1.f;
   float beta  = 0.f;
 
-  CUDNN_CALL(cudnnSoftmaxForward(
-      cudnn, CUDNN_SOFTMAX_ACCURATE, CUDNN_SOFTMAX_MODE_CHANNEL, &alpha, in_desc, in_data, &beta, out_desc, out_data));
+  CUDNN_CALL(cudnnSoftmaxForward(cudnn,
+                                 use_log ? CUDNN_SOFTMAX_LOG : CUDNN_SOFTMAX_ACCURATE,
+                                 CUDNN_SOFTMAX_MODE_CHANNEL,
+                                 &alpha,
+                                 in_desc,
+                                 in_data,
+                                 &beta,
+                                 out_desc,
+                                 out_data));
 
   cudnnDestroyTensorDescriptor(in_desc);
   cudnnDestroyTensorDescriptor(out_desc);
@@ -0,0 +1,133 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/perf_counters.h"
+
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace cinn {
+namespace utils {
+
+#ifdef __linux__
+
+namespace {
+
+int OpenCounter(uint64_t config, pid_t tid) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.size           = sizeof(attr);
+  attr.config         = config;
+  attr.disabled       = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  // the thread tid on any cpu
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+// the ids of the threads of this process
+std::vector<pid_t> GetThreadIds() {
+  std::vector<pid_t> tids;
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir) return tids;
+  while (auto* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') tids.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+  }
+  closedir(dir);
+  return tids;
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+#ifdef CINN_USE_OPENMP
+  // start the OpenMP workers before opening the counters on them, the parallel kernels run on the same workers
+#pragma omp parallel
+  {}
+#endif
+  const uint64_t configs[kNumCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+  for (auto tid : GetThreadIds()) {
+    std::vector<int> thread_fds;
+    for (int i = 0; i < kNumCounters; ++i) {
+      int fd = OpenCounter(configs[i], tid);
+      if (fd < 0) break;
+      thread_fds.push_back(fd);
+    }
+    if (thread_fds.size() == kNumCounters) {
+      fds_.insert(fds_.end(), thread_fds.begin(), thread_fds.end());
+      continue;
+    }
+    int error = errno;
+    for (int fd : thread_fds) close(fd);
+    // the thread exited after listed
+    if (error == ESRCH) continue;
+    LOG(WARNING) << "perf_event_open failed, the hardware counters are unavailable: " << std::strerror(error);
+    for (int fd : fds_) close(fd);
+    fds_.clear();
+    return;
+  }
+  VLOG(3) << "Open the hardware counters on " << fds_.size() / kNumCounters << " threads";
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_) close(fd);
+}
+
+void PerfCounters::Start() {
+  for (int fd : fds_) {
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+PerfCounters::Values PerfCounters::Stop() {
+  Values values;
+  uint64_t* fields[kNumCounters] = {&values.cycles, &values.instructions, &values.llc_misses};
+  for (int i = 0; i < fds_.size(); ++i) {
+    uint64_t value = 0;
+    ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fds_[i], &value, sizeof(uint64_t)) == sizeof(uint64_t)) {
+      *fields[i % kNumCounters] += value;
+    }
+  }
+  return values;
+}
+
+#else
+
+PerfCounters::PerfCounters() { LOG(WARNING) << "The hardware counters are only available on Linux"; }
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::Start() {}
+
+PerfCounters::Values PerfCounters::Stop() { return Values(); }
+
+#endif
+
+}  // namespace utils
+}  // namespace cinn
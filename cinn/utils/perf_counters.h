@@ -0,0 +1,60 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+/**
+ * The hardware counters of the process read by perf_event_open: cycles, instructions and last level cache misses.
+ * The counters are opened on every thread of the process when constructed, after the OpenMP workers running the
+ * parallel kernels are started, and the values of the threads are summed. The threads started later are not counted.
+ * The counters are unavailable on the systems other than Linux, or when perf events are not permitted (see
+ * /proc/sys/kernel/perf_event_paranoid), then Stop returns zeros.
+ */
+class PerfCounters {
+ public:
+  struct Values {
+    uint64_t cycles{0};
+    uint64_t instructions{0};
+    uint64_t llc_misses{0};
+
+    Values& operator+=(const Values& other) {
+      cycles += other.cycles;
+      instructions += other.instructions;
+      llc_misses += other.llc_misses;
+      return *this;
+    }
+  };
+
+  PerfCounters();
+  ~PerfCounters();
+
+  bool available() const { return !fds_.empty(); }
+
+  void Start();
+  Values Stop();
+
+ private:
+  static constexpr int kNumCounters = 3;
+  // kNumCounters file descriptors per counted thread
+  std::vector<int> fds_;
+};
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,101 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmark/benchmark_stats.h"
+
+#include <glog/logging.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace cinn {
+namespace tests {
+
+std::string BenchmarkSummary::ToJson() const {
+  std::stringstream ss;
+  ss << "{\"count\": " << count << ", \"total_ms\": " << total << ", \"mean_ms\": " << mean << ", \"min_ms\": " << min
+     << ", \"max_ms\": " << max << ", \"p50_ms\": " << p50 << ", \"p95_ms\": " << p95 << ", \"p99_ms\": " << p99
+     << ", \"cpu_utilization\": " << cpu_utilization << "}";
+  return ss.str();
+}
+
+void BenchmarkStats::StopRun() {
+  // Do not collect the runtime statistics if we are still in the warm up period.
+  if (cur_count_ <= num_warmup_runs_) return;
+
+  std::clock_t cur_stop_cpu = std::clock();
+  auto cur_stop_walltime    = std::chrono::steady_clock::now();
+
+  auto duration_walltime = cur_stop_walltime - cur_start_walltime_;
+  run_times_walltime_.push_back(duration_walltime);
+  total_duration_walltime_ += duration_walltime;
+
+  // std::clock counts the CPU time of all the threads, so the utilization is above 100% with the parallel kernels.
+  std::clock_t duration_cpu_raw = cur_stop_cpu - cur_start_cpu_;
+  total_duration_cpu_ += std::chrono::nanoseconds(static_cast<int64_t>(1e9 * duration_cpu_raw / CLOCKS_PER_SEC));
+}
+
+BenchmarkSummary BenchmarkStats::Summarize() const {
+  BenchmarkSummary summary;
+  if (run_times_walltime_.empty()) {
+    LOG(WARNING) << "No timed run of benchmark [" << name_ << "]";
+    return summary;
+  }
+  auto run_times = run_times_walltime_;
+  std::sort(run_times.begin(), run_times.end());
+
+  auto to_ms      = [](std::chrono::nanoseconds time) { return time.count() / 1e6; };
+  auto percentile = [&](double p) {
+    CHECK(p >= 0.0 && p <= 1.0);
+    size_t index = std::min(static_cast<size_t>(run_times.size() * p), run_times.size() - 1);
+    return to_ms(run_times[index]);
+  };
+
+  summary.count           = run_times.size();
+  summary.total           = to_ms(total_duration_walltime_);
+  summary.mean            = summary.total / summary.count;
+  summary.min             = to_ms(run_times.front());
+  summary.max             = to_ms(run_times.back());
+  summary.p50             = percentile(0.5);
+  summary.p95             = percentile(0.95);
+  summary.p99             = percentile(0.99);
+  summary.cpu_utilization = total_duration_cpu_.count() * 100.0 / total_duration_walltime_.count();
+  return summary;
+}
+
+int64_t PeakRssKB() {
+  // VmHWM follows the reset of ResetPeakRss, while ru_maxrss is the peak of the whole process.
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return std::stoll(line.substr(6));
+    }
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+void ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  if (clear_refs) {
+    clear_refs << "5";
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
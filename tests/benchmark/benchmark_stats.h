@@ -0,0 +1,104 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace tests {
+
+// The statistics of the timed runs, the times are in milliseconds.
+struct BenchmarkSummary {
+  int count{0};
+  double total{0.};
+  double mean{0.};
+  double min{0.};
+  double max{0.};
+  double p50{0.};
+  double p95{0.};
+  double p99{0.};
+  double cpu_utilization{0.};
+
+  // The fields as a JSON object.
+  std::string ToJson() const;
+};
+
+/**
+ * Collect the wall clock and CPU time of repeated runs, the same as the BenchmarkStats of the infrt test kernels.
+ * The first num_warmup_runs runs are not timed, and the runs stop after max_count timed runs or when the timed runs
+ * take more than benchmark_duration.
+ *
+ *   BenchmarkStats stats("resnet50", 10, 1000, std::chrono::seconds(10));
+ *   while (stats.MoreRun()) {
+ *     stats.StartRun();
+ *     program->Execute();
+ *     stats.StopRun();
+ *   }
+ *   auto summary = stats.Summarize();
+ */
+class BenchmarkStats {
+ public:
+  BenchmarkStats(const std::string& name,
+                 int num_warmup_runs,
+                 int max_count,
+                 std::chrono::microseconds benchmark_duration)
+      : name_(name),
+        num_warmup_runs_(num_warmup_runs),
+        max_count_(max_count),
+        benchmark_duration_(benchmark_duration) {}
+
+  void StartRun() {
+    ++cur_count_;
+    cur_start_walltime_ = std::chrono::steady_clock::now();
+    cur_start_cpu_      = std::clock();
+  }
+
+  void StopRun();
+
+  // Return if we should run more rounds.
+  bool MoreRun() const {
+    return cur_count_ < max_count_ + num_warmup_runs_ && total_duration_walltime_ < benchmark_duration_;
+  }
+
+  BenchmarkSummary Summarize() const;
+
+  const std::string& name() const { return name_; }
+
+ private:
+  const std::string name_;
+  const int num_warmup_runs_;
+  const int max_count_;
+  int cur_count_ = 0;
+  const std::chrono::nanoseconds benchmark_duration_;
+  std::chrono::nanoseconds total_duration_walltime_{};
+  std::chrono::nanoseconds total_duration_cpu_{};
+  std::chrono::time_point<std::chrono::steady_clock> cur_start_walltime_{};
+  std::clock_t cur_start_cpu_{};
+  std::vector<std::chrono::nanoseconds> run_times_walltime_;
+};
+
+// The peak resident set size of the process in KB since the last ResetPeakRss.
+int64_t PeakRssKB();
+
+// Reset the peak resident set size to the current one, so the peak of each model is measured separately. The peak is
+// kept on the kernels not supporting the reset, and PeakRssKB returns the peak of the whole process.
+void ResetPeakRss();
+
+}  // namespace tests
+}  // namespace cinn
@@ -0,0 +1,245 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmark/model_builders.h"
+
+#include <cmath>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+
+namespace cinn {
+namespace tests {
+
+using frontend::NetBuilder;
+using frontend::Variable;
+
+namespace {
+
+enum class Activation { kNone, kRelu, kRelu6 };
+
+// NetBuilder with the layers shared by the models, it records the random range of each input.
+class ModelBuilder {
+ public:
+  explicit ModelBuilder(const std::string& name) : builder_(name) {}
+
+  NetBuilder* operator->() { return &builder_; }
+
+  Variable Input(const std::vector<int>& shape, float low, float high, const common::Type& type = Float(32)) {
+    Variable var                 = builder_.CreateInput(type, shape);
+    model_.input_ranges[var->id] = {low, high};
+    return var;
+  }
+
+  // the parameters are in the range of [-1/sqrt(fan_in), 1/sqrt(fan_in)], so the activations keep their scale
+  Variable Param(const std::vector<int>& shape, int fan_in) {
+    float bound = 1.0f / std::sqrt(static_cast<float>(fan_in));
+    return Input(shape, -bound, bound);
+  }
+
+  Variable Activate(const Variable& x, Activation act) {
+    switch (act) {
+      case Activation::kRelu:
+        return builder_.relu(x);
+      case Activation::kRelu6:
+        return builder_.relu6(x);
+      default:
+        return x;
+    }
+  }
+
+  // convolution + batch norm + activation on NCHW, the convolution is depthwise if depthwise is true
+  Variable ConvBN(const Variable& x, int out_c, int kernel, int stride, Activation act, bool depthwise = false) {
+    int in_c    = x->shape[1];
+    int padding = kernel / 2;
+    Variable y;
+    if (depthwise) {
+      CHECK_EQ(in_c, out_c) << "The depthwise convolution keeps the channels";
+      auto w = Param({in_c, 1, kernel, kernel}, kernel * kernel);
+      y      = builder_.depthwise_conv2d(x, w, {stride, stride}, {padding, padding}, {1, 1}, in_c);
+    } else {
+      auto w = Param({out_c, in_c, kernel, kernel}, in_c * kernel * kernel);
+      y      = builder_.conv2d(x, w, {stride, stride}, {padding, padding});
+    }
+    auto scale    = Input({out_c}, 0.5f, 1.5f);
+    auto bias     = Input({out_c}, -0.1f, 0.1f);
+    auto mean     = Input({out_c}, -0.1f, 0.1f);
+    auto variance = Input({out_c}, 0.5f, 1.5f);
+    y             = builder_.batchnorm(y, scale, bias, mean, variance, 1e-5f, 0.9f, "NCHW", true)[0];
+    return Activate(y, act);
+  }
+
+  // fully connected layer on the 2-D input
+  Variable Linear(const Variable& x, int out_size) {
+    int in_size = x->shape[1];
+    auto w      = Param({out_size, in_size}, in_size);
+    auto b      = Param({out_size}, in_size);
+    return builder_.elementwise_add(builder_.mul(x, w), b, 1);
+  }
+
+  // global average pooling and the 1000-way classifier
+  Variable Classifier(const Variable& x) {
+    auto y = builder_.pool2d(x, "avg", {1, 1}, {1, 1}, {0, 0}, false, true, true);
+    y      = builder_.reshape(y, {x->shape[0], x->shape[1]});
+    return Linear(y, 1000);
+  }
+
+  BenchmarkModel Finish(const std::string& name, int batch_size, const Variable& output) {
+    model_.name       = name;
+    model_.batch_size = batch_size;
+    model_.program    = builder_.Build();
+    model_.output_id  = output->id;
+    return std::move(model_);
+  }
+
+ private:
+  NetBuilder builder_;
+  BenchmarkModel model_;
+};
+
+Variable BasicBlock(ModelBuilder* b, const Variable& x, int channels, int stride) {
+  auto y        = b->ConvBN(x, channels, 3, stride, Activation::kRelu);
+  y             = b->ConvBN(y, channels, 3, 1, Activation::kNone);
+  auto shortcut = x;
+  if (stride != 1 || x->shape[1] != channels) {
+    shortcut = b->ConvBN(x, channels, 1, stride, Activation::kNone);
+  }
+  return (*b)->relu((*b)->elementwise_add(y, shortcut));
+}
+
+Variable Bottleneck(ModelBuilder* b, const Variable& x, int channels, int stride) {
+  auto y        = b->ConvBN(x, channels, 1, 1, Activation::kRelu);
+  y             = b->ConvBN(y, channels, 3, stride, Activation::kRelu);
+  y             = b->ConvBN(y, channels * 4, 1, 1, Activation::kNone);
+  auto shortcut = x;
+  if (stride != 1 || x->shape[1] != channels * 4) {
+    shortcut = b->ConvBN(x, channels * 4, 1, stride, Activation::kNone);
+  }
+  return (*b)->relu((*b)->elementwise_add(y, shortcut));
+}
+
+}  // namespace
+
+BenchmarkModel BuildResNet(int depth, int batch_size) {
+  CHECK(depth == 18 || depth == 50) << "Only ResNet-18 and ResNet-50 are supported, but received depth " << depth;
+  std::vector<int> num_blocks = depth == 18 ? std::vector<int>{2, 2, 2, 2} : std::vector<int>{3, 4, 6, 3};
+  std::vector<int> channels   = {64, 128, 256, 512};
+
+  ModelBuilder b("resnet" + std::to_string(depth));
+  auto x = b.Input({batch_size, 3, 224, 224}, 0.0f, 1.0f);
+  auto y = b.ConvBN(x, 64, 7, 2, Activation::kRelu);
+  y      = b->pool2d(y, "max", {3, 3}, {2, 2}, {1, 1});
+  for (int stage = 0; stage < 4; ++stage) {
+    for (int i = 0; i < num_blocks[stage]; ++i) {
+      int stride = (stage > 0 && i == 0) ? 2 : 1;
+      y = depth == 18 ? BasicBlock(&b, y, channels[stage], stride) : Bottleneck(&b, y, channels[stage], stride);
+    }
+  }
+  return b.Finish("resnet" + std::to_string(depth), batch_size, b.Classifier(y));
+}
+
+BenchmarkModel BuildMobileNetV1(int batch_size) {
+  // the output channels and the stride of each depthwise separable convolution
+  std::vector<std::pair<int, int>> blocks = {{64, 1},
+                                             {128, 2},
+                                             {128, 1},
+                                             {256, 2},
+                                             {256, 1},
+                                             {512, 2},
+                                             {512, 1},
+                                             {512, 1},
+                                             {512, 1},
+                                             {512, 1},
+                                             {512, 1},
+                                             {1024, 2},
+                                             {1024, 1}};
+
+  ModelBuilder b("mobilenet_v1");
+  auto x = b.Input({batch_size, 3, 224, 224}, 0.0f, 1.0f);
+  auto y = b.ConvBN(x, 32, 3, 2, Activation::kRelu);
+  for (auto& block : blocks) {
+    y = b.ConvBN(y, y->shape[1], 3, block.second, Activation::kRelu, true);
+    y = b.ConvBN(y, block.first, 1, 1, Activation::kRelu);
+  }
+  return b.Finish("mobilenet_v1", batch_size, b.Classifier(y));
+}
+
+BenchmarkModel BuildMobileNetV2(int batch_size) {
+  // the expansion, output channels, number of blocks and stride of the first block of each stage
+  std::vector<std::vector<int>> stages = {
+      {1, 16, 1, 1}, {6, 24, 2, 2}, {6, 32, 3, 2}, {6, 64, 4, 2}, {6, 96, 3, 1}, {6, 160, 3, 2}, {6, 320, 1, 1}};
+
+  ModelBuilder b("mobilenet_v2");
+  auto x = b.Input({batch_size, 3, 224, 224}, 0.0f, 1.0f);
+  auto y = b.ConvBN(x, 32, 3, 2, Activation::kRelu6);
+  for (auto& stage : stages) {
+    for (int i = 0; i < stage[2]; ++i) {
+      int stride   = i == 0 ? stage[3] : 1;
+      int in_c     = y->shape[1];
+      int hidden_c = in_c * stage[0];
+      auto z       = y;
+      if (stage[0] != 1) {
+        z = b.ConvBN(z, hidden_c, 1, 1, Activation::kRelu6);
+      }
+      z = b.ConvBN(z, hidden_c, 3, stride, Activation::kRelu6, true);
+      z = b.ConvBN(z, stage[1], 1, 1, Activation::kNone);
+      y = (stride == 1 && in_c == stage[1]) ? b->elementwise_add(y, z) : z;
+    }
+  }
+  y = b.ConvBN(y, 1280, 1, 1, Activation::kRelu6);
+  return b.Finish("mobilenet_v2", batch_size, b.Classifier(y));
+}
+
+BenchmarkModel BuildBert(int batch_size, int seq_len, int num_layers, int hidden_size, int num_heads, int vocab) {
+  CHECK_EQ(hidden_size % num_heads, 0) << "The hidden size should be divisible by the number of heads";
+  int head_size = hidden_size / num_heads;
+  int tokens    = batch_size * seq_len;
+
+  ModelBuilder b("bert");
+  auto layer_norm = [&](const Variable& x) {
+    auto scale = b.Input({hidden_size}, 0.5f, 1.5f);
+    auto bias  = b.Input({hidden_size}, -0.1f, 0.1f);
+    return b->layer_norm(x, scale, bias, 1)[0];
+  };
+  // [tokens, hidden_size] -> [batch_size * num_heads, seq_len, head_size]
+  auto split_heads = [&](const Variable& x) {
+    auto y = b->reshape(x, {batch_size, seq_len, num_heads, head_size});
+    y      = b->transpose(y, {0, 2, 1, 3});
+    return b->reshape(y, {batch_size * num_heads, seq_len, head_size});
+  };
+
+  auto ids      = b.Input({tokens}, 0, vocab - 1, Int(32));
+  auto table    = b.Input({vocab, hidden_size}, -0.1f, 0.1f);
+  auto position = b.Input({seq_len, hidden_size}, -0.1f, 0.1f);
+  auto x        = b->reshape(b->lookup_table(table, ids), {batch_size, seq_len, hidden_size});
+  x             = layer_norm(b->reshape(b->elementwise_add(x, position, 1), {tokens, hidden_size}));
+
+  for (int layer = 0; layer < num_layers; ++layer) {
+    auto q      = split_heads(b.Linear(x, hidden_size));
+    auto k      = split_heads(b.Linear(x, hidden_size));
+    auto v      = split_heads(b.Linear(x, hidden_size));
+    auto scores = b->matmul(q, k, false, true, 1.0f / std::sqrt(static_cast<float>(head_size)));
+    auto ctx    = b->matmul(b->softmax(scores, -1), v);
+    ctx         = b->reshape(ctx, {batch_size, num_heads, seq_len, head_size});
+    ctx         = b->reshape(b->transpose(ctx, {0, 2, 1, 3}), {tokens, hidden_size});
+    x           = layer_norm(b->elementwise_add(x, b.Linear(ctx, hidden_size)));
+
+    auto ffn = b.Linear(b->gelu(b.Linear(x, hidden_size * 4)), hidden_size);
+    x        = layer_norm(b->elementwise_add(x, ffn));
+  }
+  return b.Finish("bert", batch_size, x);
+}
+
+}  // namespace tests
+}  // namespace cinn
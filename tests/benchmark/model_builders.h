@@ -0,0 +1,51 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cinn/frontend/syntax.h"
+
+namespace cinn {
+namespace tests {
+
+// A model built by NetBuilder for the end-to-end benchmark. The parameters are the inputs of the program, they are
+// filled with random values before the runs, so the benchmark needs no model files.
+struct BenchmarkModel {
+  std::string name;
+  int batch_size{1};
+  frontend::Program program;
+  std::string output_id;
+  // the range of the uniform random values of each input, the int32 inputs are filled with the integers in the range
+  std::unordered_map<std::string, std::pair<float, float>> input_ranges;
+};
+
+// ResNet-18 (depth = 18) or ResNet-50 (depth = 50) on the 224x224 images.
+BenchmarkModel BuildResNet(int depth, int batch_size);
+
+// MobileNetV1 on the 224x224 images.
+BenchmarkModel BuildMobileNetV1(int batch_size);
+
+// MobileNetV2 on the 224x224 images.
+BenchmarkModel BuildMobileNetV2(int batch_size);
+
+// A BERT encoder with the word and position embeddings, the output is the hidden state of the last layer.
+BenchmarkModel BuildBert(
+    int batch_size, int seq_len = 128, int num_layers = 4, int hidden_size = 256, int num_heads = 4, int vocab = 8192);
+
+}  // namespace tests
+}  // namespace cinn
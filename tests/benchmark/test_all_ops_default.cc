@@ -212,6 +212,16 @@ absl::flat_hash_map<std::string, AttrType> attr_store_depthwise_conv2d = {{"padd
                                                                           {"dilation", dilation_depthwise_conv2d}};
 TEST_DEFAULT1(depthwise_conv2d, depthwise_conv2d_nchw, type1, type7, attr_store_depthwise_conv2d)
 
+// mobilenetv1 index 3
+std::vector<std::vector<int>> shapes_depthwise_conv2d_nchw1 = {{1, 64, 112, 112}, {64, 1, 3, 3}};
+std::vector<int> stride_depthwise_conv2d1({2, 2});
+std::vector<int> padding_depthwise_conv2d1({1, 1});
+std::vector<int> dilation_depthwise_conv2d1({1, 1});
+absl::flat_hash_map<std::string, AttrType> attr_store_depthwise_conv2d1 = {{"padding", padding_depthwise_conv2d1},
+                                                                           {"stride", stride_depthwise_conv2d1},
+                                                                           {"dilation", dilation_depthwise_conv2d1}};
+TEST_DEFAULT1(depthwise_conv2d, depthwise_conv2d_nchw1, type1, type7, attr_store_depthwise_conv2d1)
+
 // layout_transform
 std::vector<std::vector<int>> shapes_layout_transform                  = {{512, 512, 3, 3}};
 std::string src_layout                                                 = "OIHW";
@@ -0,0 +1,74 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "cinn/frontend/paddle_model_convertor.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/runtime/use_extern_funcs.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
+
+DEFINE_string(model_dirs, "", "The comma separated directories of the models to convert.");
+DEFINE_int32(repeat, 10, "The number of times each model is converted.");
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::Scope;
+
+// Returns the average milliseconds to convert the model, the scope of the last conversion is kept.
+float BenchmarkConvertor(const std::string& model_dir, int num_load_threads, std::shared_ptr<Scope>* scope) {
+  utils::Timer timer;
+  float total = 0.f;
+  for (int i = 0; i < FLAGS_repeat; i++) {
+    *scope = Scope::Create();
+    frontend::PaddleModelConvertor convertor(scope->get(), common::DefaultHostTarget(), num_load_threads);
+    timer.Start();
+    auto program = convertor(model_dir);
+    total += timer.Stop();
+    CHECK_GT(program.size(), 0);
+  }
+  return total / FLAGS_repeat;
+}
+
+TEST(PaddleModelConvertor, benchmark) {
+  for (auto& model_dir : utils::Split(FLAGS_model_dirs, ",")) {
+    std::shared_ptr<Scope> serial_scope;
+    std::shared_ptr<Scope> parallel_scope;
+    float serial_time   = BenchmarkConvertor(model_dir, 1, &serial_scope);
+    float parallel_time = BenchmarkConvertor(model_dir, 0, &parallel_scope);
+    LOG(INFO) << "Convert " << model_dir << ": " << serial_time << " ms with 1 load thread, " << parallel_time
+              << " ms with the default load threads";
+
+    // the parameters deserialized by many threads are the same
+    for (auto& name : serial_scope->var_names()) {
+      auto expect = serial_scope->GetTensor(std::string(name));
+      auto tensor = parallel_scope->GetTensor(std::string(name));
+      ASSERT_EQ(expect->shape().data(), tensor->shape().data()) << name;
+      ASSERT_EQ(expect->type(), tensor->type()) << name;
+      size_t size = expect->shape().numel() * expect->type().bits() / 8;
+      ASSERT_EQ(std::memcmp(expect->buffer()->memory, tensor->buffer()->memory, size), 0) << name;
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
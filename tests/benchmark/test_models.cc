@@ -0,0 +1,138 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/runtime/use_extern_funcs.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
+#include "tests/benchmark/benchmark_stats.h"
+#include "tests/benchmark/model_builders.h"
+
+DEFINE_string(models, "resnet18,resnet50,mobilenet_v1,mobilenet_v2,bert", "The comma separated models to benchmark.");
+DEFINE_int32(batch_size, 1, "The batch size of the models.");
+DEFINE_string(num_threads, "1", "The comma separated numbers of threads the models are run with.");
+DEFINE_int32(warmup, 10, "The number of the runs before the timed runs.");
+DEFINE_int32(max_count, 100, "The max number of the timed runs.");
+DEFINE_int32(max_seconds, 60, "The max seconds of the timed runs of each model with each number of threads.");
+DEFINE_string(output, "", "The JSON file the results are written to, the results are only logged if it is empty.");
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::Scope;
+
+BenchmarkModel BuildModel(const std::string& name) {
+  if (name == "resnet18") return BuildResNet(18, FLAGS_batch_size);
+  if (name == "resnet50") return BuildResNet(50, FLAGS_batch_size);
+  if (name == "mobilenet_v1") return BuildMobileNetV1(FLAGS_batch_size);
+  if (name == "mobilenet_v2") return BuildMobileNetV2(FLAGS_batch_size);
+  if (name == "bert") return BuildBert(FLAGS_batch_size);
+  LOG(FATAL) << "Unknown benchmark model [" << name << "]";
+  return BenchmarkModel();
+}
+
+void FillInputs(const BenchmarkModel& model, Scope* scope, const Target& target) {
+  std::mt19937 engine(2021);
+  for (auto& input : model.input_ranges) {
+    auto tensor = scope->GetTensor(input.first);
+    int numel   = tensor->shape().numel();
+    if (tensor->type().is_int(32)) {
+      std::uniform_int_distribution<int> dist(input.second.first, input.second.second);
+      auto* data = tensor->mutable_data<int>(target);
+      for (int i = 0; i < numel; ++i) data[i] = dist(engine);
+    } else {
+      std::uniform_real_distribution<float> dist(input.second.first, input.second.second);
+      auto* data = tensor->mutable_data<float>(target);
+      for (int i = 0; i < numel; ++i) data[i] = dist(engine);
+    }
+  }
+}
+
+// Benchmark the model and return its results as a JSON object.
+std::string BenchmarkModelRuns(const BenchmarkModel& model) {
+  Target target = common::DefaultHostTarget();
+  ResetPeakRss();
+
+  utils::Timer timer;
+  timer.Start();
+  auto graph = std::make_shared<hlir::framework::Graph>(model.program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  float compile_time   = timer.Stop();
+
+  FillInputs(model, scope.get(), target);
+  timer.Start();
+  runtime_program->Execute();
+  float first_run_time = timer.Stop();
+  LOG(INFO) << model.name << ": compile " << compile_time << " ms, first run " << first_run_time << " ms";
+
+  std::stringstream ss;
+  ss << "{\"model\": \"" << model.name << "\", \"batch_size\": " << model.batch_size
+     << ", \"num_instructions\": " << model.program.size() << ", \"compile_ms\": " << compile_time
+     << ", \"first_run_ms\": " << first_run_time << ", \"runs\": [";
+  auto num_threads = utils::Split(FLAGS_num_threads, ",");
+  for (size_t i = 0; i < num_threads.size(); ++i) {
+    // the parallel kernels read the number of threads at each launch
+    setenv("CINN_NUM_THREADS", num_threads[i].c_str(), 1);
+    BenchmarkStats stats(model.name, FLAGS_warmup, FLAGS_max_count, std::chrono::seconds(FLAGS_max_seconds));
+    while (stats.MoreRun()) {
+      stats.StartRun();
+      runtime_program->Execute();
+      stats.StopRun();
+    }
+    auto summary    = stats.Summarize();
+    auto throughput = summary.mean > 0 ? model.batch_size * 1000. / summary.mean : 0.;
+    LOG(INFO) << model.name << " with " << num_threads[i] << " threads: p50 " << summary.p50 << " ms, p95 "
+              << summary.p95 << " ms, p99 " << summary.p99 << " ms, " << throughput << " samples/s";
+    ss << (i > 0 ? ", " : "") << "{\"num_threads\": " << num_threads[i] << ", \"throughput\": " << throughput
+       << ", \"latency\": " << summary.ToJson() << "}";
+  }
+  unsetenv("CINN_NUM_THREADS");
+  ss << "], \"peak_rss_kb\": " << PeakRssKB() << "}";
+  return ss.str();
+}
+
+TEST(Models, benchmark) {
+  std::vector<std::string> results;
+  for (auto& name : utils::Split(FLAGS_models, ",")) {
+    results.emplace_back(BenchmarkModelRuns(BuildModel(name)));
+    LOG(INFO) << results.back();
+  }
+  if (!FLAGS_output.empty()) {
+    std::ofstream output(FLAGS_output);
+    CHECK(output.is_open()) << "Failed to open the benchmark output " << FLAGS_output;
+    output << "{\"models\": [" << utils::Join(results, ", ") << "]}\n";
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
@@ -0,0 +1,300 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <absl/container/flat_hash_map.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/pe/transform.h"
+#include "cinn/runtime/cpu/use_extern_funcs.h"
+#include "cinn/utils/string.h"
+#include "tests/benchmark/test_utils.h"
+
+DEFINE_string(cases_file,
+              "",
+              "The file of the cases to sweep, one case per line: the op name, the input shapes and the attributes, "
+              "such as `conv2d 1,64,56,56 64,64,3,3 padding=1,1 stride=1,1`. The common cases are swept if empty.");
+DEFINE_string(baseline, "", "The results of a previous sweep saved by --save_baseline to compare with.");
+DEFINE_string(save_baseline, "", "The file the results are saved to, as the baseline of the later sweeps.");
+DEFINE_double(regression_threshold, 0.1, "The relative slowdown from the baseline reported as a regression.");
+DEFINE_bool(fail_on_regression, false, "Whether the test fails on the regressions.");
+DEFINE_int32(repeat, 10, "The number of the timed runs of each kernel.");
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::AttrType;
+
+// the shapes of the ops in ResNet, MobileNet and BERT
+constexpr char kCommonCases[] = R"ROC(
+elementwise_add 1024,1024 1024,1024
+elementwise_add 64,56,56 64,56,56
+relu 1,512,7,7
+relu 1024,14,14
+softmax 128,1024
+matmul 128,128 128,128
+matmul 512,512 512,512
+matmul 1024,1024 1024,1024
+matmul 12,128,64 12,64,128
+mul 128,768 3072,768
+conv2d 1,3,224,224 64,3,7,7 padding=3,3 stride=2,2 dilation=1,1
+conv2d 1,64,56,56 64,64,3,3 padding=1,1 stride=1,1 dilation=1,1
+conv2d 1,64,56,56 256,64,1,1 padding=0,0 stride=1,1 dilation=1,1
+conv2d 1,256,14,14 256,256,3,3 padding=1,1 stride=1,1 dilation=1,1
+depthwise_conv2d 1,32,112,112 32,1,3,3 padding=1,1 stride=1,1 dilation=1,1
+)ROC";
+
+// the channel block of the NCHWc layout
+constexpr int kChannelBlock = 16;
+
+// matmul with the native schedule instead of the MKL call
+class NativeMatmulTester : public OpBenchmarkTester {
+ public:
+  using OpBenchmarkTester::OpBenchmarkTester;
+
+  std::vector<ir::Tensor> CreateSpecificStrategy(const std::vector<ir::Tensor>& inputs,
+                                                 poly::StageMap* stages) override {
+    CHECK_EQ(inputs.size(), 2U) << "matmul's input tensor should be 2.\n";
+    std::vector<ir::Tensor> outs = hlir::pe::Matmul(inputs[0], inputs[1]);
+    for (auto& out : outs) {
+      (*stages)->InsertLazily(out);
+    }
+    return outs;
+  }
+};
+
+struct SweepCase {
+  std::string op_name;
+  std::vector<std::vector<int>> input_shapes;
+  absl::flat_hash_map<std::string, AttrType> attrs;
+  // the case as written in the cases file
+  std::string text;
+};
+
+struct SweepResult {
+  std::string key;
+  double ms{0.};
+  double gflops{0.};
+  double gbps{0.};
+};
+
+std::vector<int> ParseInts(const std::string& str) {
+  std::vector<int> values;
+  for (auto& value : utils::Split(str, ",")) {
+    values.push_back(std::stoi(value));
+  }
+  return values;
+}
+
+AttrType ParseAttr(const std::string& value) {
+  if (value == "true" || value == "false") return value == "true";
+  if (value.find(',') != std::string::npos) return ParseInts(value);
+  if (value.find('.') != std::string::npos) return std::stof(value);
+  return std::stoi(value);
+}
+
+std::vector<SweepCase> ParseCases(std::istream& is) {
+  std::vector<SweepCase> cases;
+  std::string line;
+  while (std::getline(is, line)) {
+    std::stringstream ss(line);
+    std::string token;
+    SweepCase sweep_case;
+    while (ss >> token) {
+      if (token[0] == '#') break;
+      if (sweep_case.op_name.empty()) {
+        sweep_case.op_name = token;
+      } else if (token.find('=') != std::string::npos) {
+        auto pos                               = token.find('=');
+        sweep_case.attrs[token.substr(0, pos)] = ParseAttr(token.substr(pos + 1));
+      } else {
+        sweep_case.input_shapes.push_back(ParseInts(token));
+      }
+      sweep_case.text += (sweep_case.text.empty() ? "" : " ") + token;
+    }
+    if (!sweep_case.op_name.empty()) {
+      cases.push_back(sweep_case);
+    }
+  }
+  return cases;
+}
+
+template <typename T>
+T GetAttr(const SweepCase& sweep_case, const std::string& name, const T& default_value) {
+  auto it = sweep_case.attrs.find(name);
+  return it == sweep_case.attrs.end() ? default_value : absl::get<T>(it->second);
+}
+
+// The strategies of the op: the default one, the native schedule of matmul besides the MKL one, the NCHWc layout and
+// the MKLDNN kernel of conv2d.
+std::vector<std::string> GetStrategies(const SweepCase& sweep_case) {
+  std::vector<std::string> strategies = {"default"};
+  auto& shapes                        = sweep_case.input_shapes;
+  if (sweep_case.op_name == "matmul" && shapes[0].size() == 2U && shapes[1].size() == 2U &&
+      !GetAttr(sweep_case, "trans_a", false) && !GetAttr(sweep_case, "trans_b", false)) {
+    strategies.push_back("native");
+  }
+  if (sweep_case.op_name == "conv2d" && GetAttr(sweep_case, "groups", 1) == 1) {
+    if (shapes[0][1] % kChannelBlock == 0 && shapes[1][0] % kChannelBlock == 0) {
+      strategies.push_back("nchwc");
+    }
+#ifdef CINN_WITH_MKLDNN
+    strategies.push_back("mkldnn");
+#endif
+  }
+  return strategies;
+}
+
+// The floating point operations of the ops calling the external libraries, whose static costs miss the operations
+// inside the libraries. Returns 0 for the other ops.
+double AnalyticFlops(const SweepCase& sweep_case) {
+  auto& shapes = sweep_case.input_shapes;
+  auto numel   = [](const std::vector<int>& shape) {
+    return std::accumulate(shape.begin(), shape.end(), 1., std::multiplies<double>());
+  };
+  if (sweep_case.op_name == "matmul" && !GetAttr(sweep_case, "trans_b", false)) {
+    return 2. * numel(shapes[0]) * shapes[1].back();
+  }
+  if (sweep_case.op_name == "mul") {
+    return 2. * numel(shapes[0]) * shapes[1][0];
+  }
+  if (sweep_case.op_name == "conv2d") {
+    auto padding  = GetAttr(sweep_case, "padding", std::vector<int>{0, 0});
+    auto stride   = GetAttr(sweep_case, "stride", std::vector<int>{1, 1});
+    auto dilation = GetAttr(sweep_case, "dilation", std::vector<int>{1, 1});
+    double out_h  = (shapes[0][2] + 2 * padding[0] - dilation[0] * (shapes[1][2] - 1) - 1) / stride[0] + 1;
+    double out_w  = (shapes[0][3] + 2 * padding[1] - dilation[1] * (shapes[1][3] - 1) - 1) / stride[1] + 1;
+    return 2. * shapes[0][0] * numel(shapes[1]) * out_h * out_w;
+  }
+  return 0.;
+}
+
+SweepResult RunCase(const SweepCase& sweep_case, const std::string& strategy) {
+  LOG(INFO) << "Sweeping " << sweep_case.text << " with the " << strategy << " strategy";
+  hlir::framework::NodeAttr attrs;
+  attrs.attr_store = sweep_case.attrs;
+  ir::KernelCost cost;
+  double ms = 0.;
+  if (strategy == "native") {
+    NativeMatmulTester tester("matmul", sweep_case.input_shapes, common::DefaultHostTarget(), FLAGS_repeat);
+    ms = tester.BenchmarkOp(tester.CreateInputTensors<float>(), attrs, false, &cost);
+  } else {
+    std::string op_name = sweep_case.op_name;
+    auto input_shapes   = sweep_case.input_shapes;
+    if (strategy == "mkldnn") {
+      attrs.attr_store["use_mkldnn"] = true;
+    } else if (strategy == "nchwc") {
+      // NCHW -> NCHWc and OIHW -> OIHWio
+      auto& x         = input_shapes[0];
+      auto& w         = input_shapes[1];
+      op_name         = "conv2d_NCHWc";
+      input_shapes[0] = {x[0], x[1] / kChannelBlock, x[2], x[3], kChannelBlock};
+      input_shapes[1] = {w[0] / kChannelBlock, w[1] / kChannelBlock, w[2], w[3], kChannelBlock, kChannelBlock};
+    }
+    OpBenchmarkTester tester(op_name, input_shapes, common::DefaultHostTarget(), FLAGS_repeat);
+    ms = tester.BenchmarkOp(tester.CreateInputTensors<float>(), attrs, true, &cost);
+  }
+
+  double flops = AnalyticFlops(sweep_case);
+  if (flops == 0.) flops = cost.flops;
+  SweepResult result;
+  result.key    = sweep_case.op_name + "[" + strategy + "]" + sweep_case.text.substr(sweep_case.op_name.size());
+  result.ms     = ms;
+  result.gflops = ms > 0. ? flops / ms / 1e6 : 0.;
+  result.gbps   = ms > 0. ? cost.bytes / ms / 1e6 : 0.;
+  return result;
+}
+
+// the baseline file has a result per line: the milliseconds, a tab and the key
+std::unordered_map<std::string, double> LoadBaseline(const std::string& path) {
+  std::unordered_map<std::string, double> baseline;
+  std::ifstream is(path);
+  CHECK(is.is_open()) << "Failed to open the baseline " << path;
+  std::string line;
+  while (std::getline(is, line)) {
+    auto pos = line.find('\t');
+    if (pos == std::string::npos) continue;
+    baseline[line.substr(pos + 1)] = std::stod(line.substr(0, pos));
+  }
+  return baseline;
+}
+
+TEST(OpSweep, benchmark) {
+  std::vector<SweepCase> cases;
+  if (FLAGS_cases_file.empty()) {
+    std::stringstream ss(kCommonCases);
+    cases = ParseCases(ss);
+  } else {
+    std::ifstream is(FLAGS_cases_file);
+    CHECK(is.is_open()) << "Failed to open the cases file " << FLAGS_cases_file;
+    cases = ParseCases(is);
+  }
+
+  std::vector<SweepResult> results;
+  for (auto& sweep_case : cases) {
+    for (auto& strategy : GetStrategies(sweep_case)) {
+      results.push_back(RunCase(sweep_case, strategy));
+    }
+  }
+
+  std::unordered_map<std::string, double> baseline;
+  if (!FLAGS_baseline.empty()) {
+    baseline = LoadBaseline(FLAGS_baseline);
+  }
+  std::stringstream report;
+  report << std::fixed;
+  int num_regressions = 0;
+  for (auto& result : results) {
+    report << result.key << ": " << result.ms << " ms, " << result.gflops << " GFLOP/s, " << result.gbps << " GB/s";
+    auto it = baseline.find(result.key);
+    if (it != baseline.end() && it->second > 0.) {
+      double change = result.ms / it->second - 1.;
+      report << ", " << (change >= 0. ? "+" : "") << change * 100. << "% from the baseline";
+      if (change > FLAGS_regression_threshold) {
+        report << " [REGRESSION]";
+        num_regressions++;
+      }
+    }
+    report << "\n";
+  }
+  LOG(INFO) << "The results of the sweep:\n" << report.str();
+
+  if (!FLAGS_save_baseline.empty()) {
+    std::ofstream os(FLAGS_save_baseline);
+    CHECK(os.is_open()) << "Failed to open " << FLAGS_save_baseline;
+    for (auto& result : results) {
+      os << result.ms << "\t" << result.key << "\n";
+    }
+  }
+  if (num_regressions > 0) {
+    LOG(WARNING) << num_regressions << " cases regress more than " << FLAGS_regression_threshold * 100.
+                 << "% from the baseline " << FLAGS_baseline;
+  }
+  if (FLAGS_fail_on_regression) {
+    ASSERT_EQ(num_regressions, 0);
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn
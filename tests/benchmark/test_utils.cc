@@ -57,6 +57,31 @@ void OpBenchmarkTester::TestOp(const std::string& test_name,
   LOG(INFO) << "repeat times: " << repeat_ << ", kernel run time: " << test_op_time << " ms";
 }
 
+double OpBenchmarkTester::BenchmarkOp(const std::vector<Tensor>& input_tensors,
+                                      const hlir::framework::NodeAttr& attrs,
+                                      bool use_default_stragegy,
+                                      ir::KernelCost* cost) {
+  auto module = CreateCinnModule(input_tensors, attrs, {Float(32)}, use_default_stragegy);
+  if (cost != nullptr) {
+    *cost = ir::EstimateKernelCost(module.functions().front());
+  }
+  auto engine        = CreateExecutionEngine(module);
+  auto test_func_ptr = reinterpret_cast<void (*)(void**, int32_t)>(engine->Lookup(op_name_));
+  CHECK(test_func_ptr) << "The kernel of " << op_name_ << " is not found";
+  input_types_ = std::vector<Type>(input_shapes_.size(), Float(32));
+  out_types_   = std::vector<Type>(output_shapes_.size(), Float(32));
+  CreateBuffer();
+
+  // ignore first execution for lazy jit component
+  test_func_ptr(reinterpret_cast<void**>(all_args_.data()), all_args_.size());
+  cinn::utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat_; i++) {
+    test_func_ptr(reinterpret_cast<void**>(all_args_.data()), all_args_.size());
+  }
+  return timer.Stop() / repeat_;
+}
+
 Module OpBenchmarkTester::CreateCinnModule(const std::vector<Tensor>& input_tensors,
                                            const hlir::framework::NodeAttr& attrs,
                                            const std::vector<Type>& out_types,
@@ -22,6 +22,7 @@
 #include "cinn/cinn.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/op/use_ops.h"
+#include "cinn/ir/kernel_cost.h"
 #include "cinn/runtime/cinn_runtime.h"
 
 namespace cinn {
@@ -45,6 +46,16 @@ class OpBenchmarkTester {
               const std::vector<Type> &out_types,
               bool use_default_stragegy = true);
 
+  /**
+   * Compile the op and return the average milliseconds of the kernel runs after a warmup run. The inputs and outputs
+   * are float32, the number of the outputs follows the strategy. The static cost of the kernel is set to \p cost if
+   * it is not nullptr.
+   */
+  double BenchmarkOp(const std::vector<ir::Tensor> &input_tensors,
+                     const hlir::framework::NodeAttr &attrs,
+                     bool use_default_stragegy = true,
+                     ir::KernelCost *cost      = nullptr);
+
   virtual Module CreateCinnModule(const std::vector<ir::Tensor> &input_tensors,
                                   const hlir::framework::NodeAttr &attrs,
                                   const std::vector<Type> &out_types,